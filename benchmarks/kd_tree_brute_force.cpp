@@ -0,0 +1,99 @@
+
+// Compares KdTree::queryNearest against a brute force search, with 1M random points
+// in a 100x100x10 slab on one thread, and checks the results against each other.
+//
+// g++ -std=c++11 -O2 -pthread -I.. kd_tree_brute_force.cpp
+
+#include <chrono>
+#include <random>
+#include <cstdio>
+
+#include "../linalgaux.hpp"
+
+
+static double millisecondsSince(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void bruteForceNearest(const std::vector<vec3> &points, const vec3 &point, const size_t k, float *distancesSquared)
+{
+	for (size_t i = 0; i < k; i++)
+		distancesSquared[i] = HUGE_VALF;
+
+	for (const vec3 &p : points)
+	{
+		const float distanceSquared = (p - point).lengthSquared();
+
+		if (distanceSquared >= distancesSquared[k - 1])
+			continue;
+
+		size_t j = k - 1;
+
+		for (; (j > 0) && (distancesSquared[j - 1] > distanceSquared); j--)
+			distancesSquared[j] = distancesSquared[j - 1];
+
+		distancesSquared[j] = distanceSquared;
+	}
+}
+
+
+int main()
+{
+	const size_t pointCount = 1000000, queryCount = 100000, bruteForceCount = 200, k = 8;
+
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> xy(0.0f, 100.0f), z(0.0f, 10.0f);
+
+	std::vector<vec3> points(pointCount), queries(queryCount);
+
+	for (vec3 &p : points)
+		p = vec3(xy(random), xy(random), z(random));
+
+	for (vec3 &p : queries)
+		p = vec3(xy(random), xy(random), z(random));
+
+	KdTree tree;
+
+	auto start = std::chrono::steady_clock::now();
+	tree.build(points.data(), points.size(), 1);
+	printf("build                 %.0f ms\n", millisecondsSince(start));
+
+	std::vector<unsigned int> indices(queryCount * k);
+	std::vector<float> distancesSquared(queryCount * k);
+
+	const float epsilons[] = { 0.0f, 0.5f };
+
+	for (const float epsilon : epsilons)
+	{
+		start = std::chrono::steady_clock::now();
+		tree.queryNearest(queries.data(), queryCount, k, indices.data(), distancesSquared.data(), epsilon, HUGE_VALF, 1);
+		printf("epsilon %.1f %d-NN       %.2f us/query\n", epsilon, static_cast<int>(k), millisecondsSince(start) * 1000.0 / queryCount);
+	}
+
+	start = std::chrono::steady_clock::now();
+	tree.queryNearest(queries.data(), queryCount, 1, indices.data(), distancesSquared.data(), 0.0f, HUGE_VALF, 1);
+	printf("exact 1-NN            %.2f us/query\n", millisecondsSince(start) * 1000.0 / queryCount);
+
+	// The exact search again, to check against brute force
+	tree.queryNearest(queries.data(), bruteForceCount, k, indices.data(), distancesSquared.data(), 0.0f, HUGE_VALF, 1);
+
+	std::vector<float> expected(bruteForceCount * k);
+
+	start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < bruteForceCount; i++)
+		bruteForceNearest(points, queries[i], k, expected.data() + i * k);
+
+	printf("brute force %d-NN      %.2f ms/query\n", static_cast<int>(k), millisecondsSince(start) / bruteForceCount);
+
+	size_t mismatches = 0;
+
+	for (size_t i = 0; i < bruteForceCount * k; i++)
+		if (distancesSquared[i] != expected[i])
+			mismatches++;
+
+	printf("mismatches            %d\n", static_cast<int>(mismatches));
+
+	return (mismatches == 0) ? 0 : 1;
+}
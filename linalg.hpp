@@ -55,6 +55,29 @@
 
 
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+
+// SSE2 is used for the batch functions (the ones taking arrays and a count),
+// define LINALG_NO_SIMD prior to including linalg to force the scalar fallback.
+#if !defined(LINALG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#	define LINALG_SIMD_SSE2 1
+#endif
+
+#ifdef LINALG_SIMD_SSE2
+#	include <emmintrin.h>
+#endif
+
+// F16C is used for half float conversions when the compiler targets it, e.g. with -mf16c
+// or /arch:AVX2, otherwise they fall back to lookup tables.
+#if !defined(LINALG_NO_SIMD) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#	define LINALG_F16C 1
+#endif
+
+#ifdef LINALG_F16C
+#	include <immintrin.h>
+#endif
 
 
 #ifdef _IOSTREAM_
@@ -90,6 +113,200 @@
 #endif
 
 
+#pragma region SIMD
+
+// 4 packed floats used internally by the batch functions. When SSE2 isn't
+// available, then it falls back to plain floats, such that every batch
+// function only has to be written once.
+//
+// This is declared before structure padding is disabled, as __m128 must
+// keep its 16 byte alignment.
+struct _linalg_float4
+{
+#ifdef LINALG_SIMD_SSE2
+
+	__m128 v;
+
+	_linalg_float4() {}
+	_linalg_float4(const __m128 &v) : v(v) {}
+	explicit _linalg_float4(const float xyzw) : v(_mm_set1_ps(xyzw)) {}
+	_linalg_float4(const float x, const float y, const float z, const float w) : v(_mm_setr_ps(x, y, z, w)) {}
+
+	static inline _linalg_float4 load(const float *p) { return _mm_loadu_ps(p); }
+	inline void store(float *p) const { _mm_storeu_ps(p, this->v); }
+
+	// A non-temporal store bypassing the cache, p must be 16 byte aligned
+	inline void stream(float *p) const { _mm_stream_ps(p, this->v); }
+
+	inline float operator[](const int index) const
+	{
+		float lanes[4];
+		_mm_storeu_ps(lanes, this->v);
+
+		return lanes[index];
+	}
+
+#else
+
+	float v[4];
+
+	_linalg_float4() {}
+	explicit _linalg_float4(const float xyzw) { this->v[0] = this->v[1] = this->v[2] = this->v[3] = xyzw; }
+	_linalg_float4(const float x, const float y, const float z, const float w) { this->v[0] = x; this->v[1] = y; this->v[2] = z; this->v[3] = w; }
+
+	static inline _linalg_float4 load(const float *p) { return _linalg_float4(p[0], p[1], p[2], p[3]); }
+	inline void store(float *p) const { p[0] = this->v[0]; p[1] = this->v[1]; p[2] = this->v[2]; p[3] = this->v[3]; }
+	inline void stream(float *p) const { store(p); }
+
+	inline float operator[](const int index) const { return this->v[index]; }
+
+#endif
+};
+
+
+#ifdef LINALG_SIMD_SSE2
+
+inline _linalg_float4 operator+(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { return _mm_add_ps(lhs.v, rhs.v); }
+inline _linalg_float4 operator-(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { return _mm_sub_ps(lhs.v, rhs.v); }
+inline _linalg_float4 operator*(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { return _mm_mul_ps(lhs.v, rhs.v); }
+inline _linalg_float4 operator/(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { return _mm_div_ps(lhs.v, rhs.v); }
+
+inline _linalg_float4 _linalg_min(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_min_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_max(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_max_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_sqrt(const _linalg_float4 &a) { return _mm_sqrt_ps(a.v); }
+inline _linalg_float4 _linalg_abs(const _linalg_float4 &a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+
+// Comparisons result in a mask, with all bits of a lane set when true
+inline _linalg_float4 _linalg_cmplt(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_cmplt_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_cmple(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_cmple_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_cmpgt(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_cmpge(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_cmpge_ps(a.v, b.v); }
+
+inline _linalg_float4 _linalg_and(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_and_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_or(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_or_ps(a.v, b.v); }
+inline _linalg_float4 _linalg_xor(const _linalg_float4 &a, const _linalg_float4 &b) { return _mm_xor_ps(a.v, b.v); }
+
+// Picks a where the mask is set, otherwise b
+inline _linalg_float4 _linalg_select(const _linalg_float4 &mask, const _linalg_float4 &a, const _linalg_float4 &b)
+{
+	return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+// Gathers the sign bit of each lane into the lowest 4 bits
+inline int _linalg_movemask(const _linalg_float4 &mask) { return _mm_movemask_ps(mask.v); }
+
+// Orders the non-temporal stores before any following store
+inline void _linalg_stream_fence() { _mm_sfence(); }
+
+// Converts the lanes to ints rounding towards zero, and back
+inline void _linalg_truncate(const _linalg_float4 &a, int *p) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_cvttps_epi32(a.v)); }
+inline _linalg_float4 _linalg_int_to_float(const int *p) { return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+
+inline void _linalg_transpose4(_linalg_float4 &a, _linalg_float4 &b, _linalg_float4 &c, _linalg_float4 &d)
+{
+	_MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+}
+
+// Loads 4 consecutive vec3's (12 floats) and splits them into x, y and z lanes
+inline void _linalg_load3x4(const float *p, _linalg_float4 &x, _linalg_float4 &y, _linalg_float4 &z)
+{
+	const __m128 a = _mm_loadu_ps(p + 0); // x0 y0 z0 x1
+	const __m128 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+	const __m128 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+
+	x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+	y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// Interleaves x, y and z lanes back into 4 consecutive vec3's
+inline void _linalg_store3x4(float *p, const _linalg_float4 &x, const _linalg_float4 &y, const _linalg_float4 &z)
+{
+	_mm_storeu_ps(p + 0, _mm_shuffle_ps(_mm_shuffle_ps(x.v, y.v, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z.v, x.v, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(p + 4, _mm_shuffle_ps(_mm_shuffle_ps(y.v, z.v, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x.v, y.v, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(p + 8, _mm_shuffle_ps(_mm_shuffle_ps(z.v, x.v, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y.v, z.v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#else
+
+#define _LINALG_FLOAT4_LANES(result, expr) \
+	_linalg_float4 result; \
+	for (int i = 0; i < 4; i++) \
+		result.v[i] = (expr);
+
+inline unsigned int _linalg_float_bits(const float f) { unsigned int u; memcpy(&u, &f, sizeof(u)); return u; }
+inline float _linalg_bits_float(const unsigned int u) { float f; memcpy(&f, &u, sizeof(f)); return f; }
+
+inline _linalg_float4 operator+(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { _LINALG_FLOAT4_LANES(r, lhs.v[i] + rhs.v[i]); return r; }
+inline _linalg_float4 operator-(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { _LINALG_FLOAT4_LANES(r, lhs.v[i] - rhs.v[i]); return r; }
+inline _linalg_float4 operator*(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { _LINALG_FLOAT4_LANES(r, lhs.v[i] * rhs.v[i]); return r; }
+inline _linalg_float4 operator/(const _linalg_float4 &lhs, const _linalg_float4 &rhs) { _LINALG_FLOAT4_LANES(r, lhs.v[i] / rhs.v[i]); return r; }
+
+inline _linalg_float4 _linalg_min(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, (a.v[i] < b.v[i]) ? a.v[i] : b.v[i]); return r; }
+inline _linalg_float4 _linalg_max(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, (a.v[i] > b.v[i]) ? a.v[i] : b.v[i]); return r; }
+inline _linalg_float4 _linalg_sqrt(const _linalg_float4 &a) { _LINALG_FLOAT4_LANES(r, sqrtf(a.v[i])); return r; }
+inline _linalg_float4 _linalg_abs(const _linalg_float4 &a) { _LINALG_FLOAT4_LANES(r, fabsf(a.v[i])); return r; }
+
+inline _linalg_float4 _linalg_cmplt(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float((a.v[i] < b.v[i]) ? 0xFFFFFFFFu : 0u)); return r; }
+inline _linalg_float4 _linalg_cmple(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float((a.v[i] <= b.v[i]) ? 0xFFFFFFFFu : 0u)); return r; }
+inline _linalg_float4 _linalg_cmpgt(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float((a.v[i] > b.v[i]) ? 0xFFFFFFFFu : 0u)); return r; }
+inline _linalg_float4 _linalg_cmpge(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float((a.v[i] >= b.v[i]) ? 0xFFFFFFFFu : 0u)); return r; }
+
+inline _linalg_float4 _linalg_and(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float(_linalg_float_bits(a.v[i]) & _linalg_float_bits(b.v[i]))); return r; }
+inline _linalg_float4 _linalg_or(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float(_linalg_float_bits(a.v[i]) | _linalg_float_bits(b.v[i]))); return r; }
+inline _linalg_float4 _linalg_xor(const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_bits_float(_linalg_float_bits(a.v[i]) ^ _linalg_float_bits(b.v[i]))); return r; }
+
+inline _linalg_float4 _linalg_select(const _linalg_float4 &mask, const _linalg_float4 &a, const _linalg_float4 &b) { _LINALG_FLOAT4_LANES(r, _linalg_float_bits(mask.v[i]) ? a.v[i] : b.v[i]); return r; }
+
+inline int _linalg_movemask(const _linalg_float4 &mask)
+{
+	int bits = 0;
+
+	for (int i = 0; i < 4; i++)
+		bits |= ((_linalg_float_bits(mask.v[i]) >> 31) << i);
+
+	return bits;
+}
+
+inline void _linalg_stream_fence() {}
+
+inline void _linalg_truncate(const _linalg_float4 &a, int *p) { for (int i = 0; i < 4; i++) p[i] = static_cast<int>(a.v[i]); }
+inline _linalg_float4 _linalg_int_to_float(const int *p) { return _linalg_float4(float(p[0]), float(p[1]), float(p[2]), float(p[3])); }
+
+inline void _linalg_transpose4(_linalg_float4 &a, _linalg_float4 &b, _linalg_float4 &c, _linalg_float4 &d)
+{
+	const _linalg_float4 a0 = a, b0 = b, c0 = c, d0 = d;
+
+	a = _linalg_float4(a0.v[0], b0.v[0], c0.v[0], d0.v[0]);
+	b = _linalg_float4(a0.v[1], b0.v[1], c0.v[1], d0.v[1]);
+	c = _linalg_float4(a0.v[2], b0.v[2], c0.v[2], d0.v[2]);
+	d = _linalg_float4(a0.v[3], b0.v[3], c0.v[3], d0.v[3]);
+}
+
+inline void _linalg_load3x4(const float *p, _linalg_float4 &x, _linalg_float4 &y, _linalg_float4 &z)
+{
+	x = _linalg_float4(p[0], p[3], p[6], p[9]);
+	y = _linalg_float4(p[1], p[4], p[7], p[10]);
+	z = _linalg_float4(p[2], p[5], p[8], p[11]);
+}
+
+inline void _linalg_store3x4(float *p, const _linalg_float4 &x, const _linalg_float4 &y, const _linalg_float4 &z)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		p[i * 3 + 0] = x.v[i];
+		p[i * 3 + 1] = y.v[i];
+		p[i * 3 + 2] = z.v[i];
+	}
+}
+
+#undef _LINALG_FLOAT4_LANES
+
+#endif
+
+#pragma endregion
+
+
 // Disable structure padding
 #pragma pack(push, 1)
 
@@ -102,7 +319,25 @@ template<typename T> class mat2_t;
 template<typename T> class mat3_t;
 template<typename T> class mat4_t;
 
+template<typename T> class affine_t;
+
 template<typename T> class quat_t;
+template<typename T> class dualquat_t;
+
+template<typename T> class aabb_t;
+template<typename T> class sphere_t;
+template<typename T> class obb_t;
+
+template<typename T> class frustum_t;
+template<typename T> class ray_t;
+
+template<typename T> class camera_t;
+
+class half;
+
+class hvec2;
+class hvec3;
+class hvec4;
 
 
 typedef vec2_t<LINALG_DEFAULT_SCALAR> vec2;
@@ -195,12 +430,60 @@ typedef mat4x4_t<float> fmat4x4;
 typedef mat4x4_t<double> dmat4x4;
 
 
+typedef affine_t<LINALG_DEFAULT_SCALAR> affine;
+
+typedef affine_t<float> faffine;
+typedef affine_t<double> daffine;
+
+
 typedef quat_t<LINALG_DEFAULT_SCALAR> quat;
 
 typedef quat_t<float> fquat;
 typedef quat_t<double> dquat;
 
 
+typedef dualquat_t<LINALG_DEFAULT_SCALAR> dualquat;
+
+typedef dualquat_t<float> fdualquat;
+typedef dualquat_t<double> ddualquat;
+
+
+typedef aabb_t<LINALG_DEFAULT_SCALAR> aabb;
+
+typedef aabb_t<float> faabb;
+typedef aabb_t<double> daabb;
+
+
+typedef sphere_t<LINALG_DEFAULT_SCALAR> sphere;
+
+typedef sphere_t<float> fsphere;
+typedef sphere_t<double> dsphere;
+
+
+typedef obb_t<LINALG_DEFAULT_SCALAR> obb;
+
+typedef obb_t<float> fobb;
+typedef obb_t<double> dobb;
+
+
+typedef frustum_t<LINALG_DEFAULT_SCALAR> frustum;
+
+typedef frustum_t<float> ffrustum;
+typedef frustum_t<double> dfrustum;
+
+
+typedef ray_t<LINALG_DEFAULT_SCALAR> ray;
+
+typedef ray_t<float> fray;
+typedef ray_t<double> dray;
+
+
+typedef camera_t<LINALG_DEFAULT_SCALAR> camera;
+
+typedef camera_t<float> fcamera;
+typedef camera_t<double> dcamera;
+
+
 #if defined(_DEBUG) && !defined(DEBUG)
 #	define DEBUG 1
 #endif
@@ -639,7 +922,7 @@ public:
 
 	inline vec2 clamp(const vec2 &min, const vec2 &max) const
 	{
-		return min(max).max(min);
+		return this->max(min).min(max);
 	}
 	friend inline vec2 clamp(const vec2 &v, const vec2 &min, const vec2 &max) { return v.clamp(min, max); }
 
@@ -1159,7 +1442,7 @@ public:
 
 	inline vec3 clamp(const vec3 &min, const vec3 &max) const
 	{
-		return min(max).max(min);
+		return this->max(min).min(max);
 	}
 	friend inline vec3 clamp(const vec3 &v, const vec3 &min, const vec3 &max) { return v.clamp(min, max); }
 
@@ -1209,6 +1492,39 @@ public:
 
 #pragma endregion
 
+#pragma region Encoding
+
+	// Unit vectors e.g. normals in 32 or 16 bits, using the octahedral mapping with the two coordinates
+	// stored as signed normalized integers, x in the low half. The maximum angular error is 0.004
+	// degrees in 32 bits and 0.95 degrees in 16 bits, and a zero vector decodes as (0, 0, 1).
+	//
+	// Reference: Cigolle et al., "A Survey of Efficient Representations for Independent Unit Vectors" (2014)
+	static unsigned int encodeOctahedral(const vec3 &v);
+	static vec3 decodeOctahedral(const unsigned int encoded);
+
+	static unsigned short encodeOctahedral16(const vec3 &v);
+	static vec3 decodeOctahedral16(const unsigned short encoded);
+
+	// x, y and z as 10 bit and w as a 2 bit signed normalized integer, from the low bits, e.g. for
+	// GL_INT_2_10_10_10_REV vertex attributes with w the handedness of a tangent. The maximum angular
+	// error of a unit vector is 0.1 degrees, which isn't normalized when decoded.
+	static unsigned int encode1010102(const vec3 &v, const T w = T(0));
+	static vec3 decode1010102(const unsigned int encoded, T *w = nullptr);
+
+
+	// Batch versions of the above, converting count vectors
+	static void encodeOctahedral(const vec3 *vectors, const size_t count, unsigned int *result);
+	static void decodeOctahedral(const unsigned int *encoded, const size_t count, vec3 *result);
+
+	static void encodeOctahedral16(const vec3 *vectors, const size_t count, unsigned short *result);
+	static void decodeOctahedral16(const unsigned short *encoded, const size_t count, vec3 *result);
+
+	// w is read from and written to count values, if given
+	static void encode1010102(const vec3 *vectors, const size_t count, unsigned int *result, const T *w = nullptr);
+	static void decode1010102(const unsigned int *encoded, const size_t count, vec3 *result, T *w = nullptr);
+
+#pragma endregion
+
 #pragma region Swizzling
 
 #define LINALG_SWIZZLE_INDEX(index, c) \
@@ -1622,7 +1938,7 @@ public:
 
 	inline vec4 clamp(const vec4 &min, const vec4 &max) const
 	{
-		return min(max).max(min);
+		return this->max(min).min(max);
 	}
 	friend inline vec4 clamp(const vec4 &v, const vec4 &min, const vec4 &max) { return v.clamp(min, max); }
 
@@ -1769,6 +2085,12 @@ public:
 		this->columns[1] = column2;
 	}
 
+	mat2_t(const mat2_t<T> &m)
+	{
+		this->columns[0] = m.columns[0];
+		this->columns[1] = m.columns[1];
+	}
+
 	mat2_t(const vec2 columns[2])
 	{
 		this->columns[0] = columns[0];
@@ -2120,6 +2442,13 @@ public:
 		this->columns[2] = column3;
 	}
 
+	mat3_t(const mat3_t<T> &m)
+	{
+		this->columns[0] = m.columns[0];
+		this->columns[1] = m.columns[1];
+		this->columns[2] = m.columns[2];
+	}
+
 	mat3_t(const vec3 columns[3])
 	{
 		this->columns[0] = columns[0];
@@ -2630,6 +2959,26 @@ private:
 
 public:
 
+	// The normalized device depth a projection maps the near and far plane to,
+	// which project(), unproject(), frustum_t and ray_t need to know
+	enum DepthRange
+	{
+		NegativeOneToOne, // OpenGL, e.g. perspective()
+		ZeroToOne, // Direct3D, Vulkan and glClipControl(), e.g. perspectiveZO()
+		OneToZero // Reverse-Z, e.g. perspectiveReverseZ()
+	};
+
+	// The faces of a cube map in the order of GL_TEXTURE_CUBE_MAP_POSITIVE_X and onwards
+	enum CubeMapFace
+	{
+		PositiveX, NegativeX,
+		PositiveY, NegativeY,
+		PositiveZ, NegativeZ,
+
+		CubeMapFaceCount
+	};
+
+
 	static const mat4_t<T> zero;
 	static const mat4_t<T> identity;
 
@@ -2668,6 +3017,20 @@ public:
 	}
 
 
+	// A symmetric perspective projection, with the depth mapping given as (a * z + b) / -z
+	static mat4 perspectiveDepth(const T fov, const T aspect, const T a, const T b)
+	{
+		const T sy = T(1) / tan(fov * T(LINALG_DEG2RAD) * T(0.5));
+		const T sx = sy / aspect;
+
+		return mat4(
+			vec4(sx, T(0), T(0), T(0)),
+			vec4(T(0), sy, T(0), T(0)),
+			vec4(T(0), T(0), a, T(-1)),
+			vec4(T(0), T(0), b, T(0))
+		);
+	}
+
 	static mat4 perspective(const T fov, const T aspect, const T zNear, const T zFar)
 	{
 		const T fovRad = fov * T(LINALG_DEG2RAD);
@@ -2697,6 +3060,69 @@ public:
 	}
 
 
+	// The perspective() variants all map view space depth d = -z to normalized device depth
+	// (a * z + b) / d, with a = m[2].z and b = m[3].z, which inversePerspective() and
+	// linearizeDepth() rely on. Reverse-Z maps the near plane to 1 and the far plane to 0,
+	// which with a floating-point depth buffer and the ZeroToOne depth range keeps the
+	// precision close to constant over distance. The infinite variants have no far plane.
+	// The window depth then goes from 1 at the near plane to 0, see DepthRange.
+
+	// The ZeroToOne depth range version of perspective()
+	static mat4 perspectiveZO(const T fov, const T aspect, const T zNear, const T zFar)
+	{
+		return perspectiveDepth(fov, aspect, -zFar / (zFar - zNear), -(zFar * zNear) / (zFar - zNear));
+	}
+
+	// Reverse-Z, mapping the near plane to 1 and the far plane to 0 in the OneToZero depth range
+	static mat4 perspectiveReverseZ(const T fov, const T aspect, const T zNear, const T zFar)
+	{
+		return perspectiveDepth(fov, aspect, zNear / (zFar - zNear), (zFar * zNear) / (zFar - zNear));
+	}
+
+	// Mapping the near plane to -1 and infinity to 1 in the NegativeOneToOne depth range
+	static mat4 perspectiveInfinite(const T fov, const T aspect, const T zNear)
+	{
+		return perspectiveDepth(fov, aspect, T(-1), -zNear * T(2));
+	}
+
+	// Mapping the near plane to 0 and infinity to 1 in the ZeroToOne depth range
+	static mat4 perspectiveInfiniteZO(const T fov, const T aspect, const T zNear)
+	{
+		return perspectiveDepth(fov, aspect, T(-1), -zNear);
+	}
+
+	// Reverse-Z, mapping the near plane to 1 and infinity to 0 in the OneToZero depth range
+	static mat4 perspectiveInfiniteReverseZ(const T fov, const T aspect, const T zNear)
+	{
+		return perspectiveDepth(fov, aspect, T(0), zNear);
+	}
+
+	// The inverse of any of the perspective() variants, without a general inverse
+	static mat4 inversePerspective(const mat4 &projection)
+	{
+		const T a = projection[2].z, b = projection[3].z;
+
+		return mat4(
+			vec4(T(1) / projection[0].x, T(0), T(0), T(0)),
+			vec4(T(0), T(1) / projection[1].y, T(0), T(0)),
+			vec4(T(0), T(0), T(0), T(1) / b),
+			vec4(T(0), T(0), T(-1), a / b)
+		);
+	}
+
+	// The positive view space distance along the view direction, of a window depth in [0, 1]
+	// written by any of the perspective() variants with the given depth range
+	static inline T linearizeDepth(const T depth, const mat4 &projection, const DepthRange depthRange = NegativeOneToOne)
+	{
+		const T ndcDepth = (depthRange == NegativeOneToOne) ? (depth * T(2) - T(1)) : depth;
+
+		return projection[3].z / (ndcDepth + projection[2].z);
+	}
+
+	// Same as above, for count depths e.g. read back from a depth buffer
+	static void linearizeDepth(const T *depth, const size_t count, const mat4 &projection, T *result, const DepthRange depthRange = NegativeOneToOne);
+
+
 	static inline mat4 orthographic(const T left, const T right, const T bottom, const T top, const T zNear = T(-1), const T zFar = T(1))
 	{
 		return mat4(
@@ -2787,40 +3213,107 @@ public:
 	}
 
 
-	static vec3 project(const vec3 &object, const mat4 &modelView, const mat4 &projection, const ivec4 &viewport)
+	// The batch functions below take the positions as a structure of arrays and write count matrices,
+	// either as mat4_t or as the compact affine_t. They don't branch on degenerate input, instead a
+	// direction of zero length results in zero axes.
+
+	// The view matrices of lookAt(), for each eye looking at its target
+	static void lookAt(
+		const T *eyeX, const T *eyeY, const T *eyeZ, const T *atX, const T *atY, const T *atZ,
+		const size_t count, const vec3 &up, mat4 *result);
+
+	static void lookAt(
+		const T *eyeX, const T *eyeY, const T *eyeZ, const T *atX, const T *atY, const T *atZ,
+		const size_t count, const vec3 &up, affine_t<T> *result);
+
+	// Model matrices at the positions, facing the eye with their z axis and keeping their y axis
+	// towards up, e.g. for particles. If scale isn't nullptr, matrix i is scaled by scale[i].
+	static void billboards(
+		const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+		const size_t count, const vec3 &eye, const vec3 &up, mat4 *result);
+
+	static void billboards(
+		const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+		const size_t count, const vec3 &eye, const vec3 &up, affine_t<T> *result);
+
+	// Same as above, but only rotating around axis, which becomes their y axis, e.g. for foliage
+	static void axisBillboards(
+		const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+		const size_t count, const vec3 &eye, const vec3 &axis, mat4 *result);
+
+	static void axisBillboards(
+		const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+		const size_t count, const vec3 &eye, const vec3 &axis, affine_t<T> *result);
+
+
+	// The view matrix of a cube map face at position, the same as lookAt() towards the face
+	// with the up vectors cube map lookups expect, but built from a table instead of normalizing
+	static mat4 cubeMapView(const vec3 &position, const CubeMapFace face);
+
+	// The square 90 degree perspective() the faces share, without going through tan()
+	static inline mat4 cubeMapProjection(const T zNear, const T zFar)
 	{
-		const vec4 a = modelView * vec4(object, 1.0f);
-		const vec3 ab = mat3(projection) * vec3(a);
+		return mat4(
+			vec4(T(1), T(0), T(0), T(0)),
+			vec4(T(0), T(1), T(0), T(0)),
+			vec4(T(0), T(0), -(zFar + zNear) / (zFar - zNear), T(-1)),
+			vec4(T(0), T(0), -(zFar * zNear * T(2)) / (zFar - zNear), T(0))
+		);
+	}
+
+	// The view-projection matrices of all 6 faces, for count cube maps e.g. point light shadows or
+	// reflection probes at the positions, sharing the projection e.g. cubeMapProjection() or a
+	// 90 degree reverse-Z one. The result holds count * CubeMapFaceCount matrices in CubeMapFace
+	// order, and frustums, unless nullptr, the same number of world space frustums.
+	static void cubeMaps(
+		const T *positionX, const T *positionY, const T *positionZ, const size_t count,
+		const mat4 &projection, mat4 *viewProjections, frustum_t<T> *frustums = nullptr,
+		const DepthRange depthRange = NegativeOneToOne);
+
+
+	// Compares count matrices against their previous values, e.g. instance transforms against those
+	// uploaded last frame. Bit (i % 8) of changed[i / 8] is set if any element of matrix i differs by
+	// more than epsilon, where an epsilon of 0 compares exactly, so changed must hold (count + 7) / 8
+	// bytes. Returns the amount of changed matrices.
+	static size_t diff(const mat4 *current, const mat4 *previous, const size_t count, unsigned char *changed, const T epsilon = T(0));
 
-		vec4 b = vec4(ab, -a.z);
+	// Same as above, but writes the changed matrices as ranges from ranges[r * 2] up to (excluding)
+	// ranges[r * 2 + 1]. Ranges separated by at most gap unchanged matrices are merged, as each upload
+	// has a cost of its own. ranges must hold count + 1 indices, and the amount of ranges is returned.
+	static size_t diffRanges(const mat4 *current, const mat4 *previous, const size_t count, size_t *ranges, const T epsilon = T(0), const size_t gap = 0);
 
-		if (LINALG_FEQUAL(b.w, 0.0f))
+
+	// The window depth is in [0, 1], as with glDepthRangef(0.0f, 1.0f), where depthRange is
+	// the normalized device depth range of the projection mapped to it. With OneToZero it
+	// goes from 1 at the near plane to 0 at the far plane.
+
+	static vec3 project(const vec3 &object, const mat4 &modelView, const mat4 &projection, const ivec4 &viewport, const DepthRange depthRange = NegativeOneToOne)
+	{
+		const vec4 clip = projection * (modelView * vec4(object, T(1)));
+
+		if (LINALG_FEQUAL(clip.w, 0.0f))
 			return vec3(0.0f, 0.0f, 0.0f);
 
-		b.w = 1.0f / b.w;
+		const T invW = T(1) / clip.w;
 
-		b.x = b.x * b.w;
-		b.y = b.y * b.w;
-		b.z = b.z * b.w;
+		const vec3 ndc(clip.x * invW, clip.y * invW, clip.z * invW);
 
 		vec3 window;
 
-		window.x = (b.x * 0.5f + 0.5f) * viewport.z + viewport.x;
-		window.y = (b.y * 0.5f + 0.5f) * viewport.w + viewport.y;
-
-		// This is only correct when glDepthRangef(0.0f, 1.0f)
-		window.z = (1.0f + b.z) * 0.5f;
+		window.x = (ndc.x * T(0.5) + T(0.5)) * viewport.z + viewport.x;
+		window.y = (ndc.y * T(0.5) + T(0.5)) * viewport.w + viewport.y;
+		window.z = (depthRange == NegativeOneToOne) ? ((T(1) + ndc.z) * T(0.5)) : ndc.z;
 
 		return window;
 	}
 
-	static inline vec3 project(const vec3 &object, const mat4 &model, const mat4 &view, const mat4 &projection, const ivec4 &viewport)
+	static inline vec3 project(const vec3 &object, const mat4 &model, const mat4 &view, const mat4 &projection, const ivec4 &viewport, const DepthRange depthRange = NegativeOneToOne)
 	{
-		return mat4::project(object, (view * model), projection, viewport);
+		return mat4::project(object, (view * model), projection, viewport, depthRange);
 	}
 
 
-	static vec3 unproject(const vec3 &window, const mat4 &modelViewProjection, const ivec4 &viewport)
+	static vec3 unproject(const vec3 &window, const mat4 &modelViewProjection, const ivec4 &viewport, const DepthRange depthRange = NegativeOneToOne)
 	{
 		const mat4 inverseMVP = mat4(modelViewProjection).inverse();
 
@@ -2830,6 +3323,7 @@ public:
 		in.y = (in.y - static_cast<float>(viewport.y)) / static_cast<float>(viewport.w);
 
 		in = in * 2.0f - 1.0f;
+		in.z = (depthRange == NegativeOneToOne) ? in.z : window.z;
 		in.w = 1.0f;
 
 		vec4 out = inverseMVP * in;
@@ -2847,17 +3341,41 @@ public:
 		return object;
 	}
 
-	static inline vec3 unproject(const vec3 &window, const mat4 &modelView, const mat4 &projection, const ivec4 &viewport)
+	static inline vec3 unproject(const vec3 &window, const mat4 &modelView, const mat4 &projection, const ivec4 &viewport, const DepthRange depthRange = NegativeOneToOne)
 	{
-		return unproject(window, (projection * modelView), viewport);
+		return unproject(window, (projection * modelView), viewport, depthRange);
 	}
 
-	static inline vec3 unproject(const vec3 &window, const mat4 &model, const mat4 &view, const mat4 &projection, const ivec4 &viewport)
+	static inline vec3 unproject(const vec3 &window, const mat4 &model, const mat4 &view, const mat4 &projection, const ivec4 &viewport, const DepthRange depthRange = NegativeOneToOne)
 	{
-		return unproject(window, (projection * view * model), viewport);
+		return unproject(window, (projection * view * model), viewport, depthRange);
 	}
 
 
+	// The batch functions below take the bounds as a structure of arrays and write the screen space
+	// rectangle of each object in window coordinates, as returned by project(). Objects not entirely
+	// in front of the eye can't be bounded on screen, and result in the whole viewport and a
+	// projected radius of HUGE_VAL. The rectangles are tight and aren't clamped to the viewport.
+	//
+	// The projected radius is the radius in pixels along the viewport's height, of the sphere or
+	// the sphere enclosing the box, at the distance of its center. It's meant for selectLODs().
+
+	static void projectSpheres(
+		const T *centerX, const T *centerY, const T *centerZ, const T *radius, const size_t count,
+		const mat4 &viewProjection, const ivec4 &viewport,
+		T *rectMinX, T *rectMinY, T *rectMaxX, T *rectMaxY, T *projectedRadius);
+
+	static void projectAABBs(
+		const T *minX, const T *minY, const T *minZ,
+		const T *maxX, const T *maxY, const T *maxZ, const size_t count,
+		const mat4 &viewProjection, const ivec4 &viewport,
+		T *rectMinX, T *rectMinY, T *rectMaxX, T *rectMaxY, T *projectedRadius);
+
+	// Writes the level of detail of each object, being the amount of thresholds its projected radius is
+	// below, where the thresholds are in pixels and descending, e.g. { 128, 32, 8 } gives levels 0 to 3
+	static void selectLODs(const T *projectedRadius, const size_t count, const T *thresholds, const size_t thresholdCount, unsigned char *lods);
+
+
 	static mat4 pickMatrix(const vec2 &center, const vec2 &size, const ivec4 &viewport)
 	{
 		mat4 m = mat4::identity;
@@ -2931,6 +3449,14 @@ public:
 		this->columns[3] = column4;
 	}
 
+	mat4_t(const mat4_t<T> &m)
+	{
+		this->columns[0] = m.columns[0];
+		this->columns[1] = m.columns[1];
+		this->columns[2] = m.columns[2];
+		this->columns[3] = m.columns[3];
+	}
+
 	mat4_t(const vec4 columns[4])
 	{
 		this->columns[0] = columns[0];
@@ -3682,81 +4208,251 @@ public:
 };
 
 
+// A compact affine transformation, i.e. the upper 3 rows of a mat4 where the
+// last row is implicitly (0, 0, 0, 1). It's stored by rows, such that
+// transforming a point is 3 dot products, which suits batch processing.
 template<typename T>
-class quat_t
+class affine_t
 {
 private:
 
 	typedef vec3_t<T> vec3;
 	typedef vec4_t<T> vec4;
 
-	typedef quat_t<T> quat;
+	typedef mat3_t<T> mat3;
+	typedef mat4_t<T> mat4;
 
+	typedef affine_t<T> affine;
 
-public:
 
-	static const quat_t<T> zero;
-	static const quat_t<T> one;
+public:
 
-	static const quat_t<T> identity;
+	static const affine_t<T> zero;
+	static const affine_t<T> identity;
 
 
 public:
 
-	T x, y, z, w;
+	vec4 rows[3];
 
 
 public:
 
-	quat_t() : x(T(0)), y(T(0)), z(T(0)), w(T(0)) {}
-
-	quat_t(const quat_t<T> &q) : x(q.x), y(q.y), z(q.z), w(q.w) {}
-	template<typename T2> quat_t(const quat_t<T2> &q) : x(T(q.x)), y(T(q.y)), z(T(q.z)), w(T(q.w)) {}
-
-	template<typename T2> quat_t(const vec4 &v) : x(T(v[0])), y(T(v[1])), z(T(v[2])), w(T(v[3])) {}
-	template<typename T2> quat_t(const vec4_t<T2> &v) : x(T(v.x)), y(T(v.y)), z(T(v.z)), w(T(v.w)) {}
+	affine_t(const T mainDiagonalValue = T(1))
+	{
+		this->rows[0] = vec4(mainDiagonalValue, T(0), T(0), T(0));
+		this->rows[1] = vec4(T(0), mainDiagonalValue, T(0), T(0));
+		this->rows[2] = vec4(T(0), T(0), mainDiagonalValue, T(0));
+	}
 
-	template<typename T2> quat_t(const T2 &xyzw) : x(T(xyzw)), y(T(xyzw)), z(T(xyzw)), w(T(xyzw)) {}
-	template<typename T2> quat_t(const T2 &x, const T2 &y, const T2 &z, const T2 &w) : x(T(x)), y(T(y)), z(T(z)), w(T(w)) {}
+	affine_t(const affine_t<T> &m)
+	{
+		this->rows[0] = m.rows[0];
+		this->rows[1] = m.rows[1];
+		this->rows[2] = m.rows[2];
+	}
 
-	template<typename T2> quat_t(const T2 *xyzw) : x(T(xyzw[0])), y(T(xyzw[1])), z(T(xyzw[2])), w(T(xyzw[3])) {}
+	affine_t(
+		const vec4 &row1, // first row
+		const vec4 &row2, // second row
+		const vec4 &row3) // third row
+	{
+		this->rows[0] = row1;
+		this->rows[1] = row2;
+		this->rows[2] = row3;
+	}
 
-	quat_t(const T radians, const vec3 &axis)
+	// The last row of the matrix is discarded
+	affine_t(const mat4 &m)
 	{
-		(*this) = rotate(radians, axis);
+		this->rows[0] = m.row(0);
+		this->rows[1] = m.row(1);
+		this->rows[2] = m.row(2);
 	}
 
-	~quat_t() {}
+	~affine_t() {}
 
 
 #pragma region Operator Overloading
 
 #pragma region Member Access Operators
 
-	inline T& operator[](const int index) { return (reinterpret_cast<T*>(this))[index]; }
-	inline T operator[](const int index) const { return ((T*) this)[index]; }
+	inline vec4& operator[](const int index) { return this->rows[index]; }
+	inline vec4 operator[](const int index) const { return this->rows[index]; }
 
 #pragma endregion
 
 #pragma region Arithmetic Operators
 
-	quat operator+(const quat &rhs) const { return quat(this->x + rhs.x, this->y + rhs.y, this->z + rhs.z, this->w + rhs.w); }
-	quat operator-(const quat &rhs) const { return quat(this->x - rhs.x, this->y - rhs.y, this->z - rhs.z, this->w - rhs.w); }
+	affine operator+(const affine &rhs) const { return affine(this->rows[0] + rhs.rows[0], this->rows[1] + rhs.rows[1], this->rows[2] + rhs.rows[2]); }
+	affine operator-(const affine &rhs) const { return affine(this->rows[0] - rhs.rows[0], this->rows[1] - rhs.rows[1], this->rows[2] - rhs.rows[2]); }
 
-	// Like for matrix multiplication, quaternion multiplication is non-commutative:
-	// (q1 * q2) != (q2 * q1)
-	quat operator*(const quat &rhs) const
+	affine operator*(const affine &rhs) const
 	{
-		return quat(
-			(this->w * rhs.x) + (this->x * rhs.w) + (this->y * rhs.z) - (this->z * rhs.y),
-			(this->w * rhs.y) - (this->x * rhs.z) + (this->y * rhs.w) + (this->z * rhs.x),
-			(this->w * rhs.z) + (this->x * rhs.y) - (this->y * rhs.x) + (this->z * rhs.w),
-			(this->w * rhs.w) - (this->x * rhs.x) - (this->y * rhs.y) - (this->z * rhs.z)
-		);
+		affine result;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const vec4 &r = this->rows[i];
+
+			result.rows[i] = r.x * rhs.rows[0] + r.y * rhs.rows[1] + r.z * rhs.rows[2];
+			result.rows[i].w += r.w;
+		}
+
+		return result;
 	}
 
-	friend inline quat& operator*(const quat &lhs, const T &rhs) { return (lhs * quat(rhs)); }
-	friend inline quat& operator/(const quat &lhs, const T &rhs) { return (lhs / quat(rhs)); }
+	affine operator*(const T &rhs) const { return affine(this->rows[0] * rhs, this->rows[1] * rhs, this->rows[2] * rhs); }
+	friend inline affine operator*(const T &lhs, const affine &rhs) { return (rhs * lhs); }
+
+#pragma endregion
+#pragma region Assignment Operators
+
+	inline affine& operator+=(const affine &rhs) { return ((*this) = ((*this) + rhs)); }
+	inline affine& operator-=(const affine &rhs) { return ((*this) = ((*this) - rhs)); }
+	inline affine& operator*=(const affine &rhs) { return ((*this) = ((*this) * rhs)); }
+	inline affine& operator*=(const T &rhs) { return ((*this) = ((*this) * rhs)); }
+
+	affine& operator=(const affine &rhs)
+	{
+		for (int i = 0; i < 3; i++)
+			this->rows[i] = rhs.rows[i];
+
+		return (*this);
+	}
+
+#pragma endregion
+
+#pragma endregion
+
+
+	mat4 toMat4() const
+	{
+		return mat4(
+			this->rows[0].x, this->rows[1].x, this->rows[2].x, T(0),
+			this->rows[0].y, this->rows[1].y, this->rows[2].y, T(0),
+			this->rows[0].z, this->rows[1].z, this->rows[2].z, T(0),
+			this->rows[0].w, this->rows[1].w, this->rows[2].w, T(1)
+		);
+	}
+	friend inline mat4 toMat4(const affine &m) { return m.toMat4(); }
+
+
+	inline vec3 transformPoint(const vec3 &point) const
+	{
+		return vec3(
+			this->rows[0].x * point.x + this->rows[0].y * point.y + this->rows[0].z * point.z + this->rows[0].w,
+			this->rows[1].x * point.x + this->rows[1].y * point.y + this->rows[1].z * point.z + this->rows[1].w,
+			this->rows[2].x * point.x + this->rows[2].y * point.y + this->rows[2].z * point.z + this->rows[2].w
+		);
+	}
+
+	// Ignores the translation
+	inline vec3 transformVector(const vec3 &vector) const
+	{
+		return vec3(
+			this->rows[0].x * vector.x + this->rows[0].y * vector.y + this->rows[0].z * vector.z,
+			this->rows[1].x * vector.x + this->rows[1].y * vector.y + this->rows[1].z * vector.z,
+			this->rows[2].x * vector.x + this->rows[2].y * vector.y + this->rows[2].z * vector.z
+		);
+	}
+
+
+	inline vec3 getTranslation() const
+	{
+		return vec3(this->rows[0].w, this->rows[1].w, this->rows[2].w);
+	}
+
+
+	inline void swap(affine &other)
+	{
+		const affine tmp(*this);
+		(*this) = other;
+		other = tmp;
+	}
+	friend inline void swap(affine &a, affine &b) { a.swap(b); }
+};
+
+
+template<typename T>
+class quat_t
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+
+	typedef mat3_t<T> mat3;
+	typedef mat4_t<T> mat4;
+
+	typedef quat_t<T> quat;
+
+
+public:
+
+	static const quat_t<T> zero;
+	static const quat_t<T> one;
+
+	static const quat_t<T> identity;
+
+
+public:
+
+	T x, y, z, w;
+
+
+public:
+
+	quat_t() : x(T(0)), y(T(0)), z(T(0)), w(T(0)) {}
+
+	quat_t(const quat_t<T> &q) : x(q.x), y(q.y), z(q.z), w(q.w) {}
+	template<typename T2> quat_t(const quat_t<T2> &q) : x(T(q.x)), y(T(q.y)), z(T(q.z)), w(T(q.w)) {}
+
+	template<typename T2> quat_t(const vec4 &v) : x(T(v[0])), y(T(v[1])), z(T(v[2])), w(T(v[3])) {}
+	template<typename T2> quat_t(const vec4_t<T2> &v) : x(T(v.x)), y(T(v.y)), z(T(v.z)), w(T(v.w)) {}
+
+	template<typename T2> quat_t(const T2 &xyzw) : x(T(xyzw)), y(T(xyzw)), z(T(xyzw)), w(T(xyzw)) {}
+	template<typename T2> quat_t(const T2 &x, const T2 &y, const T2 &z, const T2 &w) : x(T(x)), y(T(y)), z(T(z)), w(T(w)) {}
+
+	template<typename T2> quat_t(const T2 *xyzw) : x(T(xyzw[0])), y(T(xyzw[1])), z(T(xyzw[2])), w(T(xyzw[3])) {}
+
+	quat_t(const T radians, const vec3 &axis)
+	{
+		(*this) = rotate(radians, axis);
+	}
+
+	~quat_t() {}
+
+
+#pragma region Operator Overloading
+
+#pragma region Member Access Operators
+
+	inline T& operator[](const int index) { return (reinterpret_cast<T*>(this))[index]; }
+	inline T operator[](const int index) const { return ((T*) this)[index]; }
+
+#pragma endregion
+
+#pragma region Arithmetic Operators
+
+	quat operator+(const quat &rhs) const { return quat(this->x + rhs.x, this->y + rhs.y, this->z + rhs.z, this->w + rhs.w); }
+	quat operator-(const quat &rhs) const { return quat(this->x - rhs.x, this->y - rhs.y, this->z - rhs.z, this->w - rhs.w); }
+
+	// Like for matrix multiplication, quaternion multiplication is non-commutative:
+	// (q1 * q2) != (q2 * q1)
+	quat operator*(const quat &rhs) const
+	{
+		return quat(
+			(this->w * rhs.x) + (this->x * rhs.w) + (this->y * rhs.z) - (this->z * rhs.y),
+			(this->w * rhs.y) - (this->x * rhs.z) + (this->y * rhs.w) + (this->z * rhs.x),
+			(this->w * rhs.z) + (this->x * rhs.y) - (this->y * rhs.x) + (this->z * rhs.w),
+			(this->w * rhs.w) - (this->x * rhs.x) - (this->y * rhs.y) - (this->z * rhs.z)
+		);
+	}
+
+	friend inline quat operator*(const quat &lhs, const T &rhs) { return quat(lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs); }
+	friend inline quat operator*(const T &lhs, const quat &rhs) { return (rhs * lhs); }
+	friend inline quat operator/(const quat &lhs, const T &rhs) { return quat(lhs.x / rhs, lhs.y / rhs, lhs.z / rhs, lhs.w / rhs); }
 
 #pragma endregion
 #pragma region Assignment Operators
@@ -3931,6 +4627,28 @@ public:
 	}
 	friend inline quat rotate(const quat &q, const T angle, const vec3 axis) { return q.rotate(angle, axis); }
 
+
+	// Rotates v by the quaternion, the same as the vector part of (q * v * q^-1)
+	// expanded into (v + 2w(q x v) + 2q x (q x v)). The quaternion is expected
+	// to be normalized.
+	inline vec3 rotate(const vec3 &v) const
+	{
+		const vec3 u(this->x, this->y, this->z);
+		const vec3 t = T(2) * u.cross(v);
+
+		return (v + this->w * t + u.cross(t));
+	}
+	friend inline vec3 rotate(const quat &q, const vec3 &v) { return q.rotate(v); }
+
+	inline vec3 operator*(const vec3 &rhs) const { return rotate(rhs); }
+
+
+	// Rotates count vectors by the same quaternion
+	static void rotate(const quat &q, const vec3 *vectors, vec3 *result, const size_t count);
+
+	// Rotates count vectors each by their respective quaternion
+	static void rotate(const quat *quats, const vec3 *vectors, vec3 *result, const size_t count);
+
 	inline quat& rotateDegrees(const T degrees) { return rotate(degrees * T(LINALG_DEG2RAD)); }
 	friend inline quat rotateDegrees(const quat &q, const T degrees) { return quat(q).rotateDegrees(degrees); }
 
@@ -3944,7 +4662,197 @@ public:
 	friend inline quat inverse(const quat &q) { return q.inverse(); }
 
 
-	inline quat slerp(const quat &to, const quat &t) const
+	// Converts the quaternion into a rotation matrix, such that (q.toMat3() * v)
+	// rotates v by q. The quaternion is expected to be normalized.
+	//
+	// Note that mat3::rotate() results in the transpose of this,
+	// given the same axis and angle.
+	mat3 toMat3() const
+	{
+		const T xx = this->x * this->x, yy = this->y * this->y, zz = this->z * this->z;
+		const T xy = this->x * this->y, xz = this->x * this->z, yz = this->y * this->z;
+		const T wx = this->w * this->x, wy = this->w * this->y, wz = this->w * this->z;
+
+		return mat3(
+			T(1) - T(2) * (yy + zz), T(2) * (xy + wz), T(2) * (xz - wy),
+			T(2) * (xy - wz), T(1) - T(2) * (xx + zz), T(2) * (yz + wx),
+			T(2) * (xz + wy), T(2) * (yz - wx), T(1) - T(2) * (xx + yy)
+		);
+	}
+	friend inline mat3 toMat3(const quat &q) { return q.toMat3(); }
+
+	inline mat4 toMat4() const { return mat4(toMat3()); }
+	friend inline mat4 toMat4(const quat &q) { return q.toMat4(); }
+
+
+	// Converts a rotation matrix into a quaternion, the inverse of toMat3().
+	// The matrix is expected to be orthonormal.
+	//
+	// Reference: Shepperd, "Quaternion from Rotation Matrix" (1978)
+	static quat fromMat3(const mat3 &m)
+	{
+		// Each of these equals 4 times the square of w, x, y and z respectively,
+		// picking the largest avoids dividing by a value close to 0.
+		const T tw = T(1) + m(0, 0) + m(1, 1) + m(2, 2);
+		const T tx = T(1) + m(0, 0) - m(1, 1) - m(2, 2);
+		const T ty = T(1) - m(0, 0) + m(1, 1) - m(2, 2);
+		const T tz = T(1) - m(0, 0) - m(1, 1) + m(2, 2);
+
+		if ((tw >= tx) && (tw >= ty) && (tw >= tz))
+		{
+			const T s = T(0.5) / sqrt(tw);
+			return quat((m(2, 1) - m(1, 2)) * s, (m(0, 2) - m(2, 0)) * s, (m(1, 0) - m(0, 1)) * s, tw * s);
+		}
+		else if ((tx >= ty) && (tx >= tz))
+		{
+			const T s = T(0.5) / sqrt(tx);
+			return quat(tx * s, (m(0, 1) + m(1, 0)) * s, (m(0, 2) + m(2, 0)) * s, (m(2, 1) - m(1, 2)) * s);
+		}
+		else if (ty >= tz)
+		{
+			const T s = T(0.5) / sqrt(ty);
+			return quat((m(0, 1) + m(1, 0)) * s, ty * s, (m(1, 2) + m(2, 1)) * s, (m(0, 2) - m(2, 0)) * s);
+		}
+
+		const T s = T(0.5) / sqrt(tz);
+		return quat((m(0, 2) + m(2, 0)) * s, (m(1, 2) + m(2, 1)) * s, tz * s, (m(1, 0) - m(0, 1)) * s);
+	}
+
+	// Only the upper left 3x3 rotation part is used
+	static inline quat fromMat4(const mat4 &m) { return fromMat3(mat3(m)); }
+
+
+	// Batch versions of the above, converting count elements
+	static void toMat3(const quat *quats, mat3 *matrices, const size_t count);
+	static void toMat4(const quat *quats, mat4 *matrices, const size_t count);
+
+	static void fromMat3(const mat3 *matrices, quat *quats, const size_t count);
+	static void fromMat4(const mat4 *matrices, quat *quats, const size_t count);
+
+
+	// Packs a tangent frame, i.e. the rotation of the tangent (x), bitangent (y) and normal (z) axes, into
+	// 32 bits. The normal is octahedral encoded in 2 x 10 bits, followed by the angle of the tangent around
+	// it in 11 bits and a bit for whether the bitangent is reflected, i.e. cross(normal, tangent) negated.
+	// The maximum angular error of the axes is 0.25 degrees.
+	static unsigned int encodeTangentFrame(const quat &frame, const bool reflected = false);
+	static quat decodeTangentFrame(const unsigned int encoded, bool *reflected = nullptr);
+
+	// Batch versions of the above, where reflected is ignored if nullptr
+	static void encodeTangentFrame(const quat *frames, const bool *reflected, const size_t count, unsigned int *result);
+	static void decodeTangentFrame(const unsigned int *encoded, const size_t count, quat *result, bool *reflected = nullptr);
+
+
+	// Smallest three compression of a normalized quaternion, e.g. for animation keys. The three smallest
+	// components, which are within +-1/sqrt(2), are stored scaled by sqrt(2) as signed normalized integers
+	// of 10, 15 or 20 bits from the low bits, followed by the 2 bit index of the largest component. That one
+	// is recovered from the quaternion being unit length, where its sign is made positive, as q and -q are
+	// the same rotation. Each component is off by at most half a step, 1 / (2 * sqrt(2) * scale), where scale
+	// is 2^(bits - 1) - 1, and as the largest is at least 1/2, the rotation is off by at most sqrt(6) / scale
+	// radians. That is 0.275 degrees in 32 bits, 0.0086 degrees in 48 bits and 0.00027 degrees in 64 bits,
+	// where float rounding adds up to 0.00003 degrees.
+	static unsigned int encodeSmallestThree32(const quat &q);
+	static quat decodeSmallestThree32(const unsigned int encoded);
+
+	// 48 bits as 3 unsigned shorts, with the low 16 bits first
+	static void encodeSmallestThree48(const quat &q, unsigned short encoded[3]);
+	static quat decodeSmallestThree48(const unsigned short encoded[3]);
+
+	static unsigned long long encodeSmallestThree64(const quat &q);
+	static quat decodeSmallestThree64(const unsigned long long encoded);
+
+	// Batch versions of the above, converting count quaternions
+	static void encodeSmallestThree32(const quat *quats, const size_t count, unsigned int *result);
+	static void decodeSmallestThree32(const unsigned int *encoded, const size_t count, quat *result);
+
+	static void encodeSmallestThree48(const quat *quats, const size_t count, unsigned short *result);
+	static void decodeSmallestThree48(const unsigned short *encoded, const size_t count, quat *result);
+
+	static void encodeSmallestThree64(const quat *quats, const size_t count, unsigned long long *result);
+	static void decodeSmallestThree64(const unsigned long long *encoded, const size_t count, quat *result);
+
+
+	inline T dot(const quat &rhs) const
+	{
+		return (this->x * rhs.x + this->y * rhs.y + this->z * rhs.z + this->w * rhs.w);
+	}
+	friend inline T dot(const quat &lhs, const quat &rhs) { return lhs.dot(rhs); }
+
+
+	inline quat lerp(const quat &to, const T t) const { return ((*this) + t * (to - (*this))); }
+	friend inline quat lerp(const quat &from, const quat &to, const T t) { return from.lerp(to, t); }
+
+
+	// Normalized lerp along the shortest path. The angular velocity isn't constant
+	// like with slerp, but the result is close enough for most blending purposes.
+	quat nlerp(const quat &to, const T t) const
+	{
+		const T s = (dot(to) < T(0)) ? -t : t;
+
+		return quat(
+			this->x + s * to.x - t * this->x,
+			this->y + s * to.y - t * this->y,
+			this->z + s * to.z - t * this->z,
+			this->w + s * to.w - t * this->w
+		).normalize();
+	}
+	friend inline quat nlerp(const quat &from, const quat &to, const T t) { return from.nlerp(to, t); }
+
+
+	// Slerp along the shortest path, without any trigonometric functions. The sine
+	// ratios are approximated by a polynomial in t and cos(theta). For unit quaternions
+	// the error of each component stays below 4E-5. The error of the sine ratios peaks at
+	// 2.6E-5 for cos(theta) around 0.1, i.e. rotations around 170 degrees apart, and
+	// t around 0.5. It falls off quickly for rotations closer than 120 degrees apart,
+	// and also towards 180 degrees.
+	//
+	// Reference: Eberly, "A Fast and Accurate Algorithm for Computing SLERP" (2011)
+	quat slerpApprox(const quat &to, const T t) const
+	{
+		T cosTheta = dot(to);
+		T sign = T(1);
+
+		if (cosTheta < T(0))
+		{
+			cosTheta = -cosTheta;
+			sign = T(-1);
+		}
+
+		const T scale1 = sign * _slerpApproxCoefficient(t, cosTheta);
+		const T scale0 = _slerpApproxCoefficient(T(1) - t, cosTheta);
+
+		return quat(
+			scale0 * this->x + scale1 * to.x,
+			scale0 * this->y + scale1 * to.y,
+			scale0 * this->z + scale1 * to.z,
+			scale0 * this->w + scale1 * to.w
+		);
+	}
+	friend inline quat slerpApprox(const quat &from, const quat &to, const T t) { return from.slerpApprox(to, t); }
+
+	// Approximates sin(t * theta) / sin(theta), given cos(theta) in [0, 1]
+	static T _slerpApproxCoefficient(const T t, const T cosTheta)
+	{
+		// 1 + mu, with mu correcting the truncation of the series after 8 terms
+		const T onePlusMu = T(1.90110745351730037);
+
+		const T xm1 = cosTheta - T(1);
+		const T tt = t * t;
+
+		T c = T(1) + onePlusMu * (tt / T(8 * 17) - T(8) / T(17)) * xm1;
+
+		for (int i = 7; i >= 1; i--)
+			c = T(1) + (tt - T(i * i)) / T(i * (2 * i + 1)) * xm1 * c;
+
+		return t * c;
+	}
+
+
+	// Batch versions of nlerp() and slerpApprox(), blending count quaternions by t
+	static void nlerp(const quat *from, const quat *to, const T t, quat *result, const size_t count);
+	static void slerpApprox(const quat *from, const quat *to, const T t, quat *result, const size_t count);
+
+
+	inline quat slerp(const quat &to, const T t) const
 	{
 		const T EPSILON = T(1E-6f);
 
@@ -3965,10 +4873,10 @@ public:
 			if ((T(1) - cosom) > EPSILON)
 			{
 				// Standard case - slerp
-				omega = acosf(cosom);
-				sinom = sinf(omega);
-				scale0 = sinf((T(1) - t) * omega) / sinom;
-				scale1 = sinf(t * omega) / sinom;
+				omega = acos(cosom);
+				sinom = sin(omega);
+				scale0 = sin((T(1) - t) * omega) / sinom;
+				scale1 = sin(t * omega) / sinom;
 			}
 			else
 			{
@@ -3990,8 +4898,8 @@ public:
 			result.z = -b.w;
 			result.w = b.z;
 
-			scale0 = sinf((T(1) - t) - T(1.57079632679));
-			scale1 = sinf(t * T(1.57079632679));
+			scale0 = sin((T(1) - t) * T(LINALG_PI * 0.5));
+			scale1 = sin(t * T(LINALG_PI * 0.5));
 
 			result.x = scale0 * a.x + scale1 * result.x;
 			result.y = scale0 * a.y + scale1 * result.y;
@@ -4001,7 +4909,7 @@ public:
 
 		return result;
 	}
-	friend inline quat slerp(const quat &from, const quat &to, const T t) { return from.lerp(to, t); }
+	friend inline quat slerp(const quat &from, const quat &to, const T t) { return from.slerp(to, t); }
 
 
 	inline T getAngle() const
@@ -4038,707 +4946,5274 @@ public:
 };
 
 
-// It isn't an optimal solution, to inline all template functions that has explicit specialization.
-// But it is needed if we don't want to run into "multiple definitions" compilation error.
+// A dual quaternion (real + dual * epsilon) representing a rigid transformation,
+// i.e. a rotation followed by a translation. As opposed to a mat4 it only takes
+// 8 scalars, and blending several of them doesn't introduce the candy-wrapper
+// artifacts of linear blend skinning.
+//
+// Reference: Kavan et al., "Skinning with Dual Quaternions" (2007)
+template<typename T>
+class dualquat_t
+{
+private:
 
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
 
-#pragma region vec2
+	typedef vec4_t<unsigned int> uvec4;
 
-#pragma region Static Members
+	typedef mat3_t<T> mat3;
+	typedef mat4_t<T> mat4;
 
-template<typename T> const vec2_t<T> vec2_t<T>::zero = vec2_t<T>(T(0), T(0));
-template<typename T> const vec2_t<T> vec2_t<T>::one = vec2_t<T>(T(1), T(1));
+	typedef quat_t<T> quat;
+	typedef dualquat_t<T> dualquat;
 
-template<typename T> const vec2_t<T> vec2_t<T>::up = vec2_t<T>(T(0), T(1));
-template<typename T> const vec2_t<T> vec2_t<T>::down = vec2_t<T>(T(0), T(-1));
 
-template<typename T> const vec2_t<T> vec2_t<T>::left = vec2_t<T>(T(-1), T(0));
-template<typename T> const vec2_t<T> vec2_t<T>::right = vec2_t<T>(T(1), T(0));
+public:
 
-#pragma endregion
+	static const dualquat_t<T> zero;
+	static const dualquat_t<T> identity;
 
-#pragma region Constructors
 
-template<typename T>
-template<typename T2>
-vec2_t<T>::vec2_t(const vec3_t<T2> &v) : x(T(v.x)), y(T(v.y))
-{
+public:
 
-}
+	static inline dualquat translation(const vec3 &translation)
+	{
+		return dualquat(quat::identity, translation);
+	}
 
-template<typename T>
-template<typename T2>
-vec2_t<T>::vec2_t(const vec4_t<T2> &v) : x(T(v.x)), y(T(v.y))
-{
+	static inline dualquat rotation(const quat &rotation)
+	{
+		return dualquat(rotation, quat(T(0), T(0), T(0), T(0)));
+	}
 
-}
 
-#pragma endregion
+	// Only rigid transformations can be represented, so the matrix is
+	// expected to contain no scaling, skewing or projection.
+	static inline dualquat fromMat4(const mat4 &m)
+	{
+		return dualquat(quat::fromMat4(m), m.getTranslation());
+	}
 
-#pragma region Comparison Operators
 
-template<typename T> inline bool vec2_t<T>::operator==(const vec2 &rhs) const
-{
-	return ((this->x == rhs.x) && (this->y == rhs.y));
-}
+public:
 
-template<> inline bool fvec2::operator==(const fvec2 &rhs) const
-{
-	return (LINALG_FEQUAL(this->x, rhs.x) && LINALG_FEQUAL(this->y, rhs.y));
-}
+	quat real, dual;
 
-template<> inline bool dvec2::operator==(const dvec2 &rhs) const
-{
-	return (LINALG_DEQUAL(this->x, rhs.x) && LINALG_DEQUAL(this->y, rhs.y));
-}
 
-#pragma endregion
+public:
 
-#pragma region Normalize
+	dualquat_t() : real(T(0), T(0), T(0), T(0)), dual(T(0), T(0), T(0), T(0)) {}
 
-template<> inline fvec2 fvec2::normalize(const float &to) const
-{
+	dualquat_t(const dualquat_t<T> &dq) : real(dq.real), dual(dq.dual) {}
+	template<typename T2> dualquat_t(const dualquat_t<T2> &dq) : real(dq.real), dual(dq.dual) {}
+
+	dualquat_t(const quat &real, const quat &dual) : real(real), dual(dual) {}
+
+	// Rotation followed by translation, i.e. the same as (translation * rotation) as matrices
+	dualquat_t(const quat &rotation, const vec3 &translation) : real(rotation)
+	{
+		this->dual = quat(translation.x, translation.y, translation.z, T(0)) * rotation * T(0.5);
+	}
+
+	~dualquat_t() {}
+
+
+#pragma region Operator Overloading
+
+#pragma region Arithmetic Operators
+
+	dualquat operator+(const dualquat &rhs) const { return dualquat(this->real + rhs.real, this->dual + rhs.dual); }
+	dualquat operator-(const dualquat &rhs) const { return dualquat(this->real - rhs.real, this->dual - rhs.dual); }
+
+	// Combines the transformations, such that (a * b) applies b first then a
+	dualquat operator*(const dualquat &rhs) const
+	{
+		return dualquat(
+			this->real * rhs.real,
+			this->real * rhs.dual + this->dual * rhs.real
+		);
+	}
+
+	friend inline dualquat operator*(const dualquat &lhs, const T &rhs) { return dualquat(lhs.real * rhs, lhs.dual * rhs); }
+	friend inline dualquat operator*(const T &lhs, const dualquat &rhs) { return (rhs * lhs); }
+
+#pragma endregion
+#pragma region Assignment Operators
+
+	inline dualquat& operator+=(const dualquat &rhs) { return ((*this) = ((*this) + rhs)); }
+	inline dualquat& operator-=(const dualquat &rhs) { return ((*this) = ((*this) - rhs)); }
+	inline dualquat& operator*=(const dualquat &rhs) { return ((*this) = ((*this) * rhs)); }
+	inline dualquat& operator*=(const T &rhs) { return ((*this) = ((*this) * rhs)); }
+
+	dualquat& operator=(const dualquat &rhs)
+	{
+		this->real = rhs.real;
+		this->dual = rhs.dual;
+
+		return (*this);
+	}
+
+#pragma endregion
+
+#pragma region Stream Operators
+
+#ifdef _IOSTREAM_
+
+	friend inline std::ostream& operator<<(std::ostream &stream, const dualquat &rhs)
+	{
+		return (stream << "dualquat(" << rhs.real << ", " << rhs.dual << ")");
+	}
+
+	friend inline std::wostream& operator<<(std::wostream &stream, const dualquat &rhs)
+	{
+		return (stream << L"dualquat(" << rhs.real << L", " << rhs.dual << L")");
+	}
+
+#endif
+
+#pragma endregion
+
+#pragma endregion
+
+
+	// The conjugate of a unit dual quaternion is also its inverse
+	dualquat conjugate() const
+	{
+		return dualquat(this->real.conjugate(), this->dual.conjugate());
+	}
+	friend inline dualquat conjugate(const dualquat &dq) { return dq.conjugate(); }
+
+	inline dualquat inverse() const
+	{
+		return normalize().conjugate();
+	}
+	friend inline dualquat inverse(const dualquat &dq) { return dq.inverse(); }
+
+
+	// Scales the real part to unit length and removes the part of
+	// the dual part, which isn't orthogonal to the real part.
+	dualquat normalize() const
+	{
+		const T invLength = T(1) / sqrt(this->real.dot(this->real));
+
+		const quat r = this->real * invLength;
+		const quat d = this->dual * invLength;
+
+		return dualquat(r, d - r * r.dot(d));
+	}
+	friend inline dualquat normalize(const dualquat &dq) { return dq.normalize(); }
+
+
+	inline quat getRotation() const
+	{
+		return this->real;
+	}
+
+	// The translation is the vector part of (2 * dual * conjugate(real))
+	vec3 getTranslation() const
+	{
+		const quat &r = this->real;
+		const quat &d = this->dual;
+
+		return vec3(
+			T(2) * (r.w * d.x - d.w * r.x + r.y * d.z - r.z * d.y),
+			T(2) * (r.w * d.y - d.w * r.y + r.z * d.x - r.x * d.z),
+			T(2) * (r.w * d.z - d.w * r.z + r.x * d.y - r.y * d.x)
+		);
+	}
+
+
+	mat4 toMat4() const
+	{
+		mat4 m = mat4(this->real.toMat3());
+
+		const vec3 translation = getTranslation();
+		m[3] = vec4(translation.x, translation.y, translation.z, T(1));
+
+		return m;
+	}
+	friend inline mat4 toMat4(const dualquat &dq) { return dq.toMat4(); }
+
+
+	// Both of these expect the dual quaternion to be normalized
+
+	inline vec3 transformPoint(const vec3 &point) const
+	{
+		return this->real.rotate(point) + getTranslation();
+	}
+
+	inline vec3 transformNormal(const vec3 &normal) const
+	{
+		return this->real.rotate(normal);
+	}
+
+
+	// Dual quaternion linear blending, shortest path with regards to the first dual quaternion
+	static dualquat blend(const dualquat *dqs, const T *weights, const int count)
+	{
+		dualquat result(quat(T(0), T(0), T(0), T(0)), quat(T(0), T(0), T(0), T(0)));
+
+		for (int i = 0; i < count; i++)
+		{
+			const T weight = (dqs[i].real.dot(dqs[0].real) < T(0)) ? -weights[i] : weights[i];
+
+			result.real += dqs[i].real * weight;
+			result.dual += dqs[i].dual * weight;
+		}
+
+		return result.normalize();
+	}
+
+	// Blends the (up to) 4 bones of the palette influencing a single vertex
+	static inline dualquat blend(const dualquat *palette, const uvec4 &boneIndices, const vec4 &boneWeights)
+	{
+		const dualquat bones[4] = {
+			palette[boneIndices.x], palette[boneIndices.y],
+			palette[boneIndices.z], palette[boneIndices.w]
+		};
+
+		const T weights[4] = { boneWeights.x, boneWeights.y, boneWeights.z, boneWeights.w };
+
+		return blend(bones, weights, 4);
+	}
+
+
+	// Skins count vertices, each influenced by up to 4 bones from the palette. Unused
+	// influences must have a weight of 0 and still a valid index (e.g. 0).
+	// Normals are optional, pass nullptr for both normals and skinnedNormals to skip them.
+	static void skin(
+		const dualquat *palette,
+		const uvec4 *boneIndices, const vec4 *boneWeights,
+		const vec3 *positions, const vec3 *normals,
+		vec3 *skinnedPositions, vec3 *skinnedNormals,
+		const size_t count);
+
+
+	inline void swap(dualquat &other)
+	{
+		const dualquat tmp(*this);
+		(*this) = other;
+		other = tmp;
+	}
+	friend inline void swap(dualquat &a, dualquat &b) { a.swap(b); }
+};
+
+
+// Axis-aligned bounding box
+template<typename T>
+class aabb_t
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+
+	typedef mat4_t<T> mat4;
+	typedef affine_t<T> affine;
+
+	typedef aabb_t<T> aabb;
+
+
+public:
+
+	// An inverted box, such that merging anything into it results in that
+	static const aabb_t<T> empty;
+
+
+public:
+
+	vec3 min, max;
+
+
+public:
+
+	aabb_t() : min(T(0)), max(T(0)) {}
+
+	aabb_t(const aabb_t<T> &box) : min(box.min), max(box.max) {}
+	template<typename T2> aabb_t(const aabb_t<T2> &box) : min(box.min), max(box.max) {}
+
+	aabb_t(const vec3 &min, const vec3 &max) : min(min), max(max) {}
+
+	// Computes the bounds of count points
+	aabb_t(const vec3 *points, const size_t count) : min(empty.min), max(empty.max)
+	{
+		for (size_t i = 0; i < count; i++)
+			merge(points[i]);
+	}
+
+	~aabb_t() {}
+
+
+	aabb& operator=(const aabb &rhs)
+	{
+		this->min = rhs.min;
+		this->max = rhs.max;
+
+		return (*this);
+	}
+
+
+	inline vec3 center() const { return (this->min + this->max) * T(0.5); }
+
+	// Half the size along each axis
+	inline vec3 extents() const { return (this->max - this->min) * T(0.5); }
+
+	inline vec3 size() const { return (this->max - this->min); }
+
+	inline bool isEmpty() const { return ((this->min.x > this->max.x) || (this->min.y > this->max.y) || (this->min.z > this->max.z)); }
+
+	inline T surfaceArea() const
+	{
+		const vec3 d = size();
+		return T(2) * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+
+
+	inline bool contains(const vec3 &point) const
+	{
+		return ((point.x >= this->min.x) && (point.x <= this->max.x) &&
+		        (point.y >= this->min.y) && (point.y <= this->max.y) &&
+		        (point.z >= this->min.z) && (point.z <= this->max.z));
+	}
+
+	inline bool contains(const aabb &box) const
+	{
+		return (contains(box.min) && contains(box.max));
+	}
+
+	inline bool intersects(const aabb &box) const
+	{
+		return ((this->min.x <= box.max.x) && (this->max.x >= box.min.x) &&
+		        (this->min.y <= box.max.y) && (this->max.y >= box.min.y) &&
+		        (this->min.z <= box.max.z) && (this->max.z >= box.min.z));
+	}
+	friend inline bool intersects(const aabb &a, const aabb &b) { return a.intersects(b); }
+
+
+	// Merging is done per component, as it is the inner loop of building hierarchies
+
+	inline aabb& merge(const vec3 &point)
+	{
+		return merge(point, point);
+	}
+
+	inline aabb& merge(const aabb &box)
+	{
+		return merge(box.min, box.max);
+	}
+
+	inline aabb& merge(const vec3 &min, const vec3 &max)
+	{
+		this->min.x = (min.x < this->min.x) ? min.x : this->min.x;
+		this->min.y = (min.y < this->min.y) ? min.y : this->min.y;
+		this->min.z = (min.z < this->min.z) ? min.z : this->min.z;
+
+		this->max.x = (max.x > this->max.x) ? max.x : this->max.x;
+		this->max.y = (max.y > this->max.y) ? max.y : this->max.y;
+		this->max.z = (max.z > this->max.z) ? max.z : this->max.z;
+
+		return (*this);
+	}
+	friend inline aabb merge(const aabb &a, const aabb &b) { return aabb(a).merge(b); }
+
+
+	// Transforms the box and returns the axis-aligned box enclosing the result. Instead
+	// of transforming all 8 corners, the center is transformed and the extents are
+	// transformed by the absolute values of the upper 3x3 part of the matrix.
+	//
+	// Reference: Arvo, "Transforming Axis-Aligned Bounding Boxes" (Graphics Gems, 1990)
+	aabb transform(const mat4 &m) const
+	{
+		const vec3 c = center();
+		const vec3 e = extents();
+
+		const vec3 newCenter(
+			m[0].x * c.x + m[1].x * c.y + m[2].x * c.z + m[3].x,
+			m[0].y * c.x + m[1].y * c.y + m[2].y * c.z + m[3].y,
+			m[0].z * c.x + m[1].z * c.y + m[2].z * c.z + m[3].z);
+
+		const vec3 newExtents(
+			fabs(m[0].x) * e.x + fabs(m[1].x) * e.y + fabs(m[2].x) * e.z,
+			fabs(m[0].y) * e.x + fabs(m[1].y) * e.y + fabs(m[2].y) * e.z,
+			fabs(m[0].z) * e.x + fabs(m[1].z) * e.y + fabs(m[2].z) * e.z);
+
+		return aabb(newCenter - newExtents, newCenter + newExtents);
+	}
+	friend inline aabb transform(const aabb &box, const mat4 &m) { return box.transform(m); }
+
+	aabb transform(const affine &m) const
+	{
+		const vec3 c = center();
+		const vec3 e = extents();
+
+		const vec3 newCenter = m.transformPoint(c);
+
+		const vec3 newExtents(
+			fabs(m[0].x) * e.x + fabs(m[0].y) * e.y + fabs(m[0].z) * e.z,
+			fabs(m[1].x) * e.x + fabs(m[1].y) * e.y + fabs(m[1].z) * e.z,
+			fabs(m[2].x) * e.x + fabs(m[2].y) * e.y + fabs(m[2].z) * e.z);
+
+		return aabb(newCenter - newExtents, newCenter + newExtents);
+	}
+	friend inline aabb transform(const aabb &box, const affine &m) { return box.transform(m); }
+
+
+	// Transforms each of the count boxes by its respective matrix
+	static void transform(const aabb *boxes, const mat4 *matrices, aabb *result, const size_t count);
+
+	// Same as above, but writes the result as a structure of arrays, as consumed by frustum_t::cullAABBs()
+	static void transform(
+		const aabb *boxes, const mat4 *matrices,
+		T *minX, T *minY, T *minZ,
+		T *maxX, T *maxY, T *maxZ,
+		const size_t count);
+};
+
+
+// Bounding sphere
+template<typename T>
+class sphere_t
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+
+	typedef mat4_t<T> mat4;
+
+	typedef aabb_t<T> aabb;
+	typedef sphere_t<T> sphere;
+
+
+public:
+
+	vec3 center;
+	T radius;
+
+
+public:
+
+	sphere_t() : center(T(0)), radius(T(0)) {}
+
+	sphere_t(const sphere_t<T> &s) : center(s.center), radius(s.radius) {}
+	template<typename T2> sphere_t(const sphere_t<T2> &s) : center(s.center), radius(T(s.radius)) {}
+
+	sphere_t(const vec3 &center, const T radius) : center(center), radius(radius) {}
+
+	// The sphere enclosing the box
+	explicit sphere_t(const aabb &box) : center(box.center()), radius(box.extents().length()) {}
+
+	~sphere_t() {}
+
+
+	sphere& operator=(const sphere &rhs)
+	{
+		this->center = rhs.center;
+		this->radius = rhs.radius;
+
+		return (*this);
+	}
+
+
+	inline bool contains(const vec3 &point) const
+	{
+		return ((point - this->center).lengthSquared() <= (this->radius * this->radius));
+	}
+
+	inline bool contains(const sphere &s) const
+	{
+		const T r = this->radius - s.radius;
+		return ((r >= T(0)) && ((s.center - this->center).lengthSquared() <= (r * r)));
+	}
+
+	inline bool intersects(const sphere &s) const
+	{
+		const T r = this->radius + s.radius;
+		return ((s.center - this->center).lengthSquared() <= (r * r));
+	}
+	friend inline bool intersects(const sphere &a, const sphere &b) { return a.intersects(b); }
+
+	inline bool intersects(const aabb &box) const
+	{
+		const vec3 closest = this->center.clamp(box.min, box.max);
+		return ((closest - this->center).lengthSquared() <= (this->radius * this->radius));
+	}
+
+
+	// Grows the sphere to enclose both spheres
+	sphere& merge(const sphere &s)
+	{
+		const vec3 d = s.center - this->center;
+		const T distance = d.length();
+
+		if ((distance + s.radius) <= this->radius)
+			return (*this);
+
+		if ((distance + this->radius) <= s.radius)
+			return ((*this) = s);
+
+		const T newRadius = (distance + this->radius + s.radius) * T(0.5);
+
+		this->center = this->center + d * ((newRadius - this->radius) / distance);
+		this->radius = newRadius;
+
+		return (*this);
+	}
+	friend inline sphere merge(const sphere &a, const sphere &b) { return sphere(a).merge(b); }
+
+	inline aabb toAABB() const
+	{
+		return aabb(this->center - this->radius, this->center + this->radius);
+	}
+
+
+	// The radius is scaled by the largest scaling of the matrix
+	sphere transform(const mat4 &m) const
+	{
+		const vec3 newCenter(
+			m[0].x * this->center.x + m[1].x * this->center.y + m[2].x * this->center.z + m[3].x,
+			m[0].y * this->center.x + m[1].y * this->center.y + m[2].y * this->center.z + m[3].y,
+			m[0].z * this->center.x + m[1].z * this->center.y + m[2].z * this->center.z + m[3].z);
+
+		const T sx = vec3(m[0]).lengthSquared();
+		const T sy = vec3(m[1]).lengthSquared();
+		const T sz = vec3(m[2]).lengthSquared();
+
+		const T maxScale = ((sx > sy) ? ((sx > sz) ? sx : sz) : ((sy > sz) ? sy : sz));
+
+		return sphere(newCenter, this->radius * sqrt(maxScale));
+	}
+	friend inline sphere transform(const sphere &s, const mat4 &m) { return s.transform(m); }
+
+
+	// Transforms each of the count spheres by its respective matrix
+	static void transform(const sphere *spheres, const mat4 *matrices, sphere *result, const size_t count);
+
+	// Same as above, but writes the result as a structure of arrays, as consumed by frustum_t::cullSpheres()
+	static void transform(
+		const sphere *spheres, const mat4 *matrices,
+		T *centerX, T *centerY, T *centerZ, T *radius,
+		const size_t count);
+};
+
+
+// Oriented bounding box
+template<typename T>
+class obb_t
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+
+	typedef mat3_t<T> mat3;
+	typedef mat4_t<T> mat4;
+
+	typedef aabb_t<T> aabb;
+	typedef obb_t<T> obb;
+
+
+public:
+
+	vec3 center;
+
+	// Unit length axes, the columns of the box's rotation matrix
+	vec3 axes[3];
+
+	// Half the size along each axis
+	vec3 extents;
+
+
+public:
+
+	obb_t() : center(T(0)), extents(T(0))
+	{
+		this->axes[0] = vec3(T(1), T(0), T(0));
+		this->axes[1] = vec3(T(0), T(1), T(0));
+		this->axes[2] = vec3(T(0), T(0), T(1));
+	}
+
+	obb_t(const vec3 &center, const mat3 &rotation, const vec3 &extents) : center(center), extents(extents)
+	{
+		this->axes[0] = rotation[0];
+		this->axes[1] = rotation[1];
+		this->axes[2] = rotation[2];
+	}
+
+	explicit obb_t(const aabb &box) : center(box.center()), extents(box.extents())
+	{
+		this->axes[0] = vec3(T(1), T(0), T(0));
+		this->axes[1] = vec3(T(0), T(1), T(0));
+		this->axes[2] = vec3(T(0), T(0), T(1));
+	}
+
+	// The box transformed by the matrix, which may contain scaling but not skewing
+	obb_t(const aabb &box, const mat4 &m)
+	{
+		const vec3 c = box.center();
+		const vec3 e = box.extents();
+
+		this->center = vec3(m * vec4(c.x, c.y, c.z, T(1)));
+
+		for (int i = 0; i < 3; i++)
+		{
+			const vec3 axis = vec3(m[i]);
+			const T scale = axis.length();
+
+			this->axes[i] = (scale > T(0)) ? (axis / scale) : axis;
+			this->extents[i] = e[i] * scale;
+		}
+	}
+
+	~obb_t() {}
+
+
+	obb& operator=(const obb &rhs)
+	{
+		this->center = rhs.center;
+		this->axes[0] = rhs.axes[0];
+		this->axes[1] = rhs.axes[1];
+		this->axes[2] = rhs.axes[2];
+		this->extents = rhs.extents;
+
+		return (*this);
+	}
+
+
+	bool contains(const vec3 &point) const
+	{
+		const vec3 d = point - this->center;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const T projected = d.dot(this->axes[i]);
+
+			if ((projected > this->extents[i]) || (projected < -this->extents[i]))
+				return false;
+		}
+
+		return true;
+	}
+
+
+	aabb toAABB() const
+	{
+		const vec3 e(
+			fabs(this->axes[0].x) * this->extents.x + fabs(this->axes[1].x) * this->extents.y + fabs(this->axes[2].x) * this->extents.z,
+			fabs(this->axes[0].y) * this->extents.x + fabs(this->axes[1].y) * this->extents.y + fabs(this->axes[2].y) * this->extents.z,
+			fabs(this->axes[0].z) * this->extents.x + fabs(this->axes[1].z) * this->extents.y + fabs(this->axes[2].z) * this->extents.z);
+
+		return aabb(this->center - e, this->center + e);
+	}
+
+	inline mat3 rotation() const
+	{
+		return mat3(this->axes[0], this->axes[1], this->axes[2]);
+	}
+};
+
+
+// A view frustum represented by 6 planes, each stored as vec4(normal, distance)
+// with the normals pointing inwards, such that dot(normal, p) + distance >= 0 for
+// any point p inside. The planes are normalized, so that value is the actual
+// signed distance to the plane.
+//
+// Reference: Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix" (2001)
+template<typename T>
+class frustum_t
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+
+	typedef mat4_t<T> mat4;
+
+	typedef frustum_t<T> frustum;
+
+
+public:
+
+	enum Plane
+	{
+		Left, Right,
+		Bottom, Top,
+		Near, Far,
+
+		PlaneCount
+	};
+
+
+public:
+
+	vec4 planes[PlaneCount];
+
+
+public:
+
+	frustum_t() {}
+
+	// Extracts the planes from a projection matrix (then the planes are in view space),
+	// a view-projection matrix (world space) or a model-view-projection matrix (object space).
+	// The depth range is that of the projection, see mat4_t::DepthRange. The far plane of an
+	// infinite projection is at infinity, and is kept as a plane every point is in front of.
+	frustum_t(const mat4 &m, const typename mat4::DepthRange depthRange = mat4::NegativeOneToOne)
+	{
+		const vec4 row0 = m.row(0);
+		const vec4 row1 = m.row(1);
+		const vec4 row2 = m.row(2);
+		const vec4 row3 = m.row(3);
+
+		this->planes[Left] = row3 + row0;
+		this->planes[Right] = row3 - row0;
+		this->planes[Bottom] = row3 + row1;
+		this->planes[Top] = row3 - row1;
+
+		switch (depthRange)
+		{
+		case mat4::ZeroToOne:
+			this->planes[Near] = row2;
+			this->planes[Far] = row3 - row2;
+			break;
+		case mat4::OneToZero:
+			this->planes[Near] = row3 - row2;
+			this->planes[Far] = row2;
+			break;
+		default:
+			this->planes[Near] = row3 + row2;
+			this->planes[Far] = row3 - row2;
+			break;
+		}
+
+		for (int i = 0; i < PlaneCount; i++)
+		{
+			const vec4 &plane = this->planes[i];
+			const T lengthSquared = plane.x * plane.x + plane.y * plane.y + plane.z * plane.z;
+
+			this->planes[i] = (lengthSquared > T(0)) ? (plane * (T(1) / sqrt(lengthSquared))) : vec4(T(0), T(0), T(0), T(1));
+		}
+	}
+
+	~frustum_t() {}
+
+
+	inline vec4& operator[](const int index) { return this->planes[index]; }
+	inline vec4 operator[](const int index) const { return this->planes[index]; }
+
+
+	static inline T distance(const vec4 &plane, const vec3 &point)
+	{
+		return (plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w);
+	}
+
+
+	bool contains(const vec3 &point) const
+	{
+		for (int i = 0; i < PlaneCount; i++)
+			if (distance(this->planes[i], point) < T(0))
+				return false;
+
+		return true;
+	}
+
+	// Spheres intersecting the frustum are considered visible
+	bool intersectsSphere(const vec3 &center, const T radius) const
+	{
+		for (int i = 0; i < PlaneCount; i++)
+			if (distance(this->planes[i], center) < -radius)
+				return false;
+
+		return true;
+	}
+
+	// Boxes intersecting the frustum are considered visible. For each plane only
+	// the corner furthest along the plane normal is tested. Large boxes near the
+	// frustum corners can be falsely reported as visible.
+	bool intersectsAABB(const vec3 &min, const vec3 &max) const
+	{
+		for (int i = 0; i < PlaneCount; i++)
+		{
+			const vec4 &plane = this->planes[i];
+
+			const vec3 corner(
+				(plane.x > T(0)) ? max.x : min.x,
+				(plane.y > T(0)) ? max.y : min.y,
+				(plane.z > T(0)) ? max.z : min.z);
+
+			if (distance(plane, corner) < T(0))
+				return false;
+		}
+
+		return true;
+	}
+
+
+	inline bool intersects(const sphere_t<T> &s) const { return intersectsSphere(s.center, s.radius); }
+	inline bool intersects(const aabb_t<T> &box) const { return intersectsAABB(box.min, box.max); }
+
+
+	// The batch functions take the bounds as a structure of arrays. The visibility is
+	// written as a bitmask, where bit (i % 8) of visibility[i / 8] is set if object i
+	// is visible, so visibility must hold (count + 7) / 8 bytes.
+
+	void cullSpheres(
+		const T *centerX, const T *centerY, const T *centerZ, const T *radius,
+		const size_t count, unsigned char *visibility) const;
+
+	void cullAABBs(
+		const T *minX, const T *minY, const T *minZ,
+		const T *maxX, const T *maxY, const T *maxZ,
+		const size_t count, unsigned char *visibility) const;
+
+
+	// Writes the indices of the visible objects to visibleIndices,
+	// which must hold count indices, and returns the amount written.
+
+	size_t cullSpheres(
+		const T *centerX, const T *centerY, const T *centerZ, const T *radius,
+		const size_t count, unsigned int *visibleIndices) const;
+
+	size_t cullAABBs(
+		const T *minX, const T *minY, const T *minZ,
+		const T *maxX, const T *maxY, const T *maxZ,
+		const size_t count, unsigned int *visibleIndices) const;
+
+
+	// Turns a visibility bitmask into a list of indices of the set bits,
+	// and returns the amount written
+	static size_t compact(const unsigned char *visibility, const size_t count, unsigned int *visibleIndices)
+	{
+		size_t visibleCount = 0;
+
+		for (size_t i = 0; i < count; i += 8)
+		{
+			unsigned int bits = visibility[i / 8];
+
+			for (size_t j = i; bits && (j < count); j++, bits >>= 1)
+				if (bits & 1u)
+					visibleIndices[visibleCount++] = static_cast<unsigned int>(j);
+		}
+
+		return visibleCount;
+	}
+};
+
+
+
+// A ray starting at origin going along direction. The direction doesn't need to be
+// normalized, the intersection distances are then in units of the direction's length.
+template<typename T>
+class ray_t
+{
+private:
+
+	typedef vec2_t<T> vec2;
+	typedef vec3_t<T> vec3;
+
+	typedef vec4_t<T> vec4;
+
+	typedef vec4_t<signed int> ivec4;
+
+	typedef mat4_t<T> mat4;
+
+	typedef aabb_t<T> aabb;
+	typedef sphere_t<T> sphere;
+
+	typedef ray_t<T> ray;
+
+	typedef typename mat4::DepthRange DepthRange;
+
+
+public:
+
+	vec3 origin, direction;
+
+
+public:
+
+	ray_t() : origin(T(0)), direction(T(0), T(0), T(-1)) {}
+
+	ray_t(const ray_t<T> &r) : origin(r.origin), direction(r.direction) {}
+	template<typename T2> ray_t(const ray_t<T2> &r) : origin(r.origin), direction(r.direction) {}
+
+	ray_t(const vec3 &origin, const vec3 &direction) : origin(origin), direction(direction) {}
+
+	~ray_t() {}
+
+
+	ray& operator=(const ray &rhs)
+	{
+		this->origin = rhs.origin;
+		this->direction = rhs.direction;
+
+		return (*this);
+	}
+
+
+	// The ray from the near plane through the far plane at a window position,
+	// with a normalized direction. See mat4_t::unproject() and mat4_t::DepthRange.
+	static inline ray fromScreen(const vec2 &window, const mat4 &viewProjection, const ivec4 &viewport, const DepthRange depthRange = mat4::NegativeOneToOne)
+	{
+		const vec2 ndc(
+			(window.x - T(viewport.x)) / T(viewport.z) * T(2) - T(1),
+			(window.y - T(viewport.y)) / T(viewport.w) * T(2) - T(1));
+
+		return fromNDC(ndc, mat4(viewProjection).inverse(), depthRange);
+	}
+
+	static inline ray fromScreen(const vec2 &window, const mat4 &view, const mat4 &projection, const ivec4 &viewport, const DepthRange depthRange = mat4::NegativeOneToOne)
+	{
+		return fromScreen(window, (projection * view), viewport, depthRange);
+	}
+
+	// The ray from the near plane through normalized device coordinates, given the inverse view-projection
+	static ray fromNDC(const vec2 &ndc, const mat4 &inverseViewProjection, const DepthRange depthRange = mat4::NegativeOneToOne)
+	{
+		const T nearDepth = (depthRange == mat4::NegativeOneToOne) ? T(-1) : ((depthRange == mat4::ZeroToOne) ? T(0) : T(1));
+		const T farDepth = (depthRange == mat4::OneToZero) ? T(0) : T(1);
+
+		const vec4 nearPoint = inverseViewProjection * vec4(ndc.x, ndc.y, nearDepth, T(1));
+		const vec4 farPoint = inverseViewProjection * vec4(ndc.x, ndc.y, farDepth, T(1));
+
+		const vec3 origin = vec3(nearPoint.x, nearPoint.y, nearPoint.z) / nearPoint.w;
+
+		// Scaled by the far point's w, which is 0 for infinite projections, where its xyz is then the direction
+		const vec3 direction = vec3(farPoint.x, farPoint.y, farPoint.z) - origin * farPoint.w;
+
+		return ray(origin, direction.normalize());
+	}
+
+
+	inline vec3 at(const T distance) const { return (this->origin + this->direction * distance); }
+
+
+	// Slab test. The distance is 0 if the origin is inside the box.
+	bool intersects(const aabb &box, T &distance) const
+	{
+		T tNear = T(0), tFar = T(HUGE_VAL);
+
+		for (int i = 0; i < 3; i++)
+		{
+			const T invDirection = T(1) / this->direction[i];
+
+			T t1 = (box.min[i] - this->origin[i]) * invDirection;
+			T t2 = (box.max[i] - this->origin[i]) * invDirection;
+
+			if (t1 > t2)
+			{
+				const T temp = t1;
+				t1 = t2;
+				t2 = temp;
+			}
+
+			tNear = (t1 > tNear) ? t1 : tNear;
+			tFar = (t2 < tFar) ? t2 : tFar;
+		}
+
+		distance = tNear;
+
+		return (tNear <= tFar);
+	}
+
+	// The distance is to where the ray exits the sphere, if the origin is inside it
+	bool intersects(const sphere &s, T &distance) const
+	{
+		const vec3 oc = s.center - this->origin;
+
+		const T a = this->direction.lengthSquared();
+		const T b = this->direction.dot(oc);
+		const T c = oc.lengthSquared() - s.radius * s.radius;
+
+		const T discriminant = b * b - a * c;
+
+		if (discriminant < T(0))
+			return false;
+
+		const T root = sqrt(discriminant);
+
+		distance = (b - root) / a;
+
+		if (distance < T(0))
+			distance = (b + root) / a;
+
+		return (distance >= T(0));
+	}
+
+	// Moller-Trumbore, where both sides of the triangle are hit. The hit point
+	// is v0 * (1 - u - v) + v1 * u + v2 * v.
+	//
+	// Reference: Moller & Trumbore, "Fast, Minimum Storage Ray/Triangle Intersection" (1997)
+	bool intersects(const vec3 &v0, const vec3 &v1, const vec3 &v2, T &distance, T &u, T &v) const
+	{
+		const vec3 edge1 = v1 - v0;
+		const vec3 edge2 = v2 - v0;
+
+		const vec3 p = this->direction.cross(edge2);
+		const T det = edge1.dot(p);
+
+		if (det == T(0))
+			return false;
+
+		const T invDet = T(1) / det;
+
+		const vec3 s = this->origin - v0;
+		u = s.dot(p) * invDet;
+
+		if ((u < T(0)) || (u > T(1)))
+			return false;
+
+		const vec3 q = s.cross(edge1);
+		v = this->direction.dot(q) * invDet;
+
+		if ((v < T(0)) || ((u + v) > T(1)))
+			return false;
+
+		distance = edge2.dot(q) * invDet;
+
+		return (distance >= T(0));
+	}
+
+
+	// The batch functions take the shapes as a structure of arrays, and find the nearest
+	// one hit closer than maxDistance. If one is hit its index and distance are written
+	// and true is returned, otherwise index and distance are left unchanged.
+
+	bool intersectAABBs(
+		const T *minX, const T *minY, const T *minZ,
+		const T *maxX, const T *maxY, const T *maxZ,
+		const size_t count, size_t &index, T &distance, const T maxDistance = T(HUGE_VAL)) const;
+
+	bool intersectSpheres(
+		const T *centerX, const T *centerY, const T *centerZ, const T *radius,
+		const size_t count, size_t &index, T &distance, const T maxDistance = T(HUGE_VAL)) const;
+
+	// The barycentric coordinates of the nearest hit are written to u and v
+	bool intersectTriangles(
+		const T *v0X, const T *v0Y, const T *v0Z,
+		const T *v1X, const T *v1Y, const T *v1Z,
+		const T *v2X, const T *v2Y, const T *v2Z,
+		const size_t count, size_t &index, T &distance, T &u, T &v, const T maxDistance = T(HUGE_VAL)) const;
+};
+
+
+// A perspective camera looking from eye at target, which caches its view and projection
+// matrices, their product, the inverses of all three and the frustum. Changing a parameter
+// only marks what depends on it as out of date, which is then recomputed on first use.
+//
+// The getters update the cache, so a camera shared between threads should be update()d
+// once after changing it, after which the getters only read.
+template<typename T>
+class camera_t
+{
+private:
+
+	typedef vec2_t<T> vec2;
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+
+	typedef vec4_t<signed int> ivec4;
+
+	typedef mat4_t<T> mat4;
+
+	typedef frustum_t<T> frustum;
+	typedef ray_t<T> ray;
+
+	typedef typename mat4::DepthRange DepthRange;
+
+
+	enum Cache
+	{
+		View = 1 << 0,
+		Projection = 1 << 1,
+		ViewProjection = 1 << 2,
+		InverseView = 1 << 3,
+		InverseProjection = 1 << 4,
+		InverseViewProjection = 1 << 5,
+		Frustum = 1 << 6,
+
+		// What's out of date after changing the view or projection respectively
+		ViewDependent = View | ViewProjection | InverseView | InverseViewProjection | Frustum,
+		ProjectionDependent = Projection | ViewProjection | InverseProjection | InverseViewProjection | Frustum,
+
+		All = ViewDependent | ProjectionDependent
+	};
+
+
+public:
+
+	camera_t() :
+		eye(T(0)), target(T(0), T(0), T(-1)), up(vec3::up),
+		fov(T(60)), zNear(T(0.1)), zFar(T(1000)), viewport(0, 0, 1, 1),
+		depthRange(mat4::NegativeOneToOne), infiniteFar(false),
+		outdated(All) {}
+
+	// The fov is vertical and in degrees, as for mat4_t::perspective(), the aspect ratio follows the viewport
+	camera_t(const vec3 &eye, const vec3 &target, const vec3 &up, const T fov, const T zNear, const T zFar, const ivec4 &viewport) :
+		eye(eye), target(target), up(up),
+		fov(fov), zNear(zNear), zFar(zFar), viewport(viewport),
+		depthRange(mat4::NegativeOneToOne), infiniteFar(false),
+		outdated(All) {}
+
+	~camera_t() {}
+
+
+	inline const vec3& getEye() const { return this->eye; }
+	inline const vec3& getTarget() const { return this->target; }
+	inline const vec3& getUp() const { return this->up; }
+
+	inline T getFov() const { return this->fov; }
+	inline T getNear() const { return this->zNear; }
+	inline T getFar() const { return this->zFar; }
+
+	inline const ivec4& getViewport() const { return this->viewport; }
+	inline T getAspect() const { return T(this->viewport.z) / T(this->viewport.w); }
+
+	inline DepthRange getDepthRange() const { return this->depthRange; }
+	inline bool isInfiniteFar() const { return this->infiniteFar; }
+
+	inline vec3 getForward() const { return normalize(this->target - this->eye); }
+
+
+	inline void setEye(const vec3 &eye) { this->eye = eye; this->outdated |= ViewDependent; }
+	inline void setTarget(const vec3 &target) { this->target = target; this->outdated |= ViewDependent; }
+	inline void setUp(const vec3 &up) { this->up = up; this->outdated |= ViewDependent; }
+
+	inline void lookAt(const vec3 &eye, const vec3 &target, const vec3 &up = vec3::up)
+	{
+		this->eye = eye;
+		this->target = target;
+		this->up = up;
+
+		this->outdated |= ViewDependent;
+	}
+
+	inline void setFov(const T fov) { this->fov = fov; this->outdated |= ProjectionDependent; }
+
+	inline void setClipPlanes(const T zNear, const T zFar)
+	{
+		this->zNear = zNear;
+		this->zFar = zFar;
+
+		this->outdated |= ProjectionDependent;
+	}
+
+	// Selects the perspective() variant, where OneToZero is reverse-Z and an infinite far plane ignores zFar
+	inline void setDepth(const DepthRange depthRange, const bool infiniteFar = false)
+	{
+		this->depthRange = depthRange;
+		this->infiniteFar = infiniteFar;
+
+		this->outdated |= ProjectionDependent;
+	}
+
+	// The projection only depends on the aspect ratio of the viewport
+	inline void setViewport(const ivec4 &viewport)
+	{
+		if ((this->viewport.z * viewport.w) != (this->viewport.w * viewport.z))
+			this->outdated |= ProjectionDependent;
+
+		this->viewport = viewport;
+	}
+
+
+	// Recomputes everything that's out of date
+	void update() const
+	{
+		getFrustum();
+		getInverseViewProjection();
+	}
+
+
+	const mat4& getView() const
+	{
+		if (this->outdated & View)
+		{
+			this->view = mat4::lookAt(this->eye, this->target, this->up);
+			this->outdated &= ~View;
+		}
+
+		return this->view;
+	}
+
+	const mat4& getProjection() const
+	{
+		if (this->outdated & Projection)
+		{
+			const T aspect = getAspect();
+
+			switch (this->depthRange)
+			{
+			case mat4::ZeroToOne:
+				this->projection = this->infiniteFar ? mat4::perspectiveInfiniteZO(this->fov, aspect, this->zNear) : mat4::perspectiveZO(this->fov, aspect, this->zNear, this->zFar);
+				break;
+			case mat4::OneToZero:
+				this->projection = this->infiniteFar ? mat4::perspectiveInfiniteReverseZ(this->fov, aspect, this->zNear) : mat4::perspectiveReverseZ(this->fov, aspect, this->zNear, this->zFar);
+				break;
+			default:
+				this->projection = this->infiniteFar ? mat4::perspectiveInfinite(this->fov, aspect, this->zNear) : mat4::perspective(this->fov, aspect, this->zNear, this->zFar);
+				break;
+			}
+
+			this->outdated &= ~Projection;
+		}
+
+		return this->projection;
+	}
+
+	const mat4& getViewProjection() const
+	{
+		if (this->outdated & ViewProjection)
+		{
+			this->viewProjection = getProjection() * getView();
+			this->outdated &= ~ViewProjection;
+		}
+
+		return this->viewProjection;
+	}
+
+	// The view is a rigid transformation, so its inverse is the transposed rotation and the eye
+	const mat4& getInverseView() const
+	{
+		if (this->outdated & InverseView)
+		{
+			const mat4 &view = getView();
+
+			this->inverseView = mat4(
+				vec4(view[0].x, view[1].x, view[2].x, T(0)),
+				vec4(view[0].y, view[1].y, view[2].y, T(0)),
+				vec4(view[0].z, view[1].z, view[2].z, T(0)),
+				vec4(this->eye, T(1)));
+
+			this->outdated &= ~InverseView;
+		}
+
+		return this->inverseView;
+	}
+
+	const mat4& getInverseProjection() const
+	{
+		if (this->outdated & InverseProjection)
+		{
+			this->inverseProjection = mat4::inversePerspective(getProjection());
+			this->outdated &= ~InverseProjection;
+		}
+
+		return this->inverseProjection;
+	}
+
+	const mat4& getInverseViewProjection() const
+	{
+		if (this->outdated & InverseViewProjection)
+		{
+			this->inverseViewProjection = getInverseView() * getInverseProjection();
+			this->outdated &= ~InverseViewProjection;
+		}
+
+		return this->inverseViewProjection;
+	}
+
+	// The frustum planes in world space
+	const frustum& getFrustum() const
+	{
+		if (this->outdated & Frustum)
+		{
+			this->planes = frustum(getViewProjection(), this->depthRange);
+			this->outdated &= ~Frustum;
+		}
+
+		return this->planes;
+	}
+
+
+	// Same as mat4_t::project() and mat4_t::unproject(), without multiplying or inverting the matrices
+
+	vec3 project(const vec3 &object) const
+	{
+		const vec4 clip = getViewProjection() * vec4(object, T(1));
+
+		if (clip.w == T(0))
+			return vec3(T(0));
+
+		const T invW = T(1) / clip.w;
+
+		return vec3(
+			(clip.x * invW * T(0.5) + T(0.5)) * T(this->viewport.z) + T(this->viewport.x),
+			(clip.y * invW * T(0.5) + T(0.5)) * T(this->viewport.w) + T(this->viewport.y),
+			(this->depthRange == mat4::NegativeOneToOne) ? ((clip.z * invW + T(1)) * T(0.5)) : (clip.z * invW));
+	}
+
+	vec3 unproject(const vec3 &window) const
+	{
+		const vec4 ndc(
+			(window.x - T(this->viewport.x)) / T(this->viewport.z) * T(2) - T(1),
+			(window.y - T(this->viewport.y)) / T(this->viewport.w) * T(2) - T(1),
+			(this->depthRange == mat4::NegativeOneToOne) ? (window.z * T(2) - T(1)) : window.z,
+			T(1));
+
+		const vec4 object = getInverseViewProjection() * ndc;
+
+		if (object.w == T(0))
+			return vec3(T(0));
+
+		const T invW = T(1) / object.w;
+
+		return vec3(object.x * invW, object.y * invW, object.z * invW);
+	}
+
+	// The ray from the near plane through a point in window coordinates, as ray_t::fromScreen()
+	ray getRay(const vec2 &window) const
+	{
+		const vec2 ndc(
+			(window.x - T(this->viewport.x)) / T(this->viewport.z) * T(2) - T(1),
+			(window.y - T(this->viewport.y)) / T(this->viewport.w) * T(2) - T(1));
+
+		return ray::fromNDC(ndc, getInverseViewProjection(), this->depthRange);
+	}
+
+
+private:
+
+	vec3 eye, target, up;
+
+	T fov, zNear, zFar;
+
+	ivec4 viewport;
+
+	DepthRange depthRange;
+	bool infiniteFar;
+
+	// Computed on demand by the const getters, a bit per matrix or the frustum that's out of date
+	mutable unsigned int outdated;
+
+	mutable mat4 view, projection, viewProjection;
+	mutable mat4 inverseView, inverseProjection, inverseViewProjection;
+
+	mutable frustum planes;
+};
+
+
+// A 16-bit IEEE 754 half precision float, meant for storage, e.g. vertex and instance streams,
+// as arithmetic is done after converting to float. Converting from float rounds to nearest even.
+class half
+{
+public:
+
+	unsigned short bits;
+
+
+public:
+
+	half() {}
+	half(const float f) : bits(fromFloat(f)) {}
+
+	~half() {}
+
+
+	inline operator float() const { return toFloat(this->bits); }
+
+
+	static inline half fromBits(const unsigned short bits)
+	{
+		half h;
+		h.bits = bits;
+
+		return h;
+	}
+
+	static unsigned short fromFloat(const float f);
+	static float toFloat(const unsigned short bits);
+
+
+	// Converts count floats at once, which can be spans of vectors as well
+	static void convert(const float *source, const size_t count, half *result);
+	static void convert(const half *source, const size_t count, float *result);
+};
+
+
+// The half float storage versions of fvec2, fvec3 and fvec4, which convert to and from them
+
+class hvec2
+{
+public:
+
+	half x, y;
+
+
+public:
+
+	hvec2() {}
+	hvec2(const half &x, const half &y) : x(x), y(y) {}
+	hvec2(const fvec2 &v) : x(v.x), y(v.y) {}
+
+	~hvec2() {}
+
+
+	inline operator fvec2() const { return fvec2(float(this->x), float(this->y)); }
+
+
+	static inline void convert(const fvec2 *source, const size_t count, hvec2 *result) { half::convert(reinterpret_cast<const float*>(source), count * 2, reinterpret_cast<half*>(result)); }
+	static inline void convert(const hvec2 *source, const size_t count, fvec2 *result) { half::convert(reinterpret_cast<const half*>(source), count * 2, reinterpret_cast<float*>(result)); }
+};
+
+
+class hvec3
+{
+public:
+
+	half x, y, z;
+
+
+public:
+
+	hvec3() {}
+	hvec3(const half &x, const half &y, const half &z) : x(x), y(y), z(z) {}
+	hvec3(const fvec3 &v) : x(v.x), y(v.y), z(v.z) {}
+
+	~hvec3() {}
+
+
+	inline operator fvec3() const { return fvec3(float(this->x), float(this->y), float(this->z)); }
+
+
+	static inline void convert(const fvec3 *source, const size_t count, hvec3 *result) { half::convert(reinterpret_cast<const float*>(source), count * 3, reinterpret_cast<half*>(result)); }
+	static inline void convert(const hvec3 *source, const size_t count, fvec3 *result) { half::convert(reinterpret_cast<const half*>(source), count * 3, reinterpret_cast<float*>(result)); }
+};
+
+
+class hvec4
+{
+public:
+
+	half x, y, z, w;
+
+
+public:
+
+	hvec4() {}
+	hvec4(const half &x, const half &y, const half &z, const half &w) : x(x), y(y), z(z), w(w) {}
+	hvec4(const fvec4 &v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
+
+	~hvec4() {}
+
+
+	inline operator fvec4() const { return fvec4(float(this->x), float(this->y), float(this->z), float(this->w)); }
+
+
+	static inline void convert(const fvec4 *source, const size_t count, hvec4 *result) { half::convert(reinterpret_cast<const float*>(source), count * 4, reinterpret_cast<half*>(result)); }
+	static inline void convert(const hvec4 *source, const size_t count, fvec4 *result) { half::convert(reinterpret_cast<const half*>(source), count * 4, reinterpret_cast<float*>(result)); }
+};
+
+// It isn't an optimal solution, to inline all template functions that has explicit specialization.
+// But it is needed if we don't want to run into "multiple definitions" compilation error.
+
+
+#pragma region vec2
+
+#pragma region Static Members
+
+template<typename T> const vec2_t<T> vec2_t<T>::zero = vec2_t<T>(T(0), T(0));
+template<typename T> const vec2_t<T> vec2_t<T>::one = vec2_t<T>(T(1), T(1));
+
+template<typename T> const vec2_t<T> vec2_t<T>::up = vec2_t<T>(T(0), T(1));
+template<typename T> const vec2_t<T> vec2_t<T>::down = vec2_t<T>(T(0), T(-1));
+
+template<typename T> const vec2_t<T> vec2_t<T>::left = vec2_t<T>(T(-1), T(0));
+template<typename T> const vec2_t<T> vec2_t<T>::right = vec2_t<T>(T(1), T(0));
+
+#pragma endregion
+
+#pragma region Constructors
+
+template<typename T>
+template<typename T2>
+vec2_t<T>::vec2_t(const vec3_t<T2> &v) : x(T(v.x)), y(T(v.y))
+{
+
+}
+
+template<typename T>
+template<typename T2>
+vec2_t<T>::vec2_t(const vec4_t<T2> &v) : x(T(v.x)), y(T(v.y))
+{
+
+}
+
+#pragma endregion
+
+#pragma region Comparison Operators
+
+template<typename T> inline bool vec2_t<T>::operator==(const vec2 &rhs) const
+{
+	return ((this->x == rhs.x) && (this->y == rhs.y));
+}
+
+template<> inline bool fvec2::operator==(const fvec2 &rhs) const
+{
+	return (LINALG_FEQUAL(this->x, rhs.x) && LINALG_FEQUAL(this->y, rhs.y));
+}
+
+template<> inline bool dvec2::operator==(const dvec2 &rhs) const
+{
+	return (LINALG_DEQUAL(this->x, rhs.x) && LINALG_DEQUAL(this->y, rhs.y));
+}
+
+#pragma endregion
+
+#pragma region Normalize
+
+template<> inline fvec2 fvec2::normalize(const float &to) const
+{
+	float len = length();
+
+	if (!LINALG_FEQUAL(len, 0.0f) && !LINALG_FEQUAL(len, to))
+	{
+		len = to / len;
+
+		return fvec2(*this) * len;
+	}
+
+	return (*this);
+}
+
+template<> inline dvec2 dvec2::normalize(const double &to) const
+{
+	double len = length();
+
+	if (!LINALG_DEQUAL(len, 0.0) && !LINALG_DEQUAL(len, to))
+	{
+		len = to / len;
+
+		return dvec2(*this) * len;
+	}
+
+	return (*this);
+}
+
+#pragma endregion
+
+#pragma region Check Vector Kind
+
+template<typename T> bool vec2_t<T>::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return ((this->x == 0) && (this->y == 0));
+}
+
+template<> bool fvec2::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return (LINALG_FEQUAL(this->x, 0.0f) && LINALG_FEQUAL(this->y, 0.0f));
+}
+
+template<> bool dvec2::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return (LINALG_DEQUAL(this->x, 0.0) && LINALG_DEQUAL(this->y, 0.0));
+}
+
+
+template<> inline bool fvec2::isUnitVector() const
+{
+	return LINALG_FEQUAL(lengthSquared(), 1.0f);
+}
+
+template<> inline bool dvec2::isUnitVector() const
+{
+	return LINALG_DEQUAL(lengthSquared(), 1.0f);
+}
+
+
+template<> bool fvec2::isNormalized(const float &to) const
+{
+	const float len = length();
+
+	return LINALG_FEQUAL(len, to);
+}
+
+template<> bool dvec2::isNormalized(const double &to) const
+{
+	const double len = length();
+
+	return LINALG_DEQUAL(len, to);
+}
+
+
+template<typename T> bool vec2_t<T>::isOrthogonalTo(const vec2 &rhs) const
+{
+	return (dot(rhs) == 0);
+}
+
+template<> bool fvec2::isOrthogonalTo(const vec2 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 0.0f));
+}
+
+template<> bool dvec2::isOrthogonalTo(const vec2 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 0.0));
+}
+
+
+template<typename T> bool vec2_t<T>::isPerpendicularTo(const vec2 &rhs) const
+{
+	return (dot(rhs) == 0);
+}
+
+template<> bool fvec2::isPerpendicularTo(const vec2 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 0.0f));
+}
+
+template<> bool dvec2::isPerpendicularTo(const vec2 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 0.0));
+}
+
+
+template<typename T> bool vec2_t<T>::isParallelTo(const vec2 &rhs) const
+{
+	return (dot(rhs) == 1);
+}
+
+template<> bool fvec2::isParallelTo(const vec2 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 1.0f));
+}
+
+template<> bool dvec2::isParallelTo(const vec2 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 1.0));
+}
+
+#pragma endregion
+
+#pragma region Validate sizeof Templated Objects
+
+#ifdef DEBUG
+
+#ifndef STATIC_ASSERT
+#	define STATIC_ASSERT(bool_constexpr) static_assert(bool_constexpr, #bool_constexpr)
+#endif
+
+STATIC_ASSERT(sizeof(vec2_t<float>) == (sizeof(float) * 2));
+STATIC_ASSERT(sizeof(vec2_t<double>) == (sizeof(double) * 2));
+
+STATIC_ASSERT(sizeof(vec2_t<signed int>) == (sizeof(signed int) * 2));
+STATIC_ASSERT(sizeof(vec2_t<unsigned int>) == (sizeof(unsigned int) * 2));
+
+STATIC_ASSERT(sizeof(vec2_t<bool>) == (sizeof(bool) * 2));
+
+STATIC_ASSERT(sizeof(vec2_t<signed long>) == (sizeof(signed long) * 2));
+STATIC_ASSERT(sizeof(vec2_t<unsigned long>) == (sizeof(unsigned long) * 2));
+
+STATIC_ASSERT(sizeof(vec2_t<signed long long>) == (sizeof(signed long long) * 2));
+STATIC_ASSERT(sizeof(vec2_t<unsigned long long>) == (sizeof(unsigned long long) * 2));
+
+#endif
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region vec3
+
+#pragma region Static Members
+
+template<typename T> const vec3_t<T> vec3_t<T>::zero = vec3_t<T>(T(0), T(0), T(0));
+template<typename T> const vec3_t<T> vec3_t<T>::one = vec3_t<T>(T(1), T(1), T(1));
+
+template<typename T> const vec3_t<T> vec3_t<T>::up = vec3_t<T>(T(0), T(1), T(0));
+template<typename T> const vec3_t<T> vec3_t<T>::down = vec3_t<T>(T(0), T(-1), T(0));
+
+template<typename T> const vec3_t<T> vec3_t<T>::left = vec3_t<T>(T(-1), T(0), T(0));
+template<typename T> const vec3_t<T> vec3_t<T>::right = vec3_t<T>(T(1), T(0), T(0));
+
+template<typename T> const vec3_t<T> vec3_t<T>::forward = vec3_t<T>(T(0), T(0), T(1));
+template<typename T> const vec3_t<T> vec3_t<T>::backward = vec3_t<T>(T(0), T(0), T(-1));
+
+#pragma endregion
+
+#pragma region Constructors
+
+template<typename T>
+template<typename T2>
+vec3_t<T>::vec3_t(const vec4_t<T2> &v) : x(T(v.x)), y(T(v.y)), z(T(v.z))
+{
+
+}
+
+#pragma endregion
+
+#pragma region Comparison Operators
+
+template<typename T> inline bool vec3_t<T>::operator==(const vec3 &rhs) const
+{
+	return ((this->x == rhs.x) && (this->y == rhs.y) && (this->z == rhs.z));
+}
+
+template<> inline bool fvec3::operator==(const fvec3 &rhs) const
+{
+	return (LINALG_FEQUAL(this->x, rhs.x) && LINALG_FEQUAL(this->y, rhs.y) && LINALG_FEQUAL(this->z, rhs.z));
+}
+
+template<> inline bool dvec3::operator==(const dvec3 &rhs) const
+{
+	return (LINALG_DEQUAL(this->x, rhs.x) && LINALG_DEQUAL(this->y, rhs.y) && LINALG_DEQUAL(this->z, rhs.z));
+}
+
+#pragma endregion
+
+#pragma region Normalize
+
+template<> inline fvec3 fvec3::normalize(const float &to) const
+{
+	float len = length();
+
+	if (!LINALG_FEQUAL(len, 0.0f) && !LINALG_FEQUAL(len, to))
+	{
+		len = to / len;
+
+		return fvec3(*this) * len;
+	}
+
+	return (*this);
+}
+
+template<> inline dvec3 dvec3::normalize(const double &to) const
+{
+	double len = length();
+
+	if (!LINALG_DEQUAL(len, 0.0) && !LINALG_DEQUAL(len, to))
+	{
+		len = to / len;
+
+		return dvec3(*this) * len;
+	}
+
+	return (*this);
+}
+
+#pragma endregion
+
+#pragma region Check Vector Kind
+
+template<typename T> bool vec3_t<T>::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return ((this->x == 0) && (this->y == 0) && (this->z == 0));
+}
+
+template<> bool fvec3::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return (LINALG_FEQUAL(this->x, 0.0f) && LINALG_FEQUAL(this->y, 0.0f) && LINALG_FEQUAL(this->z, 0.0f));
+}
+
+template<> bool dvec3::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return (LINALG_DEQUAL(this->x, 0.0) && LINALG_DEQUAL(this->y, 0.0) && LINALG_DEQUAL(this->z, 0.0));
+}
+
+
+template<> inline bool fvec3::isUnitVector() const
+{
+	return LINALG_FEQUAL(lengthSquared(), 1.0f);
+}
+
+template<> inline bool dvec3::isUnitVector() const
+{
+	return LINALG_DEQUAL(lengthSquared(), 1.0f);
+}
+
+
+template<> bool fvec3::isNormalized(const float &to) const
+{
+	const float len = length();
+
+	return LINALG_FEQUAL(len, to);
+}
+
+template<> bool dvec3::isNormalized(const double &to) const
+{
+	const double len = length();
+
+	return LINALG_DEQUAL(len, to);
+}
+
+
+template<typename T> bool vec3_t<T>::isOrthogonalTo(const vec3 &rhs) const
+{
+	return (dot(rhs) == 0);
+}
+
+template<> bool fvec3::isOrthogonalTo(const vec3 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 0.0f));
+}
+
+template<> bool dvec3::isOrthogonalTo(const vec3 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 0.0));
+}
+
+
+template<typename T> bool vec3_t<T>::isPerpendicularTo(const vec3 &rhs) const
+{
+	return (dot(rhs) == 0);
+}
+
+template<> bool fvec3::isPerpendicularTo(const vec3 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 0.0f));
+}
+
+template<> bool dvec3::isPerpendicularTo(const vec3 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 0.0));
+}
+
+
+template<typename T> bool vec3_t<T>::isParallelTo(const vec3 &rhs) const
+{
+	return (dot(rhs) == 1);
+}
+
+template<> bool fvec3::isParallelTo(const vec3 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 1.0f));
+}
+
+template<> bool dvec3::isParallelTo(const vec3 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 1.0));
+}
+
+#pragma endregion
+
+#pragma region Encoding
+
+// Maps a vector onto the octahedron and unfolds the lower half, giving u and v in [-1, 1]
+template<typename T> inline void _linalg_octahedral_encode(const vec3_t<T> &n, T &u, T &v)
+{
+	const T ax = (n.x < T(0)) ? -n.x : n.x, ay = (n.y < T(0)) ? -n.y : n.y, az = (n.z < T(0)) ? -n.z : n.z;
+	const T sum = ax + ay + az;
+	const T invSum = T(1) / ((sum > T(1E-30)) ? sum : T(1E-30));
+
+	u = n.x * invSum;
+	v = n.y * invSum;
+
+	if (n.z < T(0))
+	{
+		const T au = (u < T(0)) ? -u : u, av = (v < T(0)) ? -v : v;
+
+		u = (T(1) - av) * ((n.x >= T(0)) ? T(1) : T(-1));
+		v = (T(1) - au) * ((n.y >= T(0)) ? T(1) : T(-1));
+	}
+}
+
+template<typename T> inline vec3_t<T> _linalg_octahedral_decode(T u, T v)
+{
+	const T au = (u < T(0)) ? -u : u, av = (v < T(0)) ? -v : v;
+	const T z = T(1) - au - av;
+	const T fold = (z < T(0)) ? -z : T(0);
+
+	u += (u >= T(0)) ? -fold : fold;
+	v += (v >= T(0)) ? -fold : fold;
+
+	return vec3_t<T>(u, v, z) * (T(1) / sqrt(u * u + v * v + z * z));
+}
+
+// Quantizes v in [-1, 1] to a signed normalized integer in [-scale, scale], with scale = 2^(bits - 1) - 1,
+// rounding by truncating a positive value to match _linalg_truncate()
+template<typename T> inline int _linalg_snorm_encode(const T v, const int scale)
+{
+	const T clamped = (v < T(-1)) ? T(-1) : ((v > T(1)) ? T(1) : v);
+
+	return static_cast<int>(clamped * T(scale) + (T(scale) + T(0.5))) - scale;
+}
+
+// Sign extends the lowest bits, with scale = 2^(bits - 1) - 1
+template<typename T> inline T _linalg_snorm_decode(const unsigned int bits, const int scale)
+{
+	const unsigned int sign = unsigned(scale) + 1u;
+	const int q = int((bits & (sign * 2u - 1u)) ^ sign) - int(sign);
+	const T v = T(q) / T(scale);
+
+	return (v < T(-1)) ? T(-1) : v;
+}
+
+template<typename T> unsigned int vec3_t<T>::encodeOctahedral(const vec3 &v)
+{
+	T u, w;
+	_linalg_octahedral_encode(v, u, w);
+
+	return (unsigned(_linalg_snorm_encode(u, 32767)) & 0xFFFFu) | (unsigned(_linalg_snorm_encode(w, 32767)) << 16);
+}
+
+template<typename T> vec3_t<T> vec3_t<T>::decodeOctahedral(const unsigned int encoded)
+{
+	return _linalg_octahedral_decode(_linalg_snorm_decode<T>(encoded, 32767), _linalg_snorm_decode<T>(encoded >> 16, 32767));
+}
+
+template<typename T> unsigned short vec3_t<T>::encodeOctahedral16(const vec3 &v)
+{
+	T u, w;
+	_linalg_octahedral_encode(v, u, w);
+
+	return static_cast<unsigned short>((unsigned(_linalg_snorm_encode(u, 127)) & 0xFFu) | ((unsigned(_linalg_snorm_encode(w, 127)) & 0xFFu) << 8));
+}
+
+template<typename T> vec3_t<T> vec3_t<T>::decodeOctahedral16(const unsigned short encoded)
+{
+	return _linalg_octahedral_decode(_linalg_snorm_decode<T>(encoded, 127), _linalg_snorm_decode<T>(encoded >> 8u, 127));
+}
+
+template<typename T> unsigned int vec3_t<T>::encode1010102(const vec3 &v, const T w)
+{
+	return
+		(unsigned(_linalg_snorm_encode(v.x, 511)) & 0x3FFu) |
+		((unsigned(_linalg_snorm_encode(v.y, 511)) & 0x3FFu) << 10) |
+		((unsigned(_linalg_snorm_encode(v.z, 511)) & 0x3FFu) << 20) |
+		(unsigned(_linalg_snorm_encode(w, 1)) << 30);
+}
+
+template<typename T> vec3_t<T> vec3_t<T>::decode1010102(const unsigned int encoded, T *w)
+{
+	if (w)
+		*w = _linalg_snorm_decode<T>(encoded >> 30, 1);
+
+	return vec3(
+		_linalg_snorm_decode<T>(encoded, 511),
+		_linalg_snorm_decode<T>(encoded >> 10, 511),
+		_linalg_snorm_decode<T>(encoded >> 20, 511));
+}
+
+template<typename T> void vec3_t<T>::encodeOctahedral(const vec3 *vectors, const size_t count, unsigned int *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = encodeOctahedral(vectors[i]);
+}
+
+template<typename T> void vec3_t<T>::decodeOctahedral(const unsigned int *encoded, const size_t count, vec3 *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = decodeOctahedral(encoded[i]);
+}
+
+template<typename T> void vec3_t<T>::encodeOctahedral16(const vec3 *vectors, const size_t count, unsigned short *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = encodeOctahedral16(vectors[i]);
+}
+
+template<typename T> void vec3_t<T>::decodeOctahedral16(const unsigned short *encoded, const size_t count, vec3 *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = decodeOctahedral16(encoded[i]);
+}
+
+template<typename T> void vec3_t<T>::encode1010102(const vec3 *vectors, const size_t count, unsigned int *result, const T *w)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = encode1010102(vectors[i], w ? w[i] : T(0));
+}
+
+template<typename T> void vec3_t<T>::decode1010102(const unsigned int *encoded, const size_t count, vec3 *result, T *w)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = decode1010102(encoded[i], w ? &w[i] : nullptr);
+}
+
+
+// The octahedral encoding of 4 vectors, given and resulting in lanes. The quantized
+// coordinates are written to qu and qv, offset by scale such that they're positive.
+inline void _linalg_octahedral_encode_4(const _linalg_float4 &x, const _linalg_float4 &y, const _linalg_float4 &z, const float scale, int *qu, int *qv)
+{
+	const _linalg_float4 zero(0.0f), one(1.0f), minusOne(-1.0f);
+
+	const _linalg_float4 invSum = one / _linalg_max(_linalg_abs(x) + _linalg_abs(y) + _linalg_abs(z), _linalg_float4(1E-30f));
+
+	_linalg_float4 u = x * invSum, v = y * invSum;
+
+	const _linalg_float4 foldedU = (one - _linalg_abs(v)) * _linalg_select(_linalg_cmpge(x, zero), one, minusOne);
+	const _linalg_float4 foldedV = (one - _linalg_abs(u)) * _linalg_select(_linalg_cmpge(y, zero), one, minusOne);
+
+	const _linalg_float4 lower = _linalg_cmplt(z, zero);
+
+	u = _linalg_min(_linalg_max(_linalg_select(lower, foldedU, u), minusOne), one);
+	v = _linalg_min(_linalg_max(_linalg_select(lower, foldedV, v), minusOne), one);
+
+	const _linalg_float4 s(scale), offset(scale + 0.5f);
+
+	_linalg_truncate(u * s + offset, qu);
+	_linalg_truncate(v * s + offset, qv);
+}
+
+// The inverse of the above, given the signed quantized coordinates
+inline void _linalg_octahedral_decode_4(const int *qu, const int *qv, const float scale, _linalg_float4 &x, _linalg_float4 &y, _linalg_float4 &z)
+{
+	const _linalg_float4 zero(0.0f), one(1.0f), minusOne(-1.0f);
+
+	const _linalg_float4 s(scale);
+
+	_linalg_float4 u = _linalg_max(_linalg_int_to_float(qu) / s, minusOne);
+	_linalg_float4 v = _linalg_max(_linalg_int_to_float(qv) / s, minusOne);
+
+	z = one - _linalg_abs(u) - _linalg_abs(v);
+
+	const _linalg_float4 fold = _linalg_max(zero - z, zero);
+
+	u = u + _linalg_select(_linalg_cmpge(u, zero), zero - fold, fold);
+	v = v + _linalg_select(_linalg_cmpge(v, zero), zero - fold, fold);
+
+	const _linalg_float4 invLength = one / _linalg_sqrt(u * u + v * v + z * z);
+
+	x = u * invLength;
+	y = v * invLength;
+	z = z * invLength;
+}
+
+template<> inline void fvec3::encodeOctahedral(const fvec3 *vectors, const size_t count, unsigned int *result)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&vectors[i].x, x, y, z);
+
+		int qu[4], qv[4];
+		_linalg_octahedral_encode_4(x, y, z, 32767.0f, qu, qv);
+
+		for (int lane = 0; lane < 4; lane++)
+			result[i + lane] = (unsigned(qu[lane] - 32767) & 0xFFFFu) | (unsigned(qv[lane] - 32767) << 16);
+	}
+
+	for (; i < count; i++)
+		result[i] = encodeOctahedral(vectors[i]);
+}
+
+template<> inline void fvec3::decodeOctahedral(const unsigned int *encoded, const size_t count, fvec3 *result)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		int qu[4], qv[4];
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			qu[lane] = int((encoded[i + lane] & 0xFFFFu) ^ 0x8000u) - 0x8000;
+			qv[lane] = int((encoded[i + lane] >> 16) ^ 0x8000u) - 0x8000;
+		}
+
+		_linalg_float4 x, y, z;
+		_linalg_octahedral_decode_4(qu, qv, 32767.0f, x, y, z);
+
+		_linalg_store3x4(&result[i].x, x, y, z);
+	}
+
+	for (; i < count; i++)
+		result[i] = decodeOctahedral(encoded[i]);
+}
+
+template<> inline void fvec3::encodeOctahedral16(const fvec3 *vectors, const size_t count, unsigned short *result)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&vectors[i].x, x, y, z);
+
+		int qu[4], qv[4];
+		_linalg_octahedral_encode_4(x, y, z, 127.0f, qu, qv);
+
+		for (int lane = 0; lane < 4; lane++)
+			result[i + lane] = static_cast<unsigned short>((unsigned(qu[lane] - 127) & 0xFFu) | ((unsigned(qv[lane] - 127) & 0xFFu) << 8));
+	}
+
+	for (; i < count; i++)
+		result[i] = encodeOctahedral16(vectors[i]);
+}
+
+template<> inline void fvec3::decodeOctahedral16(const unsigned short *encoded, const size_t count, fvec3 *result)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		int qu[4], qv[4];
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			qu[lane] = int((encoded[i + lane] & 0xFFu) ^ 0x80u) - 0x80;
+			qv[lane] = int((encoded[i + lane] >> 8u) ^ 0x80u) - 0x80;
+		}
+
+		_linalg_float4 x, y, z;
+		_linalg_octahedral_decode_4(qu, qv, 127.0f, x, y, z);
+
+		_linalg_store3x4(&result[i].x, x, y, z);
+	}
+
+	for (; i < count; i++)
+		result[i] = decodeOctahedral16(encoded[i]);
+}
+
+template<> inline void fvec3::encode1010102(const fvec3 *vectors, const size_t count, unsigned int *result, const float *w)
+{
+	const _linalg_float4 one(1.0f), minusOne(-1.0f), scale(511.0f), offset(511.5f);
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&vectors[i].x, x, y, z);
+
+		int qx[4], qy[4], qz[4];
+		_linalg_truncate(_linalg_min(_linalg_max(x, minusOne), one) * scale + offset, qx);
+		_linalg_truncate(_linalg_min(_linalg_max(y, minusOne), one) * scale + offset, qy);
+		_linalg_truncate(_linalg_min(_linalg_max(z, minusOne), one) * scale + offset, qz);
+
+		for (int lane = 0; lane < 4; lane++)
+			result[i + lane] = (unsigned(qx[lane] - 511) & 0x3FFu) | ((unsigned(qy[lane] - 511) & 0x3FFu) << 10) | ((unsigned(qz[lane] - 511) & 0x3FFu) << 20);
+
+		if (w)
+			for (int lane = 0; lane < 4; lane++)
+				result[i + lane] |= unsigned(_linalg_snorm_encode(w[i + lane], 1)) << 30;
+	}
+
+	for (; i < count; i++)
+		result[i] = encode1010102(vectors[i], w ? w[i] : 0.0f);
+}
+
+template<> inline void fvec3::decode1010102(const unsigned int *encoded, const size_t count, fvec3 *result, float *w)
+{
+	const _linalg_float4 minusOne(-1.0f), scale(511.0f);
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		int qx[4], qy[4], qz[4];
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			qx[lane] = int((encoded[i + lane] & 0x3FFu) ^ 0x200u) - 0x200;
+			qy[lane] = int(((encoded[i + lane] >> 10) & 0x3FFu) ^ 0x200u) - 0x200;
+			qz[lane] = int(((encoded[i + lane] >> 20) & 0x3FFu) ^ 0x200u) - 0x200;
+		}
+
+		const _linalg_float4 x = _linalg_max(_linalg_int_to_float(qx) / scale, minusOne);
+		const _linalg_float4 y = _linalg_max(_linalg_int_to_float(qy) / scale, minusOne);
+		const _linalg_float4 z = _linalg_max(_linalg_int_to_float(qz) / scale, minusOne);
+
+		_linalg_store3x4(&result[i].x, x, y, z);
+
+		if (w)
+			for (int lane = 0; lane < 4; lane++)
+				w[i + lane] = _linalg_snorm_decode<float>(encoded[i + lane] >> 30, 1);
+	}
+
+	for (; i < count; i++)
+		result[i] = decode1010102(encoded[i], w ? &w[i] : nullptr);
+}
+
+#pragma endregion
+
+#pragma region Validate sizeof Templated Objects
+
+#ifdef DEBUG
+
+#ifndef STATIC_ASSERT
+#	define STATIC_ASSERT(bool_constexpr) static_assert(bool_constexpr, #bool_constexpr)
+#endif
+
+STATIC_ASSERT(sizeof(vec3_t<float>) == (sizeof(float) * 3));
+STATIC_ASSERT(sizeof(vec3_t<double>) == (sizeof(double) * 3));
+
+STATIC_ASSERT(sizeof(vec3_t<signed int>) == (sizeof(signed int) * 3));
+STATIC_ASSERT(sizeof(vec3_t<unsigned int>) == (sizeof(unsigned int) * 3));
+
+STATIC_ASSERT(sizeof(vec3_t<bool>) == (sizeof(bool) * 3));
+
+STATIC_ASSERT(sizeof(vec3_t<signed long>) == (sizeof(signed long) * 3));
+STATIC_ASSERT(sizeof(vec3_t<unsigned long>) == (sizeof(unsigned long) * 3));
+
+STATIC_ASSERT(sizeof(vec3_t<signed long long>) == (sizeof(signed long long) * 3));
+STATIC_ASSERT(sizeof(vec3_t<unsigned long long>) == (sizeof(unsigned long long) * 3));
+
+#endif
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region vec4
+
+#pragma region Static Members
+
+template<typename T> const vec4_t<T> vec4_t<T>::zero = vec4_t<T>(T(0), T(0), T(0), T(0));
+template<typename T> const vec4_t<T> vec4_t<T>::one = vec4_t<T>(T(1), T(1), T(1), T(1));
+
+#pragma endregion
+
+#pragma region Constructors
+
+
+
+#pragma endregion
+
+#pragma region Comparison Operators
+
+template<typename T> inline bool vec4_t<T>::operator==(const vec4 &rhs) const
+{
+	return ((this->x == rhs.x) && (this->y == rhs.y) && (this->z == rhs.z) && (this->w == rhs.w));
+}
+
+template<> inline bool fvec4::operator==(const fvec4 &rhs) const
+{
+	return (LINALG_FEQUAL(this->x, rhs.x) && LINALG_FEQUAL(this->y, rhs.y) && LINALG_FEQUAL(this->z, rhs.z) && LINALG_FEQUAL(this->w, rhs.w));
+}
+
+template<> inline bool dvec4::operator==(const dvec4 &rhs) const
+{
+	return (LINALG_DEQUAL(this->x, rhs.x) && LINALG_DEQUAL(this->y, rhs.y) && LINALG_DEQUAL(this->z, rhs.z) && LINALG_DEQUAL(this->w, rhs.w));
+}
+
+#pragma endregion
+
+#pragma region Normalize
+
+template<> inline fvec4 fvec4::normalize(const float &to) const
+{
 	float len = length();
 
-	if (!LINALG_FEQUAL(len, 0.0f) && !LINALG_FEQUAL(len, to))
+	if (!LINALG_FEQUAL(len, 0.0f) && !LINALG_FEQUAL(len, to))
+	{
+		len = to / len;
+
+		return fvec4(*this) * len;
+	}
+
+	return (*this);
+}
+
+template<> inline dvec4 dvec4::normalize(const double &to) const
+{
+	double len = length();
+
+	if (!LINALG_DEQUAL(len, 0.0) && !LINALG_DEQUAL(len, to))
+	{
+		len = to / len;
+
+		return dvec4(*this) * len;
+	}
+
+	return (*this);
+}
+
+#pragma endregion
+
+#pragma region Check Vector Kind
+
+template<typename T> bool vec4_t<T>::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return ((this->x == 0) && (this->y == 0) && (this->z == 0) && (this->w == 0));
+}
+
+template<> bool fvec4::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return (LINALG_FEQUAL(this->x, 0.0f) && LINALG_FEQUAL(this->y, 0.0f) && LINALG_FEQUAL(this->z, 0.0f) && LINALG_FEQUAL(this->w, 0.0f));
+}
+
+template<> bool dvec4::isNullVector() const
+{
+	// It's faster to just compare to 0, than to calculate the length
+	return (LINALG_DEQUAL(this->x, 0.0) && LINALG_DEQUAL(this->y, 0.0) && LINALG_DEQUAL(this->z, 0.0) && LINALG_DEQUAL(this->w, 0.0));
+}
+
+
+template<> inline bool fvec4::isUnitVector() const
+{
+	return LINALG_FEQUAL(lengthSquared(), 1.0f);
+}
+
+template<> inline bool dvec4::isUnitVector() const
+{
+	return LINALG_DEQUAL(lengthSquared(), 1.0f);
+}
+
+
+template<> bool fvec4::isNormalized(const float &to) const
+{
+	const float len = length();
+
+	return LINALG_FEQUAL(len, to);
+}
+
+template<> bool dvec4::isNormalized(const double &to) const
+{
+	const double len = length();
+
+	return LINALG_DEQUAL(len, to);
+}
+
+
+template<typename T> bool vec4_t<T>::isOrthogonalTo(const vec4 &rhs) const
+{
+	return (dot(rhs) == 0);
+}
+
+template<> bool fvec4::isOrthogonalTo(const vec4 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 0.0f));
+}
+
+template<> bool dvec4::isOrthogonalTo(const vec4 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 0.0));
+}
+
+
+template<typename T> bool vec4_t<T>::isPerpendicularTo(const vec4 &rhs) const
+{
+	return (dot(rhs) == 0);
+}
+
+template<> bool fvec4::isPerpendicularTo(const vec4 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 0.0f));
+}
+
+template<> bool dvec4::isPerpendicularTo(const vec4 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 0.0));
+}
+
+
+template<typename T> bool vec4_t<T>::isParallelTo(const vec4 &rhs) const
+{
+	return (dot(rhs) == 1);
+}
+
+template<> bool fvec4::isParallelTo(const vec4 &rhs) const
+{
+	const float d = dot(rhs);
+
+	return (LINALG_FEQUAL(d, 1.0f));
+}
+
+template<> bool dvec4::isParallelTo(const vec4 &rhs) const
+{
+	const double d = dot(rhs);
+
+	return (LINALG_DEQUAL(d, 1.0));
+}
+
+#pragma endregion
+
+#pragma region Validate sizeof Templated Objects
+
+#ifdef DEBUG
+
+#ifndef STATIC_ASSERT
+#	define STATIC_ASSERT(bool_constexpr) static_assert(bool_constexpr, #bool_constexpr)
+#endif
+
+STATIC_ASSERT(sizeof(vec4_t<float>) == (sizeof(float) * 4));
+STATIC_ASSERT(sizeof(vec4_t<double>) == (sizeof(double) * 4));
+
+STATIC_ASSERT(sizeof(vec4_t<signed int>) == (sizeof(signed int) * 4));
+STATIC_ASSERT(sizeof(vec4_t<unsigned int>) == (sizeof(unsigned int) * 4));
+
+STATIC_ASSERT(sizeof(vec4_t<bool>) == (sizeof(bool) * 4));
+
+STATIC_ASSERT(sizeof(vec4_t<signed long>) == (sizeof(signed long) * 4));
+STATIC_ASSERT(sizeof(vec4_t<unsigned long>) == (sizeof(unsigned long) * 4));
+
+STATIC_ASSERT(sizeof(vec4_t<signed long long>) == (sizeof(signed long long) * 4));
+STATIC_ASSERT(sizeof(vec4_t<unsigned long long>) == (sizeof(unsigned long long) * 4));
+
+#endif
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region mat2
+
+#pragma region Static Members
+
+template<typename T> const mat2_t<T> mat2_t<T>::zero = mat2_t<T>(T(0));
+template<typename T> const mat2_t<T> mat2_t<T>::identity = mat2_t<T>(T(1));
+
+#pragma endregion
+
+#pragma region Constructors
+
+template<typename T>
+template<typename T2>
+mat2_t<T>::mat2_t(const mat3_t<T2> &m)
+{
+	this->columns[0] = vec2(m.columns[0]);
+	this->columns[1] = vec2(m.columns[1]);
+}
+
+template<typename T>
+template<typename T2>
+mat2_t<T>::mat2_t(const mat4_t<T2> &m)
+{
+	this->columns[0] = vec2(m.columns[0]);
+	this->columns[1] = vec2(m.columns[1]);
+}
+
+#pragma endregion
+
+#pragma region Comparison Operators
+
+template<typename T> inline bool mat2_t<T>::operator==(const mat2_t &rhs) const
+{
+	for (int i = 0; i < 2; i++)
+		if ((*this)[i] != rhs[i])
+			return false;
+
+	return true;
+}
+
+template<> inline bool mat2_t<float>::operator==(const mat2_t<float> &rhs) const
+{
+	for (int i = 0; i < 2; i++)
+		if (!LINALG_FEQUAL((*this)[i], rhs[i]))
+			return false;
+
+	return true;
+}
+
+template<> inline bool mat2_t<double>::operator==(const mat2_t<double> &rhs) const
+{
+	for (int i = 0; i < 2; i++)
+		if (!LINALG_DEQUAL((*this)[i], rhs[i]))
+			return false;
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region mat3
+
+#pragma region Static Members
+
+template<typename T> const mat3_t<T> mat3_t<T>::zero = mat3_t<T>(T(0));
+template<typename T> const mat3_t<T> mat3_t<T>::identity = mat3_t<T>(T(1));
+
+#pragma endregion
+
+#pragma region Constructors
+
+template<typename T>
+template<typename T2>
+mat3_t<T>::mat3_t(const mat4_t<T2> &m)
+{
+	this->columns[0] = vec3(m.columns[0]);
+	this->columns[1] = vec3(m.columns[1]);
+	this->columns[2] = vec3(m.columns[2]);
+}
+
+#pragma endregion
+
+#pragma region Comparison Operators
+
+template<typename T> inline bool mat3_t<T>::operator==(const mat3_t &rhs) const
+{
+	for (int i = 0; i < 3; i++)
+		if ((*this)[i] != rhs[i])
+			return false;
+
+	return true;
+}
+
+template<> inline bool mat3_t<float>::operator==(const mat3_t<float> &rhs) const
+{
+	for (int i = 0; i < 3; i++)
+		if (!LINALG_FEQUAL((*this)[i], rhs[i]))
+			return false;
+
+	return true;
+}
+
+template<> inline bool mat3_t<double>::operator==(const mat3_t<double> &rhs) const
+{
+	for (int i = 0; i < 3; i++)
+		if (!LINALG_DEQUAL((*this)[i], rhs[i]))
+			return false;
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region mat4
+
+#pragma region Static Members
+
+template<typename T> const mat4_t<T> mat4_t<T>::zero = mat4_t<T>(T(0));
+template<typename T> const mat4_t<T> mat4_t<T>::identity = mat4_t<T>(T(1));
+
+#pragma endregion
+
+#pragma region Constructors
+
+
+
+#pragma endregion
+
+#pragma region Comparison Operators
+
+template<typename T> inline bool mat4_t<T>::operator==(const mat4_t &rhs) const
+{
+	for (int i = 0; i < 4; i++)
+		if ((*this)[i] != rhs[i])
+			return false;
+
+	return true;
+}
+
+template<> inline bool mat4_t<float>::operator==(const mat4_t<float> &rhs) const
+{
+	for (int i = 0; i < 4; i++)
+		if (!LINALG_FEQUAL((*this)[i], rhs[i]))
+			return false;
+
+	return true;
+}
+
+template<> inline bool mat4_t<double>::operator==(const mat4_t<double> &rhs) const
+{
+	for (int i = 0; i < 4; i++)
+		if (!LINALG_DEQUAL((*this)[i], rhs[i]))
+			return false;
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma region Screen Space Bounds
+
+// The screen space range along one axis of a sphere, from the planes through the eye tangent to the sphere.
+// Solves (A - kB)^2 = r^2 |a - kb|^2 for the normalized device coordinate k, where A and a are the axis row
+// of the matrix applied to the center and its linear part, and B and b likewise for the w row.
+template<typename T> inline bool _linalg_sphere_ndc_range(const vec4_t<T> &axis, const vec4_t<T> &w, const vec3_t<T> &center, const T radius, T &low, T &high)
+{
+	const vec3_t<T> a(axis.x, axis.y, axis.z), b(w.x, w.y, w.z);
+
+	const T A = a.dot(center) + axis.w;
+	const T B = b.dot(center) + w.w;
+	const T radiusSquared = radius * radius;
+
+	const T qa = B * B - radiusSquared * b.dot(b);
+	const T qb = A * B - radiusSquared * a.dot(b);
+	const T qc = A * A - radiusSquared * a.dot(a);
+
+	// The sphere must be entirely in front of the eye, i.e. at w > 0
+	if ((B <= T(0)) || (qa <= T(0)))
+		return false;
+
+	const T discriminant = qb * qb - qa * qc;
+	const T root = (discriminant > T(0)) ? sqrt(discriminant) : T(0);
+
+	low = (qb - root) / qa;
+	high = (qb + root) / qa;
+
+	return true;
+}
+
+template<typename T> void mat4_t<T>::projectSpheres(
+	const T *centerX, const T *centerY, const T *centerZ, const T *radius, const size_t count,
+	const mat4 &viewProjection, const ivec4 &viewport,
+	T *rectMinX, T *rectMinY, T *rectMaxX, T *rectMaxY, T *projectedRadius)
+{
+	const vec4 rowX = viewProjection.row(0), rowY = viewProjection.row(1), rowW = viewProjection.row(3);
+
+	const T halfWidth = T(viewport.z) * T(0.5), halfHeight = T(viewport.w) * T(0.5);
+	const T radiusScale = halfHeight * vec3(rowY.x, rowY.y, rowY.z).length();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const vec3 center(centerX[i], centerY[i], centerZ[i]);
+
+		T lowX, highX, lowY, highY;
+
+		if (!_linalg_sphere_ndc_range(rowX, rowW, center, radius[i], lowX, highX) || !_linalg_sphere_ndc_range(rowY, rowW, center, radius[i], lowY, highY))
+		{
+			rectMinX[i] = T(viewport.x);
+			rectMinY[i] = T(viewport.y);
+			rectMaxX[i] = T(viewport.x + viewport.z);
+			rectMaxY[i] = T(viewport.y + viewport.w);
+			projectedRadius[i] = T(HUGE_VAL);
+
+			continue;
+		}
+
+		rectMinX[i] = (lowX + T(1)) * halfWidth + T(viewport.x);
+		rectMinY[i] = (lowY + T(1)) * halfHeight + T(viewport.y);
+		rectMaxX[i] = (highX + T(1)) * halfWidth + T(viewport.x);
+		rectMaxY[i] = (highY + T(1)) * halfHeight + T(viewport.y);
+
+		projectedRadius[i] = radius[i] * radiusScale / (vec3(rowW.x, rowW.y, rowW.z).dot(center) + rowW.w);
+	}
+}
+
+template<typename T> void mat4_t<T>::projectAABBs(
+	const T *minX, const T *minY, const T *minZ,
+	const T *maxX, const T *maxY, const T *maxZ, const size_t count,
+	const mat4 &viewProjection, const ivec4 &viewport,
+	T *rectMinX, T *rectMinY, T *rectMaxX, T *rectMaxY, T *projectedRadius)
+{
+	const vec4 rowY = viewProjection.row(1), rowW = viewProjection.row(3);
+
+	const T halfWidth = T(viewport.z) * T(0.5), halfHeight = T(viewport.w) * T(0.5);
+	const T radiusScale = halfHeight * vec3(rowY.x, rowY.y, rowY.z).length();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const vec3 min(minX[i], minY[i], minZ[i]), max(maxX[i], maxY[i], maxZ[i]);
+
+		vec2 low = vec2(static_cast<T>(HUGE_VAL)), high = vec2(-static_cast<T>(HUGE_VAL));
+		bool inFront = true;
+
+		for (int j = 0; j < 8; j++)
+		{
+			const vec4 clip = viewProjection * vec4((j & 1) ? max.x : min.x, (j & 2) ? max.y : min.y, (j & 4) ? max.z : min.z, T(1));
+
+			if (clip.w <= T(0))
+			{
+				inFront = false;
+				break;
+			}
+
+			const vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+
+			low = low.min(ndc);
+			high = high.max(ndc);
+		}
+
+		const vec3 center = (min + max) * T(0.5);
+		const T w = vec3(rowW.x, rowW.y, rowW.z).dot(center) + rowW.w;
+
+		if (!inFront)
+		{
+			rectMinX[i] = T(viewport.x);
+			rectMinY[i] = T(viewport.y);
+			rectMaxX[i] = T(viewport.x + viewport.z);
+			rectMaxY[i] = T(viewport.y + viewport.w);
+			projectedRadius[i] = T(HUGE_VAL);
+
+			continue;
+		}
+
+		rectMinX[i] = (low.x + T(1)) * halfWidth + T(viewport.x);
+		rectMinY[i] = (low.y + T(1)) * halfHeight + T(viewport.y);
+		rectMaxX[i] = (high.x + T(1)) * halfWidth + T(viewport.x);
+		rectMaxY[i] = (high.y + T(1)) * halfHeight + T(viewport.y);
+
+		projectedRadius[i] = (max - min).length() * T(0.5) * radiusScale / w;
+	}
+}
+
+
+// Returns the screen space rectangles and projected radii of the 4 spheres starting at index
+inline void _linalg_project_spheres_4(
+	const fvec4 &rowX, const fvec4 &rowY, const fvec4 &rowW, const float radiusScale, const ivec4 &viewport,
+	const float *centerX, const float *centerY, const float *centerZ, const float *radius, const size_t index,
+	float *rectMinX, float *rectMinY, float *rectMaxX, float *rectMaxY, float *projectedRadius)
+{
+	const _linalg_float4 x = _linalg_float4::load(centerX + index);
+	const _linalg_float4 y = _linalg_float4::load(centerY + index);
+	const _linalg_float4 z = _linalg_float4::load(centerZ + index);
+	const _linalg_float4 r = _linalg_float4::load(radius + index);
+
+	const _linalg_float4 zero(0.0f), one(1.0f);
+	const _linalg_float4 radiusSquared = r * r;
+
+	const _linalg_float4 A[2] =
+	{
+		_linalg_float4(rowX.x) * x + _linalg_float4(rowX.y) * y + _linalg_float4(rowX.z) * z + _linalg_float4(rowX.w),
+		_linalg_float4(rowY.x) * x + _linalg_float4(rowY.y) * y + _linalg_float4(rowY.z) * z + _linalg_float4(rowY.w)
+	};
+
+	const _linalg_float4 B = _linalg_float4(rowW.x) * x + _linalg_float4(rowW.y) * y + _linalg_float4(rowW.z) * z + _linalg_float4(rowW.w);
+
+	const fvec3 b(rowW.x, rowW.y, rowW.z);
+	const fvec3 a[2] = { fvec3(rowX.x, rowX.y, rowX.z), fvec3(rowY.x, rowY.y, rowY.z) };
+
+	const _linalg_float4 qa = B * B - radiusSquared * _linalg_float4(b.dot(b));
+	const _linalg_float4 inFront = _linalg_and(_linalg_cmpgt(B, zero), _linalg_cmpgt(qa, zero));
+
+	const _linalg_float4 invQa = one / qa;
+
+	const float halfSize[2] = { float(viewport.z) * 0.5f, float(viewport.w) * 0.5f };
+	const float offset[2] = { float(viewport.x), float(viewport.y) };
+
+	float *rectMin[2] = { rectMinX, rectMinY };
+	float *rectMax[2] = { rectMaxX, rectMaxY };
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		const _linalg_float4 qb = A[axis] * B - radiusSquared * _linalg_float4(a[axis].dot(b));
+		const _linalg_float4 qc = A[axis] * A[axis] - radiusSquared * _linalg_float4(a[axis].dot(a[axis]));
+
+		const _linalg_float4 root = _linalg_sqrt(_linalg_max(qb * qb - qa * qc, zero));
+
+		const _linalg_float4 scale(halfSize[axis]), bias(halfSize[axis] + offset[axis]);
+
+		const _linalg_float4 low = ((qb - root) * invQa) * scale + bias;
+		const _linalg_float4 high = ((qb + root) * invQa) * scale + bias;
+
+		_linalg_select(inFront, low, _linalg_float4(offset[axis])).store(rectMin[axis] + index);
+		_linalg_select(inFront, high, _linalg_float4(offset[axis] + halfSize[axis] * 2.0f)).store(rectMax[axis] + index);
+	}
+
+	_linalg_select(inFront, r * _linalg_float4(radiusScale) / B, _linalg_float4(static_cast<float>(HUGE_VAL))).store(projectedRadius + index);
+}
+
+template<> inline void fmat4::projectSpheres(
+	const float *centerX, const float *centerY, const float *centerZ, const float *radius, const size_t count,
+	const fmat4 &viewProjection, const ivec4 &viewport,
+	float *rectMinX, float *rectMinY, float *rectMaxX, float *rectMaxY, float *projectedRadius)
+{
+	const fvec4 rowX = viewProjection.row(0), rowY = viewProjection.row(1), rowW = viewProjection.row(3);
+	const float radiusScale = float(viewport.w) * 0.5f * fvec3(rowY.x, rowY.y, rowY.z).length();
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+		_linalg_project_spheres_4(rowX, rowY, rowW, radiusScale, viewport, centerX, centerY, centerZ, radius, i, rectMinX, rectMinY, rectMaxX, rectMaxY, projectedRadius);
+
+	if (i < count)
+	{
+		const size_t n = count - i;
+
+		float buffer[9][4] = {};
+
+		for (size_t j = 0; j < n; j++)
+		{
+			buffer[0][j] = centerX[i + j];
+			buffer[1][j] = centerY[i + j];
+			buffer[2][j] = centerZ[i + j];
+			buffer[3][j] = radius[i + j];
+		}
+
+		_linalg_project_spheres_4(rowX, rowY, rowW, radiusScale, viewport, buffer[0], buffer[1], buffer[2], buffer[3], 0, buffer[4], buffer[5], buffer[6], buffer[7], buffer[8]);
+
+		for (size_t j = 0; j < n; j++)
+		{
+			rectMinX[i + j] = buffer[4][j];
+			rectMinY[i + j] = buffer[5][j];
+			rectMaxX[i + j] = buffer[6][j];
+			rectMaxY[i + j] = buffer[7][j];
+			projectedRadius[i + j] = buffer[8][j];
+		}
+	}
+}
+
+// Returns the screen space rectangles and projected radii of the 4 boxes starting at index
+inline void _linalg_project_aabbs_4(
+	const fmat4 &m, const float radiusScale, const ivec4 &viewport,
+	const float *min[3], const float *max[3], const size_t index,
+	float *rectMinX, float *rectMinY, float *rectMaxX, float *rectMaxY, float *projectedRadius)
+{
+	const _linalg_float4 bounds[2][3] =
+	{
+		{ _linalg_float4::load(min[0] + index), _linalg_float4::load(min[1] + index), _linalg_float4::load(min[2] + index) },
+		{ _linalg_float4::load(max[0] + index), _linalg_float4::load(max[1] + index), _linalg_float4::load(max[2] + index) }
+	};
+
+	const _linalg_float4 zero(0.0f), one(1.0f), half(0.5f);
+
+	const _linalg_float4 huge(static_cast<float>(HUGE_VAL)), negHuge(-static_cast<float>(HUGE_VAL));
+
+	_linalg_float4 lowX = huge, lowY = huge, highX = negHuge, highY = negHuge;
+	_linalg_float4 inFront = _linalg_cmpge(zero, zero);
+
+	for (int c = 0; c < 8; c++)
+	{
+		const _linalg_float4 &x = bounds[c & 1][0];
+		const _linalg_float4 &y = bounds[(c >> 1) & 1][1];
+		const _linalg_float4 &z = bounds[(c >> 2) & 1][2];
+
+		const _linalg_float4 clipX = _linalg_float4(m[0].x) * x + _linalg_float4(m[1].x) * y + _linalg_float4(m[2].x) * z + _linalg_float4(m[3].x);
+		const _linalg_float4 clipY = _linalg_float4(m[0].y) * x + _linalg_float4(m[1].y) * y + _linalg_float4(m[2].y) * z + _linalg_float4(m[3].y);
+		const _linalg_float4 clipW = _linalg_float4(m[0].w) * x + _linalg_float4(m[1].w) * y + _linalg_float4(m[2].w) * z + _linalg_float4(m[3].w);
+
+		inFront = _linalg_and(inFront, _linalg_cmpgt(clipW, zero));
+
+		const _linalg_float4 invW = one / clipW;
+
+		const _linalg_float4 ndcX = clipX * invW;
+		const _linalg_float4 ndcY = clipY * invW;
+
+		lowX = _linalg_min(lowX, ndcX);
+		lowY = _linalg_min(lowY, ndcY);
+		highX = _linalg_max(highX, ndcX);
+		highY = _linalg_max(highY, ndcY);
+	}
+
+	const _linalg_float4 halfWidth(float(viewport.z) * 0.5f), halfHeight(float(viewport.w) * 0.5f);
+	const _linalg_float4 biasX(float(viewport.z) * 0.5f + float(viewport.x)), biasY(float(viewport.w) * 0.5f + float(viewport.y));
+
+	_linalg_select(inFront, lowX * halfWidth + biasX, _linalg_float4(float(viewport.x))).store(rectMinX + index);
+	_linalg_select(inFront, lowY * halfHeight + biasY, _linalg_float4(float(viewport.y))).store(rectMinY + index);
+	_linalg_select(inFront, highX * halfWidth + biasX, _linalg_float4(float(viewport.x + viewport.z))).store(rectMaxX + index);
+	_linalg_select(inFront, highY * halfHeight + biasY, _linalg_float4(float(viewport.y + viewport.w))).store(rectMaxY + index);
+
+	// The radius of the enclosing sphere, at the w of the center
+	const _linalg_float4 dx = bounds[1][0] - bounds[0][0], dy = bounds[1][1] - bounds[0][1], dz = bounds[1][2] - bounds[0][2];
+	const _linalg_float4 radius = _linalg_sqrt(dx * dx + dy * dy + dz * dz) * half;
+
+	const _linalg_float4 cx = (bounds[0][0] + bounds[1][0]) * half, cy = (bounds[0][1] + bounds[1][1]) * half, cz = (bounds[0][2] + bounds[1][2]) * half;
+	const _linalg_float4 w = _linalg_float4(m[0].w) * cx + _linalg_float4(m[1].w) * cy + _linalg_float4(m[2].w) * cz + _linalg_float4(m[3].w);
+
+	_linalg_select(inFront, radius * _linalg_float4(radiusScale) / w, huge).store(projectedRadius + index);
+}
+
+template<> inline void fmat4::projectAABBs(
+	const float *minX, const float *minY, const float *minZ,
+	const float *maxX, const float *maxY, const float *maxZ, const size_t count,
+	const fmat4 &viewProjection, const ivec4 &viewport,
+	float *rectMinX, float *rectMinY, float *rectMaxX, float *rectMaxY, float *projectedRadius)
+{
+	const fvec4 rowY = viewProjection.row(1);
+	const float radiusScale = float(viewport.w) * 0.5f * fvec3(rowY.x, rowY.y, rowY.z).length();
+
+	const float *min[3] = { minX, minY, minZ };
+	const float *max[3] = { maxX, maxY, maxZ };
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+		_linalg_project_aabbs_4(viewProjection, radiusScale, viewport, min, max, i, rectMinX, rectMinY, rectMaxX, rectMaxY, projectedRadius);
+
+	if (i < count)
+	{
+		const size_t n = count - i;
+
+		float buffer[11][4] = {};
+
+		for (size_t j = 0; j < n; j++)
+			for (int k = 0; k < 3; k++)
+			{
+				buffer[k][j] = min[k][i + j];
+				buffer[k + 3][j] = max[k][i + j];
+			}
+
+		const float *bufferMin[3] = { buffer[0], buffer[1], buffer[2] };
+		const float *bufferMax[3] = { buffer[3], buffer[4], buffer[5] };
+
+		_linalg_project_aabbs_4(viewProjection, radiusScale, viewport, bufferMin, bufferMax, 0, buffer[6], buffer[7], buffer[8], buffer[9], buffer[10]);
+
+		for (size_t j = 0; j < n; j++)
+		{
+			rectMinX[i + j] = buffer[6][j];
+			rectMinY[i + j] = buffer[7][j];
+			rectMaxX[i + j] = buffer[8][j];
+			rectMaxY[i + j] = buffer[9][j];
+			projectedRadius[i + j] = buffer[10][j];
+		}
+	}
+}
+
+
+template<typename T> void mat4_t<T>::selectLODs(const T *projectedRadius, const size_t count, const T *thresholds, const size_t thresholdCount, unsigned char *lods)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned char lod = 0;
+
+		for (size_t j = 0; j < thresholdCount; j++)
+			lod += (projectedRadius[i] < thresholds[j]) ? 1 : 0;
+
+		lods[i] = lod;
+	}
+}
+
+#pragma endregion
+
+#pragma region Depth
+
+template<typename T> void mat4_t<T>::linearizeDepth(const T *depth, const size_t count, const mat4 &projection, T *result, const DepthRange depthRange)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = linearizeDepth(depth[i], projection, depthRange);
+}
+
+template<> inline void fmat4::linearizeDepth(const float *depth, const size_t count, const fmat4 &projection, float *result, const DepthRange depthRange)
+{
+	// Folding the depth range into the linearization, d = b / (depth * scale + bias)
+	const float scale = (depthRange == NegativeOneToOne) ? 2.0f : 1.0f;
+	const float bias = ((depthRange == NegativeOneToOne) ? -1.0f : 0.0f) + projection[2].z;
+
+	const _linalg_float4 scale4(scale), bias4(bias), b4(projection[3].z);
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+		(b4 / (_linalg_float4::load(depth + i) * scale4 + bias4)).store(result + i);
+
+	for (; i < count; i++)
+		result[i] = projection[3].z / (depth[i] * scale + bias);
+}
+
+#pragma endregion
+
+#pragma region Batch Look At
+
+// Sets the matrix with the given columns, leaving the bottom row of a mat4 at 0, 0, 0, 1
+template<typename T> inline void _linalg_set_columns(mat4_t<T> &m, const vec3_t<T> &c0, const vec3_t<T> &c1, const vec3_t<T> &c2, const vec3_t<T> &c3)
+{
+	m[0] = vec4_t<T>(c0, T(0));
+	m[1] = vec4_t<T>(c1, T(0));
+	m[2] = vec4_t<T>(c2, T(0));
+	m[3] = vec4_t<T>(c3, T(1));
+}
+
+template<typename T> inline void _linalg_set_columns(affine_t<T> &m, const vec3_t<T> &c0, const vec3_t<T> &c1, const vec3_t<T> &c2, const vec3_t<T> &c3)
+{
+	m.rows[0] = vec4_t<T>(c0.x, c1.x, c2.x, c3.x);
+	m.rows[1] = vec4_t<T>(c0.y, c1.y, c2.y, c3.y);
+	m.rows[2] = vec4_t<T>(c0.z, c1.z, c2.z, c3.z);
+}
+
+// Normalizes without a branch, where a zero vector stays zero
+template<typename T> inline vec3_t<T> _linalg_normalize_or_zero(const vec3_t<T> &v)
+{
+	const T lengthSquared = v.dot(v);
+	return v * (T(1) / sqrt((lengthSquared > T(1E-30)) ? lengthSquared : T(1E-30)));
+}
+
+template<typename T, typename Matrix> void _linalg_look_at(
+	const T *eyeX, const T *eyeY, const T *eyeZ, const T *atX, const T *atY, const T *atZ,
+	const size_t begin, const size_t end, const vec3_t<T> &up, Matrix *result)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		const vec3_t<T> eye(eyeX[i], eyeY[i], eyeZ[i]);
+
+		const vec3_t<T> forward = _linalg_normalize_or_zero(vec3_t<T>(atX[i], atY[i], atZ[i]) - eye);
+		const vec3_t<T> right = _linalg_normalize_or_zero(forward.cross(up));
+		const vec3_t<T> upNew = right.cross(forward);
+
+		_linalg_set_columns(result[i],
+			vec3_t<T>(right.x, upNew.x, -forward.x),
+			vec3_t<T>(right.y, upNew.y, -forward.y),
+			vec3_t<T>(right.z, upNew.z, -forward.z),
+			vec3_t<T>(-right.dot(eye), -upNew.dot(eye), forward.dot(eye)));
+	}
+}
+
+template<typename T, typename Matrix> void _linalg_billboards(
+	const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+	const size_t begin, const size_t end, const vec3_t<T> &eye, const vec3_t<T> &up, const bool constrained, Matrix *result)
+{
+	const vec3_t<T> axis = _linalg_normalize_or_zero(up);
+
+	for (size_t i = begin; i < end; i++)
+	{
+		const vec3_t<T> position(positionX[i], positionY[i], positionZ[i]);
+		const vec3_t<T> toEye = eye - position;
+
+		vec3_t<T> forward, right, upNew;
+
+		if (constrained)
+		{
+			// Facing the eye as far as rotating around the axis allows
+			forward = _linalg_normalize_or_zero(toEye - axis * axis.dot(toEye));
+			right = axis.cross(forward);
+			upNew = axis;
+		}
+		else
+		{
+			forward = _linalg_normalize_or_zero(toEye);
+			right = _linalg_normalize_or_zero(up.cross(forward));
+			upNew = forward.cross(right);
+		}
+
+		const T s = scale ? scale[i] : T(1);
+
+		_linalg_set_columns(result[i], right * s, upNew * s, forward * s, position);
+	}
+}
+
+template<typename T> void mat4_t<T>::lookAt(
+	const T *eyeX, const T *eyeY, const T *eyeZ, const T *atX, const T *atY, const T *atZ,
+	const size_t count, const vec3 &up, mat4 *result)
+{
+	_linalg_look_at(eyeX, eyeY, eyeZ, atX, atY, atZ, 0, count, up, result);
+}
+
+template<typename T> void mat4_t<T>::lookAt(
+	const T *eyeX, const T *eyeY, const T *eyeZ, const T *atX, const T *atY, const T *atZ,
+	const size_t count, const vec3 &up, affine_t<T> *result)
+{
+	_linalg_look_at(eyeX, eyeY, eyeZ, atX, atY, atZ, 0, count, up, result);
+}
+
+template<typename T> void mat4_t<T>::billboards(
+	const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+	const size_t count, const vec3 &eye, const vec3 &up, mat4 *result)
+{
+	_linalg_billboards(positionX, positionY, positionZ, scale, 0, count, eye, up, false, result);
+}
+
+template<typename T> void mat4_t<T>::billboards(
+	const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+	const size_t count, const vec3 &eye, const vec3 &up, affine_t<T> *result)
+{
+	_linalg_billboards(positionX, positionY, positionZ, scale, 0, count, eye, up, false, result);
+}
+
+template<typename T> void mat4_t<T>::axisBillboards(
+	const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+	const size_t count, const vec3 &eye, const vec3 &axis, mat4 *result)
+{
+	_linalg_billboards(positionX, positionY, positionZ, scale, 0, count, eye, axis, true, result);
+}
+
+template<typename T> void mat4_t<T>::axisBillboards(
+	const T *positionX, const T *positionY, const T *positionZ, const T *scale,
+	const size_t count, const vec3 &eye, const vec3 &axis, affine_t<T> *result)
+{
+	_linalg_billboards(positionX, positionY, positionZ, scale, 0, count, eye, axis, true, result);
+}
+
+
+// Stores 4 matrices given as lanes of their elements m[row][column], leaving the bottom row of a mat4 at 0, 0, 0, 1
+inline void _linalg_store_matrices_4(fmat4 *matrices, const _linalg_float4 m[3][4])
+{
+	float *out = reinterpret_cast<float*>(matrices);
+
+	const _linalg_float4 zero(0.0f), one(1.0f);
+
+	for (int c = 0; c < 4; c++)
+	{
+		_linalg_float4 a = m[0][c], b = m[1][c], d = m[2][c], e = (c == 3) ? one : zero;
+		_linalg_transpose4(a, b, d, e);
+
+		a.store(out + 0 + c * 4);
+		b.store(out + 16 + c * 4);
+		d.store(out + 32 + c * 4);
+		e.store(out + 48 + c * 4);
+	}
+}
+
+inline void _linalg_store_matrices_4(faffine *matrices, const _linalg_float4 m[3][4])
+{
+	float *out = reinterpret_cast<float*>(matrices);
+
+	for (int r = 0; r < 3; r++)
+	{
+		_linalg_float4 a = m[r][0], b = m[r][1], d = m[r][2], e = m[r][3];
+		_linalg_transpose4(a, b, d, e);
+
+		a.store(out + 0 + r * 4);
+		b.store(out + 12 + r * 4);
+		d.store(out + 24 + r * 4);
+		e.store(out + 36 + r * 4);
+	}
+}
+
+// Normalizes 4 vectors given as lanes, where a zero vector stays zero
+inline void _linalg_normalize_or_zero_4(_linalg_float4 &x, _linalg_float4 &y, _linalg_float4 &z)
+{
+	const _linalg_float4 invLength = _linalg_float4(1.0f) / _linalg_sqrt(_linalg_max(x * x + y * y + z * z, _linalg_float4(1E-30f)));
+
+	x = x * invLength;
+	y = y * invLength;
+	z = z * invLength;
+}
+
+template<typename Matrix> void _linalg_look_at_4(
+	const float *eyeX, const float *eyeY, const float *eyeZ, const float *atX, const float *atY, const float *atZ,
+	const size_t count, const fvec3 &up, Matrix *result)
+{
+	const _linalg_float4 upX(up.x), upY(up.y), upZ(up.z);
+	const _linalg_float4 zero(0.0f);
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		const _linalg_float4 ex = _linalg_float4::load(eyeX + i), ey = _linalg_float4::load(eyeY + i), ez = _linalg_float4::load(eyeZ + i);
+
+		_linalg_float4 fx = _linalg_float4::load(atX + i) - ex, fy = _linalg_float4::load(atY + i) - ey, fz = _linalg_float4::load(atZ + i) - ez;
+		_linalg_normalize_or_zero_4(fx, fy, fz);
+
+		// right = forward x up
+		_linalg_float4 rx = fy * upZ - fz * upY, ry = fz * upX - fx * upZ, rz = fx * upY - fy * upX;
+		_linalg_normalize_or_zero_4(rx, ry, rz);
+
+		// up = right x forward
+		const _linalg_float4 ux = ry * fz - rz * fy, uy = rz * fx - rx * fz, uz = rx * fy - ry * fx;
+
+		const _linalg_float4 m[3][4] =
+		{
+			{ rx, ry, rz, zero - (rx * ex + ry * ey + rz * ez) },
+			{ ux, uy, uz, zero - (ux * ex + uy * ey + uz * ez) },
+			{ zero - fx, zero - fy, zero - fz, fx * ex + fy * ey + fz * ez }
+		};
+
+		_linalg_store_matrices_4(result + i, m);
+	}
+
+	_linalg_look_at(eyeX, eyeY, eyeZ, atX, atY, atZ, i, count, up, result);
+}
+
+template<typename Matrix> void _linalg_billboards_4(
+	const float *positionX, const float *positionY, const float *positionZ, const float *scale,
+	const size_t count, const fvec3 &eye, const fvec3 &up, const bool constrained, Matrix *result)
+{
+	const fvec3 axis = _linalg_normalize_or_zero(up);
+
+	const _linalg_float4 eyeX(eye.x), eyeY(eye.y), eyeZ(eye.z);
+	const _linalg_float4 upX(constrained ? axis.x : up.x), upY(constrained ? axis.y : up.y), upZ(constrained ? axis.z : up.z);
+	const _linalg_float4 one(1.0f);
+
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		const _linalg_float4 px = _linalg_float4::load(positionX + i), py = _linalg_float4::load(positionY + i), pz = _linalg_float4::load(positionZ + i);
+
+		_linalg_float4 fx = eyeX - px, fy = eyeY - py, fz = eyeZ - pz;
+		_linalg_float4 rx, ry, rz, ux, uy, uz;
+
+		if (constrained)
+		{
+			// Facing the eye as far as rotating around the axis allows
+			const _linalg_float4 d = fx * upX + fy * upY + fz * upZ;
+
+			fx = fx - upX * d;
+			fy = fy - upY * d;
+			fz = fz - upZ * d;
+
+			_linalg_normalize_or_zero_4(fx, fy, fz);
+
+			// right = axis x forward
+			rx = upY * fz - upZ * fy;
+			ry = upZ * fx - upX * fz;
+			rz = upX * fy - upY * fx;
+
+			ux = upX;
+			uy = upY;
+			uz = upZ;
+		}
+		else
+		{
+			_linalg_normalize_or_zero_4(fx, fy, fz);
+
+			// right = up x forward
+			rx = upY * fz - upZ * fy;
+			ry = upZ * fx - upX * fz;
+			rz = upX * fy - upY * fx;
+
+			_linalg_normalize_or_zero_4(rx, ry, rz);
+
+			// up = forward x right
+			ux = fy * rz - fz * ry;
+			uy = fz * rx - fx * rz;
+			uz = fx * ry - fy * rx;
+		}
+
+		const _linalg_float4 s = scale ? _linalg_float4::load(scale + i) : one;
+
+		const _linalg_float4 m[3][4] =
+		{
+			{ rx * s, ux * s, fx * s, px },
+			{ ry * s, uy * s, fy * s, py },
+			{ rz * s, uz * s, fz * s, pz }
+		};
+
+		_linalg_store_matrices_4(result + i, m);
+	}
+
+	_linalg_billboards(positionX, positionY, positionZ, scale, i, count, eye, up, constrained, result);
+}
+
+template<> inline void fmat4::lookAt(
+	const float *eyeX, const float *eyeY, const float *eyeZ, const float *atX, const float *atY, const float *atZ,
+	const size_t count, const fvec3 &up, fmat4 *result)
+{
+	_linalg_look_at_4(eyeX, eyeY, eyeZ, atX, atY, atZ, count, up, result);
+}
+
+template<> inline void fmat4::lookAt(
+	const float *eyeX, const float *eyeY, const float *eyeZ, const float *atX, const float *atY, const float *atZ,
+	const size_t count, const fvec3 &up, faffine *result)
+{
+	_linalg_look_at_4(eyeX, eyeY, eyeZ, atX, atY, atZ, count, up, result);
+}
+
+template<> inline void fmat4::billboards(
+	const float *positionX, const float *positionY, const float *positionZ, const float *scale,
+	const size_t count, const fvec3 &eye, const fvec3 &up, fmat4 *result)
+{
+	_linalg_billboards_4(positionX, positionY, positionZ, scale, count, eye, up, false, result);
+}
+
+template<> inline void fmat4::billboards(
+	const float *positionX, const float *positionY, const float *positionZ, const float *scale,
+	const size_t count, const fvec3 &eye, const fvec3 &up, faffine *result)
+{
+	_linalg_billboards_4(positionX, positionY, positionZ, scale, count, eye, up, false, result);
+}
+
+template<> inline void fmat4::axisBillboards(
+	const float *positionX, const float *positionY, const float *positionZ, const float *scale,
+	const size_t count, const fvec3 &eye, const fvec3 &axis, fmat4 *result)
+{
+	_linalg_billboards_4(positionX, positionY, positionZ, scale, count, eye, axis, true, result);
+}
+
+template<> inline void fmat4::axisBillboards(
+	const float *positionX, const float *positionY, const float *positionZ, const float *scale,
+	const size_t count, const fvec3 &eye, const fvec3 &axis, faffine *result)
+{
+	_linalg_billboards_4(positionX, positionY, positionZ, scale, count, eye, axis, true, result);
+}
+
+#pragma endregion
+
+#pragma region Cube Map
+
+// The rows of the view rotation of each face, i.e. right, up and backward
+static const signed char _linalg_cube_map_axes[6][3][3] =
+{
+	{ { 0, 0, -1 }, { 0, -1, 0 }, { -1, 0, 0 } },
+	{ { 0, 0, 1 }, { 0, -1, 0 }, { 1, 0, 0 } },
+	{ { 1, 0, 0 }, { 0, 0, 1 }, { 0, -1, 0 } },
+	{ { 1, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 } },
+	{ { 1, 0, 0 }, { 0, -1, 0 }, { 0, 0, -1 } },
+	{ { -1, 0, 0 }, { 0, -1, 0 }, { 0, 0, 1 } }
+};
+
+template<typename T> mat4_t<T> mat4_t<T>::cubeMapView(const vec3 &position, const CubeMapFace face)
+{
+	const signed char (&axes)[3][3] = _linalg_cube_map_axes[face];
+
+	mat4 m = mat4::identity;
+
+	for (int r = 0; r < 3; r++)
+	{
+		const vec3 axis(T(axes[r][0]), T(axes[r][1]), T(axes[r][2]));
+
+		m[0][r] = axis.x;
+		m[1][r] = axis.y;
+		m[2][r] = axis.z;
+		m[3][r] = -axis.dot(position);
+	}
+
+	return m;
+}
+
+// A cube map at position only differs from the one at the origin by a translation, which
+// moves column 3 of the view-projection and the distances of the frustum planes
+template<typename T> inline void _linalg_cube_map_faces(
+	const mat4_t<T> &projection, const typename mat4_t<T>::DepthRange depthRange,
+	mat4_t<T> viewProjections[6], frustum_t<T> frustums[6])
+{
+	for (int face = 0; face < 6; face++)
+	{
+		viewProjections[face] = projection * mat4_t<T>::cubeMapView(vec3_t<T>::zero, static_cast<typename mat4_t<T>::CubeMapFace>(face));
+		frustums[face] = frustum_t<T>(viewProjections[face], depthRange);
+	}
+}
+
+template<typename T> void mat4_t<T>::cubeMaps(
+	const T *positionX, const T *positionY, const T *positionZ, const size_t count,
+	const mat4 &projection, mat4 *viewProjections, frustum_t<T> *frustums,
+	const DepthRange depthRange)
+{
+	mat4 origins[CubeMapFaceCount];
+	frustum_t<T> originFrustums[CubeMapFaceCount];
+
+	_linalg_cube_map_faces(projection, depthRange, origins, originFrustums);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const vec4 translation(-positionX[i], -positionY[i], -positionZ[i], T(1));
+
+		for (int face = 0; face < CubeMapFaceCount; face++)
+		{
+			mat4 &m = viewProjections[i * CubeMapFaceCount + face];
+
+			m = origins[face];
+			m[3] = origins[face] * translation;
+
+			if (frustums)
+			{
+				frustum_t<T> &frustum = frustums[i * CubeMapFaceCount + face];
+
+				for (int plane = 0; plane < frustum_t<T>::PlaneCount; plane++)
+				{
+					const vec4 &p = originFrustums[face].planes[plane];
+
+					frustum.planes[plane] = vec4(p.x, p.y, p.z, p.dot(translation));
+				}
+			}
+		}
+	}
+}
+
+template<> inline void fmat4::cubeMaps(
+	const float *positionX, const float *positionY, const float *positionZ, const size_t count,
+	const fmat4 &projection, fmat4 *viewProjections, ffrustum *frustums,
+	const DepthRange depthRange)
+{
+	fmat4 origins[CubeMapFaceCount];
+	ffrustum originFrustums[CubeMapFaceCount];
+
+	_linalg_cube_map_faces(projection, depthRange, origins, originFrustums);
+
+	_linalg_float4 columns[CubeMapFaceCount][4];
+
+	for (int face = 0; face < CubeMapFaceCount; face++)
+		for (int c = 0; c < 4; c++)
+			columns[face][c] = _linalg_float4::load(&origins[face][c].x);
+
+	// The 36 planes of the 6 frustums as 9 groups of 4, in lanes of their components
+	_linalg_float4 planes[9][4];
+
+	for (int group = 0; group < 9; group++)
+	{
+		for (int k = 0; k < 4; k++)
+			planes[group][k] = _linalg_float4::load(&originFrustums[(group * 4 + k) / 6].planes[(group * 4 + k) % 6].x);
+
+		_linalg_transpose4(planes[group][0], planes[group][1], planes[group][2], planes[group][3]);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const _linalg_float4 x(-positionX[i]), y(-positionY[i]), z(-positionZ[i]);
+
+		float *out = &viewProjections[i * CubeMapFaceCount][0].x;
+
+		for (int face = 0; face < CubeMapFaceCount; face++)
+		{
+			const _linalg_float4 *c = columns[face];
+
+			c[0].store(out + 0);
+			c[1].store(out + 4);
+			c[2].store(out + 8);
+			(c[0] * x + c[1] * y + c[2] * z + c[3]).store(out + 12);
+
+			out += 16;
+		}
+
+		if (frustums)
+		{
+			float *planeOut = &frustums[i * CubeMapFaceCount].planes[0].x;
+
+			for (int group = 0; group < 9; group++)
+			{
+				_linalg_float4 a = planes[group][0], b = planes[group][1], c = planes[group][2];
+				_linalg_float4 d = a * x + b * y + c * z + planes[group][3];
+
+				_linalg_transpose4(a, b, c, d);
+
+				a.store(planeOut + 0);
+				b.store(planeOut + 4);
+				c.store(planeOut + 8);
+				d.store(planeOut + 12);
+
+				planeOut += 16;
+			}
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Diff
+
+template<typename T> inline bool _linalg_mat4_differs(const mat4_t<T> &a, const mat4_t<T> &b, const T epsilon)
+{
+	const T *lhs = reinterpret_cast<const T*>(&a), *rhs = reinterpret_cast<const T*>(&b);
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (lhs[i] == rhs[i])
+			continue;
+
+		const T difference = (lhs[i] > rhs[i]) ? (lhs[i] - rhs[i]) : (rhs[i] - lhs[i]);
+
+		// Written as not within, such that NaN counts as changed
+		if (!(difference <= epsilon))
+			return true;
+	}
+
+	return false;
+}
+
+inline bool _linalg_mat4_differs(const fmat4 &a, const fmat4 &b, const float epsilon)
+{
+	const float *lhs = reinterpret_cast<const float*>(&a), *rhs = reinterpret_cast<const float*>(&b);
+
+	const _linalg_float4 e(epsilon);
+
+	int equal = 0xF;
+
+	for (int c = 0; c < 16; c += 4)
+	{
+		const _linalg_float4 l = _linalg_float4::load(lhs + c), r = _linalg_float4::load(rhs + c);
+
+		_linalg_float4 mask = _linalg_and(_linalg_cmple(l, r), _linalg_cmpge(l, r));
+
+		if (epsilon > 0.0f)
+			mask = _linalg_or(mask, _linalg_cmple(_linalg_abs(l - r), e));
+
+		equal &= _linalg_movemask(mask);
+	}
+
+	return (equal != 0xF);
+}
+
+template<typename T> size_t mat4_t<T>::diff(const mat4 *current, const mat4 *previous, const size_t count, unsigned char *changed, const T epsilon)
+{
+	size_t changedCount = 0;
+
+	for (size_t i = 0; i < count; i += 8)
+	{
+		const size_t end = ((i + 8) < count) ? (i + 8) : count;
+
+		unsigned int bits = 0;
+
+		for (size_t j = i; j < end; j++)
+			if (_linalg_mat4_differs(current[j], previous[j], epsilon))
+				bits |= (1u << (j - i));
+
+		changed[i / 8] = static_cast<unsigned char>(bits);
+
+		for (; bits; bits &= bits - 1)
+			changedCount++;
+	}
+
+	return changedCount;
+}
+
+template<typename T> size_t mat4_t<T>::diffRanges(const mat4 *current, const mat4 *previous, const size_t count, size_t *ranges, const T epsilon, const size_t gap)
+{
+	size_t rangeCount = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!_linalg_mat4_differs(current[i], previous[i], epsilon))
+			continue;
+
+		if ((rangeCount > 0) && ((i - ranges[rangeCount * 2 - 1]) <= gap))
+			ranges[rangeCount * 2 - 1] = i + 1;
+		else
+		{
+			ranges[rangeCount * 2 + 0] = i;
+			ranges[rangeCount * 2 + 1] = i + 1;
+
+			rangeCount++;
+		}
+	}
+
+	return rangeCount;
+}
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region affine
+
+#pragma region Static Members
+
+template<typename T> const affine_t<T> affine_t<T>::zero = affine_t<T>(T(0));
+template<typename T> const affine_t<T> affine_t<T>::identity = affine_t<T>(T(1));
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region quat
+
+#pragma region Static Members
+
+template<typename T> const quat_t<T> quat_t<T>::zero = vec4_t<T>(T(0), T(0), T(0), T(0));
+template<typename T> const quat_t<T> quat_t<T>::one = vec4_t<T>(T(1), T(1), T(1), T(1));
+
+template<typename T> const quat_t<T> quat_t<T>::identity = vec4_t<T>(T(0), T(0), T(0), T(1));
+
+#pragma endregion
+
+#pragma region Matrix Conversion
+
+template<typename T> void quat_t<T>::toMat3(const quat *quats, mat3 *matrices, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		matrices[i] = quats[i].toMat3();
+}
+
+template<typename T> void quat_t<T>::toMat4(const quat *quats, mat4 *matrices, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		matrices[i] = quats[i].toMat4();
+}
+
+template<typename T> void quat_t<T>::fromMat3(const mat3 *matrices, quat *quats, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		quats[i] = quat::fromMat3(matrices[i]);
+}
+
+template<typename T> void quat_t<T>::fromMat4(const mat4 *matrices, quat *quats, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		quats[i] = quat::fromMat4(matrices[i]);
+}
+
+
+// Computes the rotation matrix elements of 4 quaternions at a time, with r[row][column]
+inline void _linalg_quat_to_mat3_4(const fquat *quats, _linalg_float4 r[3][3])
+{
+	_linalg_float4 x = _linalg_float4::load(&quats[0].x);
+	_linalg_float4 y = _linalg_float4::load(&quats[1].x);
+	_linalg_float4 z = _linalg_float4::load(&quats[2].x);
+	_linalg_float4 w = _linalg_float4::load(&quats[3].x);
+
+	_linalg_transpose4(x, y, z, w);
+
+	const _linalg_float4 one(1.0f), two(2.0f);
+
+	const _linalg_float4 xx = x * x, yy = y * y, zz = z * z;
+	const _linalg_float4 xy = x * y, xz = x * z, yz = y * z;
+	const _linalg_float4 wx = w * x, wy = w * y, wz = w * z;
+
+	r[0][0] = one - two * (yy + zz);
+	r[1][0] = two * (xy + wz);
+	r[2][0] = two * (xz - wy);
+
+	r[0][1] = two * (xy - wz);
+	r[1][1] = one - two * (xx + zz);
+	r[2][1] = two * (yz + wx);
+
+	r[0][2] = two * (xz + wy);
+	r[1][2] = two * (yz - wx);
+	r[2][2] = one - two * (xx + yy);
+}
+
+// Shepperd's method for 4 matrices at a time, see quat_t<T>::fromMat3()
+inline void _linalg_mat3_to_quat_4(const _linalg_float4 r[3][3], fquat *quats)
+{
+	const _linalg_float4 one(1.0f), half(0.5f);
+
+	const _linalg_float4 tw = one + r[0][0] + r[1][1] + r[2][2];
+	const _linalg_float4 tx = one + r[0][0] - r[1][1] - r[2][2];
+	const _linalg_float4 ty = one - r[0][0] + r[1][1] - r[2][2];
+	const _linalg_float4 tz = one - r[0][0] - r[1][1] + r[2][2];
+
+	const _linalg_float4 t = _linalg_max(_linalg_max(tw, tx), _linalg_max(ty, tz));
+
+	const _linalg_float4 d0 = r[2][1] - r[1][2], d1 = r[0][2] - r[2][0], d2 = r[1][0] - r[0][1];
+	const _linalg_float4 s0 = r[0][1] + r[1][0], s1 = r[0][2] + r[2][0], s2 = r[1][2] + r[2][1];
+
+	// Start from the z case and let w, x and y override in order of priority
+	_linalg_float4 x = s1, y = s2, z = t, w = d2;
+
+	const _linalg_float4 isY = _linalg_cmpge(ty, t);
+	x = _linalg_select(isY, s0, x); y = _linalg_select(isY, t, y); z = _linalg_select(isY, s2, z); w = _linalg_select(isY, d1, w);
+
+	const _linalg_float4 isX = _linalg_cmpge(tx, t);
+	x = _linalg_select(isX, t, x); y = _linalg_select(isX, s0, y); z = _linalg_select(isX, s1, z); w = _linalg_select(isX, d0, w);
+
+	const _linalg_float4 isW = _linalg_cmpge(tw, t);
+	x = _linalg_select(isW, d0, x); y = _linalg_select(isW, d1, y); z = _linalg_select(isW, d2, z); w = _linalg_select(isW, t, w);
+
+	const _linalg_float4 s = half / _linalg_sqrt(t);
+
+	x = x * s;
+	y = y * s;
+	z = z * s;
+	w = w * s;
+
+	_linalg_transpose4(x, y, z, w);
+
+	x.store(&quats[0].x);
+	y.store(&quats[1].x);
+	z.store(&quats[2].x);
+	w.store(&quats[3].x);
+}
+
+template<> inline void fquat::toMat3(const fquat *quats, fmat3 *matrices, const size_t count)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 r[3][3];
+		_linalg_quat_to_mat3_4(quats + i, r);
+
+		// Each mat3 is 9 floats, so write the first 8 as two
+		// transposed blocks and the last element separately
+		_linalg_float4 a0 = r[0][0], a1 = r[1][0], a2 = r[2][0], a3 = r[0][1];
+		_linalg_float4 b0 = r[1][1], b1 = r[2][1], b2 = r[0][2], b3 = r[1][2];
+
+		_linalg_transpose4(a0, a1, a2, a3);
+		_linalg_transpose4(b0, b1, b2, b3);
+
+		float *out = reinterpret_cast<float*>(matrices + i);
+
+		a0.store(out + 0); b0.store(out + 4); out[8] = r[2][2][0];
+		a1.store(out + 9); b1.store(out + 13); out[17] = r[2][2][1];
+		a2.store(out + 18); b2.store(out + 22); out[26] = r[2][2][2];
+		a3.store(out + 27); b3.store(out + 31); out[35] = r[2][2][3];
+	}
+
+	for (; i < count; i++)
+		matrices[i] = quats[i].toMat3();
+}
+
+template<> inline void fquat::toMat4(const fquat *quats, fmat4 *matrices, const size_t count)
+{
+	size_t i = 0;
+
+	const _linalg_float4 zero(0.0f);
+	const _linalg_float4 column3(0.0f, 0.0f, 0.0f, 1.0f);
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 r[3][3];
+		_linalg_quat_to_mat3_4(quats + i, r);
+
+		float *out = reinterpret_cast<float*>(matrices + i);
+
+		for (int c = 0; c < 3; c++)
+		{
+			_linalg_float4 a = r[0][c], b = r[1][c], d = r[2][c], e = zero;
+			_linalg_transpose4(a, b, d, e);
+
+			a.store(out + 0 + c * 4);
+			b.store(out + 16 + c * 4);
+			d.store(out + 32 + c * 4);
+			e.store(out + 48 + c * 4);
+		}
+
+		column3.store(out + 12);
+		column3.store(out + 28);
+		column3.store(out + 44);
+		column3.store(out + 60);
+	}
+
+	for (; i < count; i++)
+		matrices[i] = quats[i].toMat4();
+}
+
+template<> inline void fquat::fromMat3(const fmat3 *matrices, fquat *quats, const size_t count)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		const float *in = reinterpret_cast<const float*>(matrices + i);
+
+		_linalg_float4 a0 = _linalg_float4::load(in + 0), a1 = _linalg_float4::load(in + 9);
+		_linalg_float4 a2 = _linalg_float4::load(in + 18), a3 = _linalg_float4::load(in + 27);
+
+		_linalg_float4 b0 = _linalg_float4::load(in + 4), b1 = _linalg_float4::load(in + 13);
+		_linalg_float4 b2 = _linalg_float4::load(in + 22), b3 = _linalg_float4::load(in + 31);
+
+		_linalg_transpose4(a0, a1, a2, a3);
+		_linalg_transpose4(b0, b1, b2, b3);
+
+		const _linalg_float4 r[3][3] = {
+			{ a0, a3, b2 },
+			{ a1, b0, b3 },
+			{ a2, b1, _linalg_float4(in[8], in[17], in[26], in[35]) },
+		};
+
+		_linalg_mat3_to_quat_4(r, quats + i);
+	}
+
+	for (; i < count; i++)
+		quats[i] = fquat::fromMat3(matrices[i]);
+}
+
+template<> inline void fquat::fromMat4(const fmat4 *matrices, fquat *quats, const size_t count)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		const float *in = reinterpret_cast<const float*>(matrices + i);
+
+		_linalg_float4 r[3][3];
+
+		for (int c = 0; c < 3; c++)
+		{
+			_linalg_float4 a = _linalg_float4::load(in + 0 + c * 4);
+			_linalg_float4 b = _linalg_float4::load(in + 16 + c * 4);
+			_linalg_float4 d = _linalg_float4::load(in + 32 + c * 4);
+			_linalg_float4 e = _linalg_float4::load(in + 48 + c * 4);
+
+			_linalg_transpose4(a, b, d, e);
+
+			r[0][c] = a;
+			r[1][c] = b;
+			r[2][c] = d;
+		}
+
+		_linalg_mat3_to_quat_4(r, quats + i);
+	}
+
+	for (; i < count; i++)
+		quats[i] = fquat::fromMat4(matrices[i]);
+}
+
+#pragma endregion
+
+#pragma region Rotation
+
+template<typename T> void quat_t<T>::rotate(const quat &q, const vec3 *vectors, vec3 *result, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = q.rotate(vectors[i]);
+}
+
+template<typename T> void quat_t<T>::rotate(const quat *quats, const vec3 *vectors, vec3 *result, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = quats[i].rotate(vectors[i]);
+}
+
+
+inline void _linalg_quat_rotate_4(
+	const _linalg_float4 &qx, const _linalg_float4 &qy, const _linalg_float4 &qz, const _linalg_float4 &qw,
+	_linalg_float4 &x, _linalg_float4 &y, _linalg_float4 &z)
+{
+	const _linalg_float4 two(2.0f);
+
+	const _linalg_float4 tx = two * (qy * z - qz * y);
+	const _linalg_float4 ty = two * (qz * x - qx * z);
+	const _linalg_float4 tz = two * (qx * y - qy * x);
+
+	x = x + qw * tx + (qy * tz - qz * ty);
+	y = y + qw * ty + (qz * tx - qx * tz);
+	z = z + qw * tz + (qx * ty - qy * tx);
+}
+
+template<> inline void fquat::rotate(const fquat &q, const fvec3 *vectors, fvec3 *result, const size_t count)
+{
+	size_t i = 0;
+
+	const _linalg_float4 qx(q.x), qy(q.y), qz(q.z), qw(q.w);
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&vectors[i].x, x, y, z);
+
+		_linalg_quat_rotate_4(qx, qy, qz, qw, x, y, z);
+
+		_linalg_store3x4(&result[i].x, x, y, z);
+	}
+
+	for (; i < count; i++)
+		result[i] = q.rotate(vectors[i]);
+}
+
+template<> inline void fquat::rotate(const fquat *quats, const fvec3 *vectors, fvec3 *result, const size_t count)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 qx = _linalg_float4::load(&quats[i + 0].x);
+		_linalg_float4 qy = _linalg_float4::load(&quats[i + 1].x);
+		_linalg_float4 qz = _linalg_float4::load(&quats[i + 2].x);
+		_linalg_float4 qw = _linalg_float4::load(&quats[i + 3].x);
+
+		_linalg_transpose4(qx, qy, qz, qw);
+
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&vectors[i].x, x, y, z);
+
+		_linalg_quat_rotate_4(qx, qy, qz, qw, x, y, z);
+
+		_linalg_store3x4(&result[i].x, x, y, z);
+	}
+
+	for (; i < count; i++)
+		result[i] = quats[i].rotate(vectors[i]);
+}
+
+#pragma endregion
+
+#pragma region Interpolation
+
+template<typename T> void quat_t<T>::nlerp(const quat *from, const quat *to, const T t, quat *result, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = from[i].nlerp(to[i], t);
+}
+
+template<typename T> void quat_t<T>::slerpApprox(const quat *from, const quat *to, const T t, quat *result, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = from[i].slerpApprox(to[i], t);
+}
+
+
+inline void _linalg_load_quat4(const fquat *quats, _linalg_float4 &x, _linalg_float4 &y, _linalg_float4 &z, _linalg_float4 &w)
+{
+	x = _linalg_float4::load(&quats[0].x);
+	y = _linalg_float4::load(&quats[1].x);
+	z = _linalg_float4::load(&quats[2].x);
+	w = _linalg_float4::load(&quats[3].x);
+
+	_linalg_transpose4(x, y, z, w);
+}
+
+inline void _linalg_store_quat4(fquat *quats, _linalg_float4 x, _linalg_float4 y, _linalg_float4 z, _linalg_float4 w)
+{
+	_linalg_transpose4(x, y, z, w);
+
+	x.store(&quats[0].x);
+	y.store(&quats[1].x);
+	z.store(&quats[2].x);
+	w.store(&quats[3].x);
+}
+
+// See quat_t<T>::_slerpApproxCoefficient()
+inline _linalg_float4 _linalg_slerp_approx_coefficient(const _linalg_float4 &t, const _linalg_float4 &xm1)
+{
+	const _linalg_float4 one(1.0f);
+	const _linalg_float4 tt = t * t;
+
+	_linalg_float4 c = one + _linalg_float4(1.90110745351730037f) * (tt * _linalg_float4(1.0f / (8.0f * 17.0f)) - _linalg_float4(8.0f / 17.0f)) * xm1;
+
+	for (int i = 7; i >= 1; i--)
+		c = one + (tt - _linalg_float4(float(i * i))) * _linalg_float4(1.0f / float(i * (2 * i + 1))) * xm1 * c;
+
+	return t * c;
+}
+
+template<> inline void fquat::nlerp(const fquat *from, const fquat *to, const float t, fquat *result, const size_t count)
+{
+	size_t i = 0;
+
+	const _linalg_float4 one(1.0f), t4(t), signBit(-0.0f);
+	const _linalg_float4 scale0 = one - t4;
+
+	for (; (i + 4) <= count; i += 4)
 	{
-		len = to / len;
+		_linalg_float4 ax, ay, az, aw, bx, by, bz, bw;
+		_linalg_load_quat4(from + i, ax, ay, az, aw);
+		_linalg_load_quat4(to + i, bx, by, bz, bw);
 
-		return fvec2(*this) * len;
+		// Flip the sign of t where the dot product is negative
+		const _linalg_float4 d = ax * bx + ay * by + az * bz + aw * bw;
+		const _linalg_float4 scale1 = _linalg_xor(t4, _linalg_and(d, signBit));
+
+		_linalg_float4 x = scale0 * ax + scale1 * bx;
+		_linalg_float4 y = scale0 * ay + scale1 * by;
+		_linalg_float4 z = scale0 * az + scale1 * bz;
+		_linalg_float4 w = scale0 * aw + scale1 * bw;
+
+		const _linalg_float4 invLength = one / _linalg_sqrt(x * x + y * y + z * z + w * w);
+
+		_linalg_store_quat4(result + i, x * invLength, y * invLength, z * invLength, w * invLength);
 	}
 
-	return (*this);
+	for (; i < count; i++)
+		result[i] = from[i].nlerp(to[i], t);
 }
 
-template<> inline dvec2 dvec2::normalize(const double &to) const
+template<> inline void fquat::slerpApprox(const fquat *from, const fquat *to, const float t, fquat *result, const size_t count)
 {
-	double len = length();
+	size_t i = 0;
 
-	if (!LINALG_DEQUAL(len, 0.0) && !LINALG_DEQUAL(len, to))
+	const _linalg_float4 one(1.0f), t4(t), signBit(-0.0f);
+	const _linalg_float4 d4 = one - t4;
+
+	for (; (i + 4) <= count; i += 4)
 	{
-		len = to / len;
+		_linalg_float4 ax, ay, az, aw, bx, by, bz, bw;
+		_linalg_load_quat4(from + i, ax, ay, az, aw);
+		_linalg_load_quat4(to + i, bx, by, bz, bw);
 
-		return dvec2(*this) * len;
+		const _linalg_float4 d = ax * bx + ay * by + az * bz + aw * bw;
+		const _linalg_float4 sign = _linalg_and(d, signBit);
+		const _linalg_float4 xm1 = _linalg_abs(d) - one;
+
+		const _linalg_float4 scale0 = _linalg_slerp_approx_coefficient(d4, xm1);
+		const _linalg_float4 scale1 = _linalg_xor(_linalg_slerp_approx_coefficient(t4, xm1), sign);
+
+		_linalg_store_quat4(result + i,
+			scale0 * ax + scale1 * bx,
+			scale0 * ay + scale1 * by,
+			scale0 * az + scale1 * bz,
+			scale0 * aw + scale1 * bw);
 	}
 
-	return (*this);
+	for (; i < count; i++)
+		result[i] = from[i].slerpApprox(to[i], t);
 }
 
 #pragma endregion
 
-#pragma region Check Vector Kind
+#pragma region Tangent Frame
 
-template<typename T> bool vec2_t<T>::isNullVector() const
+// An orthonormal basis around a unit normal, such that the tangent angle refers to the same direction
+// when encoding and decoding. Reference: Duff et al., "Building an Orthonormal Basis, Revisited" (2017)
+template<typename T> inline void _linalg_orthonormal_basis(const vec3_t<T> &n, vec3_t<T> &b1, vec3_t<T> &b2)
 {
-	// It's faster to just compare to 0, than to calculate the length
-	return ((this->x == 0) && (this->y == 0));
+	const T sign = (n.z >= T(0)) ? T(1) : T(-1);
+	const T a = T(-1) / (sign + n.z);
+	const T b = n.x * n.y * a;
+
+	b1 = vec3_t<T>(T(1) + sign * n.x * n.x * a, sign * b, -sign * n.x);
+	b2 = vec3_t<T>(b, sign + n.y * n.y * a, -n.y);
 }
 
-template<> bool fvec2::isNullVector() const
+template<typename T> unsigned int quat_t<T>::encodeTangentFrame(const quat &frame, const bool reflected)
 {
-	// It's faster to just compare to 0, than to calculate the length
-	return (LINALG_FEQUAL(this->x, 0.0f) && LINALG_FEQUAL(this->y, 0.0f));
+	T u, v;
+	_linalg_octahedral_encode(frame.rotate(vec3(T(0), T(0), T(1))), u, v);
+
+	const unsigned int qu = unsigned(_linalg_snorm_encode(u, 511)) & 0x3FFu;
+	const unsigned int qv = unsigned(_linalg_snorm_encode(v, 511)) & 0x3FFu;
+
+	// The angle is relative to the basis of the normal as it's decoded
+	vec3 b1, b2;
+	_linalg_orthonormal_basis(_linalg_octahedral_decode(_linalg_snorm_decode<T>(qu, 511), _linalg_snorm_decode<T>(qv, 511)), b1, b2);
+
+	const vec3 tangent = frame.rotate(vec3(T(1), T(0), T(0)));
+
+	const T turns = atan2(tangent.dot(b2), tangent.dot(b1)) * T(0.5 / LINALG_PI);
+	const unsigned int angle = static_cast<unsigned int>(static_cast<int>(floor(turns * T(2048) + T(0.5)))) & 0x7FFu;
+
+	return qu | (qv << 10) | (angle << 20) | (reflected ? 0x80000000u : 0u);
 }
 
-template<> bool dvec2::isNullVector() const
+template<typename T> quat_t<T> quat_t<T>::decodeTangentFrame(const unsigned int encoded, bool *reflected)
 {
-	// It's faster to just compare to 0, than to calculate the length
-	return (LINALG_DEQUAL(this->x, 0.0) && LINALG_DEQUAL(this->y, 0.0));
+	if (reflected)
+		*reflected = ((encoded & 0x80000000u) != 0);
+
+	const vec3 normal = _linalg_octahedral_decode(_linalg_snorm_decode<T>(encoded, 511), _linalg_snorm_decode<T>(encoded >> 10, 511));
+
+	vec3 b1, b2;
+	_linalg_orthonormal_basis(normal, b1, b2);
+
+	const T angle = T((encoded >> 20) & 0x7FFu) * T(2.0 * LINALG_PI / 2048.0);
+	const vec3 tangent = b1 * cos(angle) + b2 * sin(angle);
+
+	return quat::fromMat3(mat3(tangent, normal.cross(tangent), normal));
 }
 
+template<typename T> void quat_t<T>::encodeTangentFrame(const quat *frames, const bool *reflected, const size_t count, unsigned int *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = encodeTangentFrame(frames[i], reflected ? reflected[i] : false);
+}
 
-template<> inline bool fvec2::isUnitVector() const
+template<typename T> void quat_t<T>::decodeTangentFrame(const unsigned int *encoded, const size_t count, quat *result, bool *reflected)
 {
-	return LINALG_FEQUAL(lengthSquared(), 1.0f);
+	for (size_t i = 0; i < count; i++)
+		result[i] = decodeTangentFrame(encoded[i], reflected ? (reflected + i) : nullptr);
 }
 
-template<> inline bool dvec2::isUnitVector() const
+#pragma endregion
+
+#pragma region Smallest Three
+
+// Packs the smallest three components of q with the given bits each, followed by the index of the largest
+template<typename T> inline unsigned long long _linalg_smallest_three_encode(const quat_t<T> &q, const int bits)
 {
-	return LINALG_DEQUAL(lengthSquared(), 1.0f);
+	const T components[4] = { q.x, q.y, q.z, q.w };
+
+	int largest = 0;
+	T largestAbs = (components[0] < T(0)) ? -components[0] : components[0];
+
+	for (int i = 1; i < 4; i++)
+	{
+		const T a = (components[i] < T(0)) ? -components[i] : components[i];
+
+		if (a > largestAbs)
+		{
+			largest = i;
+			largestAbs = a;
+		}
+	}
+
+	const T s = (components[largest] < T(0)) ? T(-1.41421356237309505) : T(1.41421356237309505);
+	const int scale = (1 << (bits - 1)) - 1;
+	const unsigned long long mask = (1ull << bits) - 1ull;
+
+	unsigned long long encoded = static_cast<unsigned long long>(largest) << (bits * 3);
+
+	for (int i = 0, j = 0; i < 4; i++)
+		if (i != largest)
+			encoded |= (static_cast<unsigned long long>(static_cast<unsigned int>(_linalg_snorm_encode(components[i] * s, scale))) & mask) << (bits * j++);
+
+	return encoded;
 }
 
+template<typename T> inline quat_t<T> _linalg_smallest_three_decode(const unsigned long long encoded, const int bits)
+{
+	const int scale = (1 << (bits - 1)) - 1;
+	const unsigned int largest = static_cast<unsigned int>(encoded >> (bits * 3)) & 3u;
 
-template<> bool fvec2::isNormalized(const float &to) const
+	const T a = _linalg_snorm_decode<T>(static_cast<unsigned int>(encoded), scale) * T(0.70710678118654752);
+	const T b = _linalg_snorm_decode<T>(static_cast<unsigned int>(encoded >> bits), scale) * T(0.70710678118654752);
+	const T c = _linalg_snorm_decode<T>(static_cast<unsigned int>(encoded >> (bits * 2)), scale) * T(0.70710678118654752);
+
+	const T dSquared = T(1) - a * a - b * b - c * c;
+	const T d = sqrt((dSquared > T(0)) ? dSquared : T(0));
+
+	switch (largest)
+	{
+	case 0: return quat_t<T>(d, a, b, c);
+	case 1: return quat_t<T>(a, d, b, c);
+	case 2: return quat_t<T>(a, b, d, c);
+	default: return quat_t<T>(a, b, c, d);
+	}
+}
+
+template<typename T> unsigned int quat_t<T>::encodeSmallestThree32(const quat &q)
 {
-	const float len = length();
+	return static_cast<unsigned int>(_linalg_smallest_three_encode(q, 10));
+}
 
-	return LINALG_FEQUAL(len, to);
+template<typename T> quat_t<T> quat_t<T>::decodeSmallestThree32(const unsigned int encoded)
+{
+	return _linalg_smallest_three_decode<T>(encoded, 10);
 }
 
-template<> bool dvec2::isNormalized(const double &to) const
+template<typename T> void quat_t<T>::encodeSmallestThree48(const quat &q, unsigned short encoded[3])
 {
-	const double len = length();
+	const unsigned long long bits = _linalg_smallest_three_encode(q, 15);
 
-	return LINALG_DEQUAL(len, to);
+	encoded[0] = static_cast<unsigned short>(bits);
+	encoded[1] = static_cast<unsigned short>(bits >> 16);
+	encoded[2] = static_cast<unsigned short>(bits >> 32);
 }
 
+template<typename T> quat_t<T> quat_t<T>::decodeSmallestThree48(const unsigned short encoded[3])
+{
+	return _linalg_smallest_three_decode<T>(
+		static_cast<unsigned long long>(encoded[0]) |
+		(static_cast<unsigned long long>(encoded[1]) << 16) |
+		(static_cast<unsigned long long>(encoded[2]) << 32), 15);
+}
 
-template<typename T> bool vec2_t<T>::isOrthogonalTo(const vec2 &rhs) const
+template<typename T> unsigned long long quat_t<T>::encodeSmallestThree64(const quat &q)
 {
-	return (dot(rhs) == 0);
+	return _linalg_smallest_three_encode(q, 20);
 }
 
-template<> bool fvec2::isOrthogonalTo(const vec2 &rhs) const
+template<typename T> quat_t<T> quat_t<T>::decodeSmallestThree64(const unsigned long long encoded)
 {
-	const float d = dot(rhs);
+	return _linalg_smallest_three_decode<T>(encoded, 20);
+}
 
-	return (LINALG_FEQUAL(d, 0.0f));
+template<typename T> void quat_t<T>::encodeSmallestThree32(const quat *quats, const size_t count, unsigned int *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = encodeSmallestThree32(quats[i]);
 }
 
-template<> bool dvec2::isOrthogonalTo(const vec2 &rhs) const
+template<typename T> void quat_t<T>::decodeSmallestThree32(const unsigned int *encoded, const size_t count, quat *result)
 {
-	const double d = dot(rhs);
+	for (size_t i = 0; i < count; i++)
+		result[i] = decodeSmallestThree32(encoded[i]);
+}
 
-	return (LINALG_DEQUAL(d, 0.0));
+template<typename T> void quat_t<T>::encodeSmallestThree48(const quat *quats, const size_t count, unsigned short *result)
+{
+	for (size_t i = 0; i < count; i++)
+		encodeSmallestThree48(quats[i], result + i * 3);
 }
 
+template<typename T> void quat_t<T>::decodeSmallestThree48(const unsigned short *encoded, const size_t count, quat *result)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = decodeSmallestThree48(encoded + i * 3);
+}
 
-template<typename T> bool vec2_t<T>::isPerpendicularTo(const vec2 &rhs) const
+template<typename T> void quat_t<T>::encodeSmallestThree64(const quat *quats, const size_t count, unsigned long long *result)
 {
-	return (dot(rhs) == 0);
+	for (size_t i = 0; i < count; i++)
+		result[i] = encodeSmallestThree64(quats[i]);
 }
 
-template<> bool fvec2::isPerpendicularTo(const vec2 &rhs) const
+template<typename T> void quat_t<T>::decodeSmallestThree64(const unsigned long long *encoded, const size_t count, quat *result)
 {
-	const float d = dot(rhs);
+	for (size_t i = 0; i < count; i++)
+		result[i] = decodeSmallestThree64(encoded[i]);
+}
 
-	return (LINALG_FEQUAL(d, 0.0f));
+
+// _linalg_smallest_three_encode() for 4 quaternions at a time, matching it bit for bit
+inline void _linalg_smallest_three_encode_4(const fquat *quats, const int bits, unsigned long long encoded[4])
+{
+	_linalg_float4 x = _linalg_float4::load(&quats[0].x), y = _linalg_float4::load(&quats[1].x);
+	_linalg_float4 z = _linalg_float4::load(&quats[2].x), w = _linalg_float4::load(&quats[3].x);
+	_linalg_transpose4(x, y, z, w);
+
+	const _linalg_float4 zero(0.0f), one(1.0f), minusOne(-1.0f);
+
+	// The first largest component, its index and value
+	_linalg_float4 largestAbs = _linalg_abs(x), largest = x, index = zero;
+	_linalg_float4 greater;
+
+	greater = _linalg_cmpgt(_linalg_abs(y), largestAbs);
+	largestAbs = _linalg_select(greater, _linalg_abs(y), largestAbs);
+	largest = _linalg_select(greater, y, largest);
+	index = _linalg_select(greater, _linalg_float4(1.0f), index);
+
+	greater = _linalg_cmpgt(_linalg_abs(z), largestAbs);
+	largestAbs = _linalg_select(greater, _linalg_abs(z), largestAbs);
+	largest = _linalg_select(greater, z, largest);
+	index = _linalg_select(greater, _linalg_float4(2.0f), index);
+
+	greater = _linalg_cmpgt(_linalg_abs(w), largestAbs);
+	largest = _linalg_select(greater, w, largest);
+	index = _linalg_select(greater, _linalg_float4(3.0f), index);
+
+	// The remaining components in order
+	const _linalg_float4 a = _linalg_select(_linalg_cmplt(index, _linalg_float4(0.5f)), y, x);
+	const _linalg_float4 b = _linalg_select(_linalg_cmplt(index, _linalg_float4(1.5f)), z, y);
+	const _linalg_float4 c = _linalg_select(_linalg_cmplt(index, _linalg_float4(2.5f)), w, z);
+
+	const _linalg_float4 s = _linalg_select(_linalg_cmplt(largest, zero), _linalg_float4(-1.41421356237309505f), _linalg_float4(1.41421356237309505f));
+
+	const float scale = static_cast<float>((1 << (bits - 1)) - 1);
+	const _linalg_float4 scale4(scale), offset(scale + 0.5f);
+
+	int qa[4], qb[4], qc[4], qi[4];
+	_linalg_truncate(_linalg_min(_linalg_max(a * s, minusOne), one) * scale4 + offset, qa);
+	_linalg_truncate(_linalg_min(_linalg_max(b * s, minusOne), one) * scale4 + offset, qb);
+	_linalg_truncate(_linalg_min(_linalg_max(c * s, minusOne), one) * scale4 + offset, qc);
+	_linalg_truncate(index, qi);
+
+	const int offsetBits = (1 << (bits - 1)) - 1;
+	const unsigned long long mask = (1ull << bits) - 1ull;
+
+	for (int lane = 0; lane < 4; lane++)
+	{
+		encoded[lane] =
+			(static_cast<unsigned long long>(static_cast<unsigned int>(qa[lane] - offsetBits)) & mask) |
+			((static_cast<unsigned long long>(static_cast<unsigned int>(qb[lane] - offsetBits)) & mask) << bits) |
+			((static_cast<unsigned long long>(static_cast<unsigned int>(qc[lane] - offsetBits)) & mask) << (bits * 2)) |
+			(static_cast<unsigned long long>(qi[lane]) << (bits * 3));
+	}
 }
 
-template<> bool dvec2::isPerpendicularTo(const vec2 &rhs) const
+// _linalg_smallest_three_decode() for 4 quaternions at a time, matching it bit for bit
+inline void _linalg_smallest_three_decode_4(const unsigned long long encoded[4], const int bits, fquat *quats)
 {
-	const double d = dot(rhs);
+	const unsigned int sign = 1u << (bits - 1), mask = (sign << 1) - 1u;
 
-	return (LINALG_DEQUAL(d, 0.0));
+	int qa[4], qb[4], qc[4], qi[4];
+
+	for (int lane = 0; lane < 4; lane++)
+	{
+		qa[lane] = int((static_cast<unsigned int>(encoded[lane]) & mask) ^ sign) - int(sign);
+		qb[lane] = int((static_cast<unsigned int>(encoded[lane] >> bits) & mask) ^ sign) - int(sign);
+		qc[lane] = int((static_cast<unsigned int>(encoded[lane] >> (bits * 2)) & mask) ^ sign) - int(sign);
+		qi[lane] = int(encoded[lane] >> (bits * 3)) & 3;
+	}
+
+	const _linalg_float4 zero(0.0f), one(1.0f), minusOne(-1.0f), invSqrt2(0.70710678118654752f);
+	const _linalg_float4 scale(static_cast<float>(sign - 1u));
+
+	const _linalg_float4 a = _linalg_max(_linalg_int_to_float(qa) / scale, minusOne) * invSqrt2;
+	const _linalg_float4 b = _linalg_max(_linalg_int_to_float(qb) / scale, minusOne) * invSqrt2;
+	const _linalg_float4 c = _linalg_max(_linalg_int_to_float(qc) / scale, minusOne) * invSqrt2;
+
+	const _linalg_float4 d = _linalg_sqrt(_linalg_max(one - a * a - b * b - c * c, zero));
+
+	const _linalg_float4 index = _linalg_int_to_float(qi);
+	const _linalg_float4 is0 = _linalg_cmplt(index, _linalg_float4(0.5f));
+	const _linalg_float4 is1 = _linalg_and(_linalg_cmpgt(index, _linalg_float4(0.5f)), _linalg_cmplt(index, _linalg_float4(1.5f)));
+	const _linalg_float4 is2 = _linalg_and(_linalg_cmpgt(index, _linalg_float4(1.5f)), _linalg_cmplt(index, _linalg_float4(2.5f)));
+	const _linalg_float4 is3 = _linalg_cmpgt(index, _linalg_float4(2.5f));
+
+	_linalg_float4 x = _linalg_select(is0, d, a);
+	_linalg_float4 y = _linalg_select(is0, a, _linalg_select(is1, d, b));
+	_linalg_float4 z = _linalg_select(_linalg_cmplt(index, _linalg_float4(1.5f)), b, _linalg_select(is2, d, c));
+	_linalg_float4 w = _linalg_select(is3, d, c);
+
+	_linalg_transpose4(x, y, z, w);
+
+	x.store(&quats[0].x);
+	y.store(&quats[1].x);
+	z.store(&quats[2].x);
+	w.store(&quats[3].x);
 }
 
+template<> inline void fquat::encodeSmallestThree32(const fquat *quats, const size_t count, unsigned int *result)
+{
+	size_t i = 0;
 
-template<typename T> bool vec2_t<T>::isParallelTo(const vec2 &rhs) const
+	for (; (i + 4) <= count; i += 4)
+	{
+		unsigned long long encoded[4];
+		_linalg_smallest_three_encode_4(quats + i, 10, encoded);
+
+		for (int lane = 0; lane < 4; lane++)
+			result[i + lane] = static_cast<unsigned int>(encoded[lane]);
+	}
+
+	for (; i < count; i++)
+		result[i] = encodeSmallestThree32(quats[i]);
+}
+
+template<> inline void fquat::decodeSmallestThree32(const unsigned int *encoded, const size_t count, fquat *result)
 {
-	return (dot(rhs) == 1);
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		const unsigned long long bits[4] = { encoded[i], encoded[i + 1], encoded[i + 2], encoded[i + 3] };
+		_linalg_smallest_three_decode_4(bits, 10, result + i);
+	}
+
+	for (; i < count; i++)
+		result[i] = decodeSmallestThree32(encoded[i]);
 }
 
-template<> bool fvec2::isParallelTo(const vec2 &rhs) const
+template<> inline void fquat::encodeSmallestThree48(const fquat *quats, const size_t count, unsigned short *result)
 {
-	const float d = dot(rhs);
+	size_t i = 0;
 
-	return (LINALG_FEQUAL(d, 1.0f));
+	for (; (i + 4) <= count; i += 4)
+	{
+		unsigned long long encoded[4];
+		_linalg_smallest_three_encode_4(quats + i, 15, encoded);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			result[(i + lane) * 3 + 0] = static_cast<unsigned short>(encoded[lane]);
+			result[(i + lane) * 3 + 1] = static_cast<unsigned short>(encoded[lane] >> 16);
+			result[(i + lane) * 3 + 2] = static_cast<unsigned short>(encoded[lane] >> 32);
+		}
+	}
+
+	for (; i < count; i++)
+		encodeSmallestThree48(quats[i], result + i * 3);
 }
 
-template<> bool dvec2::isParallelTo(const vec2 &rhs) const
+template<> inline void fquat::decodeSmallestThree48(const unsigned short *encoded, const size_t count, fquat *result)
 {
-	const double d = dot(rhs);
+	size_t i = 0;
 
-	return (LINALG_DEQUAL(d, 1.0));
+	for (; (i + 4) <= count; i += 4)
+	{
+		unsigned long long bits[4];
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			const unsigned short *e = encoded + (i + lane) * 3;
+			bits[lane] = static_cast<unsigned long long>(e[0]) | (static_cast<unsigned long long>(e[1]) << 16) | (static_cast<unsigned long long>(e[2]) << 32);
+		}
+
+		_linalg_smallest_three_decode_4(bits, 15, result + i);
+	}
+
+	for (; i < count; i++)
+		result[i] = decodeSmallestThree48(encoded + i * 3);
+}
+
+template<> inline void fquat::encodeSmallestThree64(const fquat *quats, const size_t count, unsigned long long *result)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+		_linalg_smallest_three_encode_4(quats + i, 20, result + i);
+
+	for (; i < count; i++)
+		result[i] = encodeSmallestThree64(quats[i]);
+}
+
+template<> inline void fquat::decodeSmallestThree64(const unsigned long long *encoded, const size_t count, fquat *result)
+{
+	size_t i = 0;
+
+	for (; (i + 4) <= count; i += 4)
+		_linalg_smallest_three_decode_4(encoded + i, 20, result + i);
+
+	for (; i < count; i++)
+		result[i] = decodeSmallestThree64(encoded[i]);
 }
 
 #pragma endregion
 
-#pragma region Validate sizeof Templated Objects
+#pragma endregion
 
-#ifdef DEBUG
 
-#ifndef STATIC_ASSERT
-#	define STATIC_ASSERT(bool_constexpr) static_assert(bool_constexpr, #bool_constexpr)
-#endif
+#pragma region dualquat
 
-STATIC_ASSERT(sizeof(vec2_t<float>) == (sizeof(float) * 2));
-STATIC_ASSERT(sizeof(vec2_t<double>) == (sizeof(double) * 2));
+#pragma region Static Members
 
-STATIC_ASSERT(sizeof(vec2_t<signed int>) == (sizeof(signed int) * 2));
-STATIC_ASSERT(sizeof(vec2_t<unsigned int>) == (sizeof(unsigned int) * 2));
+template<typename T> const dualquat_t<T> dualquat_t<T>::zero = dualquat_t<T>(quat_t<T>(T(0), T(0), T(0), T(0)), quat_t<T>(T(0), T(0), T(0), T(0)));
+template<typename T> const dualquat_t<T> dualquat_t<T>::identity = dualquat_t<T>(quat_t<T>(T(0), T(0), T(0), T(1)), quat_t<T>(T(0), T(0), T(0), T(0)));
 
-STATIC_ASSERT(sizeof(vec2_t<bool>) == (sizeof(bool) * 2));
+#pragma endregion
 
-STATIC_ASSERT(sizeof(vec2_t<signed long>) == (sizeof(signed long) * 2));
-STATIC_ASSERT(sizeof(vec2_t<unsigned long>) == (sizeof(unsigned long) * 2));
+#pragma region Skinning
 
-STATIC_ASSERT(sizeof(vec2_t<signed long long>) == (sizeof(signed long long) * 2));
-STATIC_ASSERT(sizeof(vec2_t<unsigned long long>) == (sizeof(unsigned long long) * 2));
+template<typename T> void dualquat_t<T>::skin(
+	const dualquat *palette,
+	const uvec4 *boneIndices, const vec4 *boneWeights,
+	const vec3 *positions, const vec3 *normals,
+	vec3 *skinnedPositions, vec3 *skinnedNormals,
+	const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const dualquat dq = dualquat::blend(palette, boneIndices[i], boneWeights[i]);
 
-#endif
+		skinnedPositions[i] = dq.transformPoint(positions[i]);
+
+		if (normals)
+			skinnedNormals[i] = dq.transformNormal(normals[i]);
+	}
+}
+
+template<> inline void fdualquat::skin(
+	const fdualquat *palette,
+	const uvec4 *boneIndices, const fvec4 *boneWeights,
+	const fvec3 *positions, const fvec3 *normals,
+	fvec3 *skinnedPositions, fvec3 *skinnedNormals,
+	const size_t count)
+{
+	size_t i = 0;
+
+	const _linalg_float4 zero(0.0f), one(1.0f), two(2.0f), signBit(-0.0f);
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		_linalg_float4 w0 = _linalg_float4::load(&boneWeights[i + 0].x);
+		_linalg_float4 w1 = _linalg_float4::load(&boneWeights[i + 1].x);
+		_linalg_float4 w2 = _linalg_float4::load(&boneWeights[i + 2].x);
+		_linalg_float4 w3 = _linalg_float4::load(&boneWeights[i + 3].x);
+
+		_linalg_transpose4(w0, w1, w2, w3);
+
+		const _linalg_float4 weights[4] = { w0, w1, w2, w3 };
+
+		_linalg_float4 rx = zero, ry = zero, rz = zero, rw = zero;
+		_linalg_float4 dx = zero, dy = zero, dz = zero, dw = zero;
+
+		_linalg_float4 r0x, r0y, r0z, r0w;
+
+		for (int k = 0; k < 4; k++)
+		{
+			const fdualquat &b0 = palette[boneIndices[i + 0][k]];
+			const fdualquat &b1 = palette[boneIndices[i + 1][k]];
+			const fdualquat &b2 = palette[boneIndices[i + 2][k]];
+			const fdualquat &b3 = palette[boneIndices[i + 3][k]];
+
+			_linalg_float4 bx = _linalg_float4::load(&b0.real.x), by = _linalg_float4::load(&b1.real.x);
+			_linalg_float4 bz = _linalg_float4::load(&b2.real.x), bw = _linalg_float4::load(&b3.real.x);
+			_linalg_transpose4(bx, by, bz, bw);
+
+			_linalg_float4 cx = _linalg_float4::load(&b0.dual.x), cy = _linalg_float4::load(&b1.dual.x);
+			_linalg_float4 cz = _linalg_float4::load(&b2.dual.x), cw = _linalg_float4::load(&b3.dual.x);
+			_linalg_transpose4(cx, cy, cz, cw);
+
+			if (k == 0)
+			{
+				r0x = bx; r0y = by; r0z = bz; r0w = bw;
+			}
+
+			// Negate the weight if this bone is in the opposite hemisphere of the first bone
+			const _linalg_float4 d = bx * r0x + by * r0y + bz * r0z + bw * r0w;
+			const _linalg_float4 weight = _linalg_xor(weights[k], _linalg_and(d, signBit));
+
+			rx = rx + weight * bx; ry = ry + weight * by; rz = rz + weight * bz; rw = rw + weight * bw;
+			dx = dx + weight * cx; dy = dy + weight * cy; dz = dz + weight * cz; dw = dw + weight * cw;
+		}
+
+		const _linalg_float4 invLength = one / _linalg_sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+
+		rx = rx * invLength; ry = ry * invLength; rz = rz * invLength; rw = rw * invLength;
+		dx = dx * invLength; dy = dy * invLength; dz = dz * invLength; dw = dw * invLength;
+
+		// See getTranslation()
+		const _linalg_float4 tx = two * (rw * dx - dw * rx + ry * dz - rz * dy);
+		const _linalg_float4 ty = two * (rw * dy - dw * ry + rz * dx - rx * dz);
+		const _linalg_float4 tz = two * (rw * dz - dw * rz + rx * dy - ry * dx);
+
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&positions[i].x, x, y, z);
+
+		_linalg_quat_rotate_4(rx, ry, rz, rw, x, y, z);
+
+		_linalg_store3x4(&skinnedPositions[i].x, x + tx, y + ty, z + tz);
+
+		if (normals)
+		{
+			_linalg_load3x4(&normals[i].x, x, y, z);
+
+			_linalg_quat_rotate_4(rx, ry, rz, rw, x, y, z);
+
+			_linalg_store3x4(&skinnedNormals[i].x, x, y, z);
+		}
+	}
+
+	for (; i < count; i++)
+	{
+		const fdualquat dq = fdualquat::blend(palette, boneIndices[i], boneWeights[i]);
+
+		skinnedPositions[i] = dq.transformPoint(positions[i]);
+
+		if (normals)
+			skinnedNormals[i] = dq.transformNormal(normals[i]);
+	}
+}
+
+#pragma endregion
+
+#pragma endregion
+
+
+#pragma region aabb
+
+#pragma region Static Members
+
+template<typename T> const aabb_t<T> aabb_t<T>::empty = aabb_t<T>(vec3_t<T>(T(HUGE_VAL)), vec3_t<T>(T(-HUGE_VAL)));
+
+#pragma endregion
+
+#pragma region Transform
+
+template<typename T> void aabb_t<T>::transform(const aabb *boxes, const mat4 *matrices, aabb *result, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = boxes[i].transform(matrices[i]);
+}
+
+template<typename T> void aabb_t<T>::transform(
+	const aabb *boxes, const mat4 *matrices,
+	T *minX, T *minY, T *minZ,
+	T *maxX, T *maxY, T *maxZ,
+	const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const aabb box = boxes[i].transform(matrices[i]);
 
-#pragma endregion
+		minX[i] = box.min.x; minY[i] = box.min.y; minZ[i] = box.min.z;
+		maxX[i] = box.max.x; maxY[i] = box.max.y; maxZ[i] = box.max.z;
+	}
+}
 
-#pragma endregion
 
+// Arvo's method with each matrix column in a register, the w lane is ignored
+inline void _linalg_aabb_transform(const faabb &box, const fmat4 &m, _linalg_float4 &min, _linalg_float4 &max)
+{
+	const _linalg_float4 half(0.5f);
 
-#pragma region vec3
+	const _linalg_float4 c0 = _linalg_float4::load(&m.columns[0].x);
+	const _linalg_float4 c1 = _linalg_float4::load(&m.columns[1].x);
+	const _linalg_float4 c2 = _linalg_float4::load(&m.columns[2].x);
+	const _linalg_float4 c3 = _linalg_float4::load(&m.columns[3].x);
 
-#pragma region Static Members
+	const fvec3 c = (box.min + box.max) * 0.5f;
+	const fvec3 e = (box.max - box.min) * 0.5f;
 
-template<typename T> const vec3_t<T> vec3_t<T>::zero = vec3_t<T>(T(0), T(0), T(0));
-template<typename T> const vec3_t<T> vec3_t<T>::one = vec3_t<T>(T(1), T(1), T(1));
+	const _linalg_float4 center = c0 * _linalg_float4(c.x) + c1 * _linalg_float4(c.y) + c2 * _linalg_float4(c.z) + c3;
+	const _linalg_float4 extents = _linalg_abs(c0) * _linalg_float4(e.x) + _linalg_abs(c1) * _linalg_float4(e.y) + _linalg_abs(c2) * _linalg_float4(e.z);
 
-template<typename T> const vec3_t<T> vec3_t<T>::up = vec3_t<T>(T(0), T(1), T(0));
-template<typename T> const vec3_t<T> vec3_t<T>::down = vec3_t<T>(T(0), T(-1), T(0));
+	min = center - extents;
+	max = center + extents;
+}
 
-template<typename T> const vec3_t<T> vec3_t<T>::left = vec3_t<T>(T(-1), T(0), T(0));
-template<typename T> const vec3_t<T> vec3_t<T>::right = vec3_t<T>(T(1), T(0), T(0));
+template<> inline void faabb::transform(const faabb *boxes, const fmat4 *matrices, faabb *result, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		_linalg_float4 min, max;
+		_linalg_aabb_transform(boxes[i], matrices[i], min, max);
 
-template<typename T> const vec3_t<T> vec3_t<T>::forward = vec3_t<T>(T(0), T(0), T(1));
-template<typename T> const vec3_t<T> vec3_t<T>::backward = vec3_t<T>(T(0), T(0), T(-1));
+		// min and max are 6 consecutive floats, so only the last box can't take a 4 float store of max
+		float lanes[4];
 
-#pragma endregion
+		min.store(&result[i].min.x);
 
-#pragma region Constructors
+		max.store(lanes);
+		result[i].max = fvec3(lanes[0], lanes[1], lanes[2]);
+	}
+}
 
-template<typename T>
-template<typename T2>
-vec3_t<T>::vec3_t(const vec4_t<T2> &v) : x(T(v.x)), y(T(v.y)), z(T(v.z))
+template<> inline void faabb::transform(
+	const faabb *boxes, const fmat4 *matrices,
+	float *minX, float *minY, float *minZ,
+	float *maxX, float *maxY, float *maxZ,
+	const size_t count)
 {
+	for (size_t i = 0; i < count; i++)
+	{
+		_linalg_float4 min, max;
+		_linalg_aabb_transform(boxes[i], matrices[i], min, max);
+
+		float lanes[8];
+		min.store(lanes);
+		max.store(lanes + 4);
 
+		minX[i] = lanes[0]; minY[i] = lanes[1]; minZ[i] = lanes[2];
+		maxX[i] = lanes[4]; maxY[i] = lanes[5]; maxZ[i] = lanes[6];
+	}
 }
 
 #pragma endregion
 
-#pragma region Comparison Operators
+#pragma endregion
 
-template<typename T> inline bool vec3_t<T>::operator==(const vec3 &rhs) const
+
+#pragma region sphere
+
+#pragma region Transform
+
+template<typename T> void sphere_t<T>::transform(const sphere *spheres, const mat4 *matrices, sphere *result, const size_t count)
 {
-	return ((this->x == rhs.x) && (this->y == rhs.y) && (this->z == rhs.z));
+	for (size_t i = 0; i < count; i++)
+		result[i] = spheres[i].transform(matrices[i]);
 }
 
-template<> inline bool fvec3::operator==(const fvec3 &rhs) const
+template<typename T> void sphere_t<T>::transform(
+	const sphere *spheres, const mat4 *matrices,
+	T *centerX, T *centerY, T *centerZ, T *radius,
+	const size_t count)
 {
-	return (LINALG_FEQUAL(this->x, rhs.x) && LINALG_FEQUAL(this->y, rhs.y) && LINALG_FEQUAL(this->z, rhs.z));
+	for (size_t i = 0; i < count; i++)
+	{
+		const sphere s = spheres[i].transform(matrices[i]);
+
+		centerX[i] = s.center.x;
+		centerY[i] = s.center.y;
+		centerZ[i] = s.center.z;
+		radius[i] = s.radius;
+	}
 }
 
-template<> inline bool dvec3::operator==(const dvec3 &rhs) const
+
+// Results in (center.x, center.y, center.z, radius)
+inline _linalg_float4 _linalg_sphere_transform(const fsphere &s, const fmat4 &m)
 {
-	return (LINALG_DEQUAL(this->x, rhs.x) && LINALG_DEQUAL(this->y, rhs.y) && LINALG_DEQUAL(this->z, rhs.z));
-}
+	const _linalg_float4 c0 = _linalg_float4::load(&m.columns[0].x);
+	const _linalg_float4 c1 = _linalg_float4::load(&m.columns[1].x);
+	const _linalg_float4 c2 = _linalg_float4::load(&m.columns[2].x);
+	const _linalg_float4 c3 = _linalg_float4::load(&m.columns[3].x);
 
-#pragma endregion
+	// Transpose to get the squared lengths of the 3 axes in one go
+	_linalg_float4 x = c0, y = c1, z = c2, w = c3;
+	_linalg_transpose4(x, y, z, w);
 
-#pragma region Normalize
+	const _linalg_float4 scales = x * x + y * y + z * z;
+	const float maxScale = sqrtf(fmaxf(fmaxf(scales[0], scales[1]), scales[2]));
 
-template<> inline fvec3 fvec3::normalize(const float &to) const
-{
-	float len = length();
+	const _linalg_float4 center = c0 * _linalg_float4(s.center.x) + c1 * _linalg_float4(s.center.y) + c2 * _linalg_float4(s.center.z) + c3;
 
-	if (!LINALG_FEQUAL(len, 0.0f) && !LINALG_FEQUAL(len, to))
-	{
-		len = to / len;
+	float lanes[4];
+	center.store(lanes);
+	lanes[3] = s.radius * maxScale;
 
-		return fvec3(*this) * len;
-	}
+	return _linalg_float4::load(lanes);
+}
 
-	return (*this);
+template<> inline void fsphere::transform(const fsphere *spheres, const fmat4 *matrices, fsphere *result, const size_t count)
+{
+	// A sphere is 4 consecutive floats
+	for (size_t i = 0; i < count; i++)
+		_linalg_sphere_transform(spheres[i], matrices[i]).store(&result[i].center.x);
 }
 
-template<> inline dvec3 dvec3::normalize(const double &to) const
+template<> inline void fsphere::transform(
+	const fsphere *spheres, const fmat4 *matrices,
+	float *centerX, float *centerY, float *centerZ, float *radius,
+	const size_t count)
 {
-	double len = length();
+	size_t i = 0;
 
-	if (!LINALG_DEQUAL(len, 0.0) && !LINALG_DEQUAL(len, to))
+	for (; (i + 4) <= count; i += 4)
 	{
-		len = to / len;
+		_linalg_float4 x = _linalg_sphere_transform(spheres[i + 0], matrices[i + 0]);
+		_linalg_float4 y = _linalg_sphere_transform(spheres[i + 1], matrices[i + 1]);
+		_linalg_float4 z = _linalg_sphere_transform(spheres[i + 2], matrices[i + 2]);
+		_linalg_float4 r = _linalg_sphere_transform(spheres[i + 3], matrices[i + 3]);
 
-		return dvec3(*this) * len;
+		_linalg_transpose4(x, y, z, r);
+
+		x.store(centerX + i);
+		y.store(centerY + i);
+		z.store(centerZ + i);
+		r.store(radius + i);
 	}
 
-	return (*this);
+	for (; i < count; i++)
+	{
+		const fsphere s = spheres[i].transform(matrices[i]);
+
+		centerX[i] = s.center.x;
+		centerY[i] = s.center.y;
+		centerZ[i] = s.center.z;
+		radius[i] = s.radius;
+	}
 }
 
 #pragma endregion
 
-#pragma region Check Vector Kind
+#pragma endregion
 
-template<typename T> bool vec3_t<T>::isNullVector() const
-{
-	// It's faster to just compare to 0, than to calculate the length
-	return ((this->x == 0) && (this->y == 0) && (this->z == 0));
-}
 
-template<> bool fvec3::isNullVector() const
-{
-	// It's faster to just compare to 0, than to calculate the length
-	return (LINALG_FEQUAL(this->x, 0.0f) && LINALG_FEQUAL(this->y, 0.0f) && LINALG_FEQUAL(this->z, 0.0f));
-}
+#pragma region frustum
 
-template<> bool dvec3::isNullVector() const
+#pragma region Culling
+
+template<typename T> void frustum_t<T>::cullSpheres(
+	const T *centerX, const T *centerY, const T *centerZ, const T *radius,
+	const size_t count, unsigned char *visibility) const
 {
-	// It's faster to just compare to 0, than to calculate the length
-	return (LINALG_DEQUAL(this->x, 0.0) && LINALG_DEQUAL(this->y, 0.0) && LINALG_DEQUAL(this->z, 0.0));
-}
+	for (size_t i = 0; i < count; i += 8)
+	{
+		unsigned char bits = 0;
 
+		for (size_t j = i; (j < (i + 8)) && (j < count); j++)
+			if (intersectsSphere(vec3(centerX[j], centerY[j], centerZ[j]), radius[j]))
+				bits |= static_cast<unsigned char>(1u << (j - i));
 
-template<> inline bool fvec3::isUnitVector() const
-{
-	return LINALG_FEQUAL(lengthSquared(), 1.0f);
+		visibility[i / 8] = bits;
+	}
 }
 
-template<> inline bool dvec3::isUnitVector() const
+template<typename T> void frustum_t<T>::cullAABBs(
+	const T *minX, const T *minY, const T *minZ,
+	const T *maxX, const T *maxY, const T *maxZ,
+	const size_t count, unsigned char *visibility) const
 {
-	return LINALG_DEQUAL(lengthSquared(), 1.0f);
+	for (size_t i = 0; i < count; i += 8)
+	{
+		unsigned char bits = 0;
+
+		for (size_t j = i; (j < (i + 8)) && (j < count); j++)
+			if (intersectsAABB(vec3(minX[j], minY[j], minZ[j]), vec3(maxX[j], maxY[j], maxZ[j])))
+				bits |= static_cast<unsigned char>(1u << (j - i));
+
+		visibility[i / 8] = bits;
+	}
 }
 
 
-template<> bool fvec3::isNormalized(const float &to) const
+// Returns a mask of the 4 spheres starting at index, which are inside or intersecting all the planes
+inline _linalg_float4 _linalg_frustum_spheres_4(const ffrustum &f, const float *centerX, const float *centerY, const float *centerZ, const float *radius, const size_t index)
 {
-	const float len = length();
+	const _linalg_float4 x = _linalg_float4::load(centerX + index);
+	const _linalg_float4 y = _linalg_float4::load(centerY + index);
+	const _linalg_float4 z = _linalg_float4::load(centerZ + index);
+	const _linalg_float4 negRadius = _linalg_float4(0.0f) - _linalg_float4::load(radius + index);
 
-	return LINALG_FEQUAL(len, to);
-}
+	_linalg_float4 inside;
 
-template<> bool dvec3::isNormalized(const double &to) const
-{
-	const double len = length();
+	for (int i = 0; i < ffrustum::PlaneCount; i++)
+	{
+		const fvec4 &plane = f.planes[i];
 
-	return LINALG_DEQUAL(len, to);
-}
+		const _linalg_float4 d = _linalg_float4(plane.x) * x + _linalg_float4(plane.y) * y + _linalg_float4(plane.z) * z + _linalg_float4(plane.w);
+		const _linalg_float4 planeInside = _linalg_cmpge(d, negRadius);
 
+		inside = (i == 0) ? planeInside : _linalg_and(inside, planeInside);
+	}
 
-template<typename T> bool vec3_t<T>::isOrthogonalTo(const vec3 &rhs) const
-{
-	return (dot(rhs) == 0);
+	return inside;
 }
 
-template<> bool fvec3::isOrthogonalTo(const vec3 &rhs) const
+// Returns a mask of the 4 boxes starting at index, which are inside or intersecting all the planes
+inline _linalg_float4 _linalg_frustum_aabbs_4(const ffrustum &f, const float *min[3], const float *max[3], const size_t index)
 {
-	const float d = dot(rhs);
+	const _linalg_float4 zero(0.0f);
 
-	return (LINALG_FEQUAL(d, 0.0f));
-}
+	_linalg_float4 inside;
 
-template<> bool dvec3::isOrthogonalTo(const vec3 &rhs) const
-{
-	const double d = dot(rhs);
+	for (int i = 0; i < ffrustum::PlaneCount; i++)
+	{
+		const fvec4 &plane = f.planes[i];
 
-	return (LINALG_DEQUAL(d, 0.0));
-}
+		// The plane is the same for all lanes, so the furthest corner can be picked per axis up front
+		const _linalg_float4 x = _linalg_float4::load(((plane.x > 0.0f) ? max[0] : min[0]) + index);
+		const _linalg_float4 y = _linalg_float4::load(((plane.y > 0.0f) ? max[1] : min[1]) + index);
+		const _linalg_float4 z = _linalg_float4::load(((plane.z > 0.0f) ? max[2] : min[2]) + index);
 
+		const _linalg_float4 d = _linalg_float4(plane.x) * x + _linalg_float4(plane.y) * y + _linalg_float4(plane.z) * z + _linalg_float4(plane.w);
 
-template<typename T> bool vec3_t<T>::isPerpendicularTo(const vec3 &rhs) const
-{
-	return (dot(rhs) == 0);
-}
+		const _linalg_float4 planeInside = _linalg_cmpge(d, zero);
 
-template<> bool fvec3::isPerpendicularTo(const vec3 &rhs) const
-{
-	const float d = dot(rhs);
+		inside = (i == 0) ? planeInside : _linalg_and(inside, planeInside);
+	}
 
-	return (LINALG_FEQUAL(d, 0.0f));
+	return inside;
 }
 
-template<> bool dvec3::isPerpendicularTo(const vec3 &rhs) const
+template<> inline void ffrustum::cullSpheres(
+	const float *centerX, const float *centerY, const float *centerZ, const float *radius,
+	const size_t count, unsigned char *visibility) const
 {
-	const double d = dot(rhs);
+	size_t i = 0;
 
-	return (LINALG_DEQUAL(d, 0.0));
-}
+	// 8 spheres at a time, resulting in a byte of the bitmask
+	for (; (i + 8) <= count; i += 8)
+	{
+		const int low = _linalg_movemask(_linalg_frustum_spheres_4(*this, centerX, centerY, centerZ, radius, i));
+		const int high = _linalg_movemask(_linalg_frustum_spheres_4(*this, centerX, centerY, centerZ, radius, i + 4));
 
+		visibility[i / 8] = static_cast<unsigned char>(low | (high << 4));
+	}
 
-template<typename T> bool vec3_t<T>::isParallelTo(const vec3 &rhs) const
-{
-	return (dot(rhs) == 1);
-}
+	if (i < count)
+	{
+		unsigned char bits = 0;
 
-template<> bool fvec3::isParallelTo(const vec3 &rhs) const
-{
-	const float d = dot(rhs);
+		for (size_t j = i; j < count; j++)
+			if (intersectsSphere(fvec3(centerX[j], centerY[j], centerZ[j]), radius[j]))
+				bits |= static_cast<unsigned char>(1u << (j - i));
 
-	return (LINALG_FEQUAL(d, 1.0f));
+		visibility[i / 8] = bits;
+	}
 }
 
-template<> bool dvec3::isParallelTo(const vec3 &rhs) const
+template<> inline void ffrustum::cullAABBs(
+	const float *minX, const float *minY, const float *minZ,
+	const float *maxX, const float *maxY, const float *maxZ,
+	const size_t count, unsigned char *visibility) const
 {
-	const double d = dot(rhs);
-
-	return (LINALG_DEQUAL(d, 1.0));
-}
+	const float *min[3] = { minX, minY, minZ };
+	const float *max[3] = { maxX, maxY, maxZ };
 
-#pragma endregion
+	size_t i = 0;
 
-#pragma region Validate sizeof Templated Objects
+	for (; (i + 8) <= count; i += 8)
+	{
+		const int low = _linalg_movemask(_linalg_frustum_aabbs_4(*this, min, max, i));
+		const int high = _linalg_movemask(_linalg_frustum_aabbs_4(*this, min, max, i + 4));
 
-#ifdef DEBUG
+		visibility[i / 8] = static_cast<unsigned char>(low | (high << 4));
+	}
 
-#ifndef STATIC_ASSERT
-#	define STATIC_ASSERT(bool_constexpr) static_assert(bool_constexpr, #bool_constexpr)
-#endif
+	if (i < count)
+	{
+		unsigned char bits = 0;
 
-STATIC_ASSERT(sizeof(vec3_t<float>) == (sizeof(float) * 3));
-STATIC_ASSERT(sizeof(vec3_t<double>) == (sizeof(double) * 3));
+		for (size_t j = i; j < count; j++)
+			if (intersectsAABB(fvec3(minX[j], minY[j], minZ[j]), fvec3(maxX[j], maxY[j], maxZ[j])))
+				bits |= static_cast<unsigned char>(1u << (j - i));
 
-STATIC_ASSERT(sizeof(vec3_t<signed int>) == (sizeof(signed int) * 3));
-STATIC_ASSERT(sizeof(vec3_t<unsigned int>) == (sizeof(unsigned int) * 3));
+		visibility[i / 8] = bits;
+	}
+}
 
-STATIC_ASSERT(sizeof(vec3_t<bool>) == (sizeof(bool) * 3));
 
-STATIC_ASSERT(sizeof(vec3_t<signed long>) == (sizeof(signed long) * 3));
-STATIC_ASSERT(sizeof(vec3_t<unsigned long>) == (sizeof(unsigned long) * 3));
+// The index list versions cull in blocks, to keep the temporary bitmask on the stack
 
-STATIC_ASSERT(sizeof(vec3_t<signed long long>) == (sizeof(signed long long) * 3));
-STATIC_ASSERT(sizeof(vec3_t<unsigned long long>) == (sizeof(unsigned long long) * 3));
+template<typename T> size_t frustum_t<T>::cullSpheres(
+	const T *centerX, const T *centerY, const T *centerZ, const T *radius,
+	const size_t count, unsigned int *visibleIndices) const
+{
+	const size_t blockSize = 1024;
+	unsigned char visibility[blockSize / 8];
 
-#endif
+	size_t visibleCount = 0;
 
-#pragma endregion
+	for (size_t i = 0; i < count; i += blockSize)
+	{
+		const size_t n = ((count - i) < blockSize) ? (count - i) : blockSize;
 
-#pragma endregion
+		cullSpheres(centerX + i, centerY + i, centerZ + i, radius + i, n, visibility);
 
+		const size_t visibleBlockCount = compact(visibility, n, visibleIndices + visibleCount);
 
-#pragma region vec4
+		for (size_t j = 0; j < visibleBlockCount; j++)
+			visibleIndices[visibleCount + j] += static_cast<unsigned int>(i);
 
-#pragma region Static Members
+		visibleCount += visibleBlockCount;
+	}
 
-template<typename T> const vec4_t<T> vec4_t<T>::zero = vec4_t<T>(T(0), T(0), T(0), T(0));
-template<typename T> const vec4_t<T> vec4_t<T>::one = vec4_t<T>(T(1), T(1), T(1), T(1));
+	return visibleCount;
+}
 
-#pragma endregion
+template<typename T> size_t frustum_t<T>::cullAABBs(
+	const T *minX, const T *minY, const T *minZ,
+	const T *maxX, const T *maxY, const T *maxZ,
+	const size_t count, unsigned int *visibleIndices) const
+{
+	const size_t blockSize = 1024;
+	unsigned char visibility[blockSize / 8];
 
-#pragma region Constructors
+	size_t visibleCount = 0;
 
+	for (size_t i = 0; i < count; i += blockSize)
+	{
+		const size_t n = ((count - i) < blockSize) ? (count - i) : blockSize;
 
+		cullAABBs(minX + i, minY + i, minZ + i, maxX + i, maxY + i, maxZ + i, n, visibility);
 
-#pragma endregion
+		const size_t visibleBlockCount = compact(visibility, n, visibleIndices + visibleCount);
 
-#pragma region Comparison Operators
+		for (size_t j = 0; j < visibleBlockCount; j++)
+			visibleIndices[visibleCount + j] += static_cast<unsigned int>(i);
 
-template<typename T> inline bool vec4_t<T>::operator==(const vec4 &rhs) const
-{
-	return ((this->x == rhs.x) && (this->y == rhs.y) && (this->z == rhs.z) && (this->w == rhs.w));
-}
+		visibleCount += visibleBlockCount;
+	}
 
-template<> inline bool fvec4::operator==(const fvec4 &rhs) const
-{
-	return (LINALG_FEQUAL(this->x, rhs.x) && LINALG_FEQUAL(this->y, rhs.y) && LINALG_FEQUAL(this->z, rhs.z) && LINALG_FEQUAL(this->w, rhs.w));
+	return visibleCount;
 }
 
-template<> inline bool dvec4::operator==(const dvec4 &rhs) const
-{
-	return (LINALG_DEQUAL(this->x, rhs.x) && LINALG_DEQUAL(this->y, rhs.y) && LINALG_DEQUAL(this->z, rhs.z) && LINALG_DEQUAL(this->w, rhs.w));
-}
+#pragma endregion
 
 #pragma endregion
 
-#pragma region Normalize
 
-template<> inline fvec4 fvec4::normalize(const float &to) const
+#pragma region ray
+
+#pragma region Intersection
+
+template<typename T> bool ray_t<T>::intersectAABBs(
+	const T *minX, const T *minY, const T *minZ,
+	const T *maxX, const T *maxY, const T *maxZ,
+	const size_t count, size_t &index, T &distance, const T maxDistance) const
 {
-	float len = length();
+	T nearest = maxDistance;
+	bool hit = false;
 
-	if (!LINALG_FEQUAL(len, 0.0f) && !LINALG_FEQUAL(len, to))
+	for (size_t i = 0; i < count; i++)
 	{
-		len = to / len;
+		T d;
 
-		return fvec4(*this) * len;
+		if (intersects(aabb(vec3(minX[i], minY[i], minZ[i]), vec3(maxX[i], maxY[i], maxZ[i])), d) && (d < nearest))
+		{
+			nearest = d;
+			index = i;
+			hit = true;
+		}
 	}
 
-	return (*this);
+	if (hit)
+		distance = nearest;
+
+	return hit;
 }
 
-template<> inline dvec4 dvec4::normalize(const double &to) const
+template<typename T> bool ray_t<T>::intersectSpheres(
+	const T *centerX, const T *centerY, const T *centerZ, const T *radius,
+	const size_t count, size_t &index, T &distance, const T maxDistance) const
 {
-	double len = length();
+	T nearest = maxDistance;
+	bool hit = false;
 
-	if (!LINALG_DEQUAL(len, 0.0) && !LINALG_DEQUAL(len, to))
+	for (size_t i = 0; i < count; i++)
 	{
-		len = to / len;
+		T d;
 
-		return dvec4(*this) * len;
+		if (intersects(sphere(vec3(centerX[i], centerY[i], centerZ[i]), radius[i]), d) && (d < nearest))
+		{
+			nearest = d;
+			index = i;
+			hit = true;
+		}
 	}
 
-	return (*this);
+	if (hit)
+		distance = nearest;
+
+	return hit;
 }
 
-#pragma endregion
+template<typename T> bool ray_t<T>::intersectTriangles(
+	const T *v0X, const T *v0Y, const T *v0Z,
+	const T *v1X, const T *v1Y, const T *v1Z,
+	const T *v2X, const T *v2Y, const T *v2Z,
+	const size_t count, size_t &index, T &distance, T &u, T &v, const T maxDistance) const
+{
+	T nearest = maxDistance;
+	bool hit = false;
 
-#pragma region Check Vector Kind
+	for (size_t i = 0; i < count; i++)
+	{
+		T d, hitU, hitV;
 
-template<typename T> bool vec4_t<T>::isNullVector() const
-{
-	// It's faster to just compare to 0, than to calculate the length
-	return ((this->x == 0) && (this->y == 0) && (this->z == 0) && (this->w == 0));
-}
+		if (intersects(vec3(v0X[i], v0Y[i], v0Z[i]), vec3(v1X[i], v1Y[i], v1Z[i]), vec3(v2X[i], v2Y[i], v2Z[i]), d, hitU, hitV) && (d < nearest))
+		{
+			nearest = d;
+			index = i;
+			u = hitU;
+			v = hitV;
+			hit = true;
+		}
+	}
 
-template<> bool fvec4::isNullVector() const
-{
-	// It's faster to just compare to 0, than to calculate the length
-	return (LINALG_FEQUAL(this->x, 0.0f) && LINALG_FEQUAL(this->y, 0.0f) && LINALG_FEQUAL(this->z, 0.0f) && LINALG_FEQUAL(this->w, 0.0f));
-}
+	if (hit)
+		distance = nearest;
 
-template<> bool dvec4::isNullVector() const
-{
-	// It's faster to just compare to 0, than to calculate the length
-	return (LINALG_DEQUAL(this->x, 0.0) && LINALG_DEQUAL(this->y, 0.0) && LINALG_DEQUAL(this->z, 0.0) && LINALG_DEQUAL(this->w, 0.0));
+	return hit;
 }
 
 
-template<> inline bool fvec4::isUnitVector() const
-{
-	return LINALG_FEQUAL(lengthSquared(), 1.0f);
-}
+// The float versions test 8 shapes per iteration as two groups of 4. Lanes that hit
+// and are nearer than the current nearest are rare once a hit has been found, so they
+// are resolved with a scalar loop over the mask instead of tracking indices per lane.
 
-template<> inline bool dvec4::isUnitVector() const
+// Returns the entry distance of the 4 boxes starting at index, and a mask of the ones hit within nearest
+inline _linalg_float4 _linalg_ray_aabbs_4(
+	const _linalg_float4 origin[3], const _linalg_float4 invDirection[3],
+	const float *min[3], const float *max[3], const size_t index,
+	const float nearest, _linalg_float4 &hit)
 {
-	return LINALG_DEQUAL(lengthSquared(), 1.0f);
-}
+	_linalg_float4 tNear(0.0f), tFar(nearest);
 
+	for (int i = 0; i < 3; i++)
+	{
+		const _linalg_float4 t1 = (_linalg_float4::load(min[i] + index) - origin[i]) * invDirection[i];
+		const _linalg_float4 t2 = (_linalg_float4::load(max[i] + index) - origin[i]) * invDirection[i];
 
-template<> bool fvec4::isNormalized(const float &to) const
-{
-	const float len = length();
+		tNear = _linalg_max(tNear, _linalg_min(t1, t2));
+		tFar = _linalg_min(tFar, _linalg_max(t1, t2));
+	}
+
+	// tNear < nearest is implied, as tFar starts out at nearest
+	hit = _linalg_and(_linalg_cmple(tNear, tFar), _linalg_cmplt(tNear, _linalg_float4(nearest)));
 
-	return LINALG_FEQUAL(len, to);
+	return tNear;
 }
 
-template<> bool dvec4::isNormalized(const double &to) const
+// Returns the distance to the 4 spheres starting at index, and a mask of the ones hit within nearest
+inline _linalg_float4 _linalg_ray_spheres_4(
+	const _linalg_float4 origin[3], const _linalg_float4 direction[3], const _linalg_float4 &a,
+	const float *centerX, const float *centerY, const float *centerZ, const float *radius, const size_t index,
+	const float nearest, _linalg_float4 &hit)
 {
-	const double len = length();
+	const _linalg_float4 zero(0.0f);
 
-	return LINALG_DEQUAL(len, to);
-}
+	const _linalg_float4 ocX = _linalg_float4::load(centerX + index) - origin[0];
+	const _linalg_float4 ocY = _linalg_float4::load(centerY + index) - origin[1];
+	const _linalg_float4 ocZ = _linalg_float4::load(centerZ + index) - origin[2];
+	const _linalg_float4 r = _linalg_float4::load(radius + index);
 
+	const _linalg_float4 b = direction[0] * ocX + direction[1] * ocY + direction[2] * ocZ;
+	const _linalg_float4 c = ocX * ocX + ocY * ocY + ocZ * ocZ - r * r;
 
-template<typename T> bool vec4_t<T>::isOrthogonalTo(const vec4 &rhs) const
-{
-	return (dot(rhs) == 0);
-}
+	const _linalg_float4 discriminant = b * b - a * c;
+	const _linalg_float4 root = _linalg_sqrt(_linalg_max(discriminant, zero));
 
-template<> bool fvec4::isOrthogonalTo(const vec4 &rhs) const
-{
-	const float d = dot(rhs);
+	const _linalg_float4 tEnter = (b - root) / a;
+	const _linalg_float4 tExit = (b + root) / a;
 
-	return (LINALG_FEQUAL(d, 0.0f));
+	const _linalg_float4 t = _linalg_select(_linalg_cmpge(tEnter, zero), tEnter, tExit);
+
+	hit = _linalg_and(_linalg_and(_linalg_cmpge(discriminant, zero), _linalg_cmpge(t, zero)), _linalg_cmplt(t, _linalg_float4(nearest)));
+
+	return t;
 }
 
-template<> bool dvec4::isOrthogonalTo(const vec4 &rhs) const
+// Returns the distance to the 4 triangles starting at index, and a mask of the ones hit within nearest
+inline _linalg_float4 _linalg_ray_triangles_4(
+	const _linalg_float4 origin[3], const _linalg_float4 direction[3],
+	const float *v0[3], const float *v1[3], const float *v2[3], const size_t index,
+	const float nearest, _linalg_float4 &hit, _linalg_float4 &u, _linalg_float4 &v)
 {
-	const double d = dot(rhs);
+	const _linalg_float4 zero(0.0f), one(1.0f);
 
-	return (LINALG_DEQUAL(d, 0.0));
-}
+	const _linalg_float4 x0 = _linalg_float4::load(v0[0] + index);
+	const _linalg_float4 y0 = _linalg_float4::load(v0[1] + index);
+	const _linalg_float4 z0 = _linalg_float4::load(v0[2] + index);
 
+	const _linalg_float4 e1X = _linalg_float4::load(v1[0] + index) - x0;
+	const _linalg_float4 e1Y = _linalg_float4::load(v1[1] + index) - y0;
+	const _linalg_float4 e1Z = _linalg_float4::load(v1[2] + index) - z0;
 
-template<typename T> bool vec4_t<T>::isPerpendicularTo(const vec4 &rhs) const
-{
-	return (dot(rhs) == 0);
-}
+	const _linalg_float4 e2X = _linalg_float4::load(v2[0] + index) - x0;
+	const _linalg_float4 e2Y = _linalg_float4::load(v2[1] + index) - y0;
+	const _linalg_float4 e2Z = _linalg_float4::load(v2[2] + index) - z0;
 
-template<> bool fvec4::isPerpendicularTo(const vec4 &rhs) const
-{
-	const float d = dot(rhs);
+	// p = direction x edge2
+	const _linalg_float4 pX = direction[1] * e2Z - direction[2] * e2Y;
+	const _linalg_float4 pY = direction[2] * e2X - direction[0] * e2Z;
+	const _linalg_float4 pZ = direction[0] * e2Y - direction[1] * e2X;
 
-	return (LINALG_FEQUAL(d, 0.0f));
-}
+	const _linalg_float4 det = e1X * pX + e1Y * pY + e1Z * pZ;
+	const _linalg_float4 invDet = one / det;
 
-template<> bool dvec4::isPerpendicularTo(const vec4 &rhs) const
-{
-	const double d = dot(rhs);
+	const _linalg_float4 sX = origin[0] - x0;
+	const _linalg_float4 sY = origin[1] - y0;
+	const _linalg_float4 sZ = origin[2] - z0;
 
-	return (LINALG_DEQUAL(d, 0.0));
-}
+	u = (sX * pX + sY * pY + sZ * pZ) * invDet;
 
+	// q = s x edge1
+	const _linalg_float4 qX = sY * e1Z - sZ * e1Y;
+	const _linalg_float4 qY = sZ * e1X - sX * e1Z;
+	const _linalg_float4 qZ = sX * e1Y - sY * e1X;
 
-template<typename T> bool vec4_t<T>::isParallelTo(const vec4 &rhs) const
-{
-	return (dot(rhs) == 1);
+	v = (direction[0] * qX + direction[1] * qY + direction[2] * qZ) * invDet;
+
+	const _linalg_float4 t = (e2X * qX + e2Y * qY + e2Z * qZ) * invDet;
+
+	// A zero determinant results in infinities or NaNs, which fail the comparisons below
+	hit = _linalg_and(_linalg_cmpge(u, zero), _linalg_cmpge(v, zero));
+	hit = _linalg_and(hit, _linalg_cmple(u + v, one));
+	hit = _linalg_and(hit, _linalg_and(_linalg_cmpge(t, zero), _linalg_cmplt(t, _linalg_float4(nearest))));
+
+	return t;
 }
 
-template<> bool fvec4::isParallelTo(const vec4 &rhs) const
+// Updates the nearest hit from the lanes set in mask
+inline bool _linalg_ray_nearest_4(const int mask, const _linalg_float4 &t, const size_t index, float &nearest, size_t &nearestIndex)
 {
-	const float d = dot(rhs);
+	bool found = false;
 
-	return (LINALG_FEQUAL(d, 1.0f));
+	for (int lane = 0; lane < 4; lane++)
+	{
+		if ((mask & (1 << lane)) && (t[lane] < nearest))
+		{
+			nearest = t[lane];
+			nearestIndex = index + static_cast<size_t>(lane);
+			found = true;
+		}
+	}
+
+	return found;
 }
 
-template<> bool dvec4::isParallelTo(const vec4 &rhs) const
+template<> inline bool fray::intersectAABBs(
+	const float *minX, const float *minY, const float *minZ,
+	const float *maxX, const float *maxY, const float *maxZ,
+	const size_t count, size_t &index, float &distance, const float maxDistance) const
 {
-	const double d = dot(rhs);
+	const float *min[3] = { minX, minY, minZ };
+	const float *max[3] = { maxX, maxY, maxZ };
 
-	return (LINALG_DEQUAL(d, 1.0));
-}
+	const _linalg_float4 origin[3] = { _linalg_float4(this->origin.x), _linalg_float4(this->origin.y), _linalg_float4(this->origin.z) };
+	const _linalg_float4 invDirection[3] = { _linalg_float4(1.0f / this->direction.x), _linalg_float4(1.0f / this->direction.y), _linalg_float4(1.0f / this->direction.z) };
 
-#pragma endregion
+	float nearest = maxDistance;
+	size_t nearestIndex = 0;
+	bool hit = false;
 
-#pragma region Validate sizeof Templated Objects
+	size_t i = 0;
 
-#ifdef DEBUG
+	for (; (i + 8) <= count; i += 8)
+	{
+		_linalg_float4 hitLow, hitHigh;
 
-#ifndef STATIC_ASSERT
-#	define STATIC_ASSERT(bool_constexpr) static_assert(bool_constexpr, #bool_constexpr)
-#endif
+		const _linalg_float4 tLow = _linalg_ray_aabbs_4(origin, invDirection, min, max, i, nearest, hitLow);
+		const _linalg_float4 tHigh = _linalg_ray_aabbs_4(origin, invDirection, min, max, i + 4, nearest, hitHigh);
 
-STATIC_ASSERT(sizeof(vec4_t<float>) == (sizeof(float) * 4));
-STATIC_ASSERT(sizeof(vec4_t<double>) == (sizeof(double) * 4));
+		const int maskLow = _linalg_movemask(hitLow);
+		const int maskHigh = _linalg_movemask(hitHigh);
 
-STATIC_ASSERT(sizeof(vec4_t<signed int>) == (sizeof(signed int) * 4));
-STATIC_ASSERT(sizeof(vec4_t<unsigned int>) == (sizeof(unsigned int) * 4));
+		if (maskLow | maskHigh)
+		{
+			hit |= _linalg_ray_nearest_4(maskLow, tLow, i, nearest, nearestIndex);
+			hit |= _linalg_ray_nearest_4(maskHigh, tHigh, i + 4, nearest, nearestIndex);
+		}
+	}
 
-STATIC_ASSERT(sizeof(vec4_t<bool>) == (sizeof(bool) * 4));
+	for (; i < count; i++)
+	{
+		float d;
 
-STATIC_ASSERT(sizeof(vec4_t<signed long>) == (sizeof(signed long) * 4));
-STATIC_ASSERT(sizeof(vec4_t<unsigned long>) == (sizeof(unsigned long) * 4));
+		if (intersects(faabb(fvec3(minX[i], minY[i], minZ[i]), fvec3(maxX[i], maxY[i], maxZ[i])), d) && (d < nearest))
+		{
+			nearest = d;
+			nearestIndex = i;
+			hit = true;
+		}
+	}
 
-STATIC_ASSERT(sizeof(vec4_t<signed long long>) == (sizeof(signed long long) * 4));
-STATIC_ASSERT(sizeof(vec4_t<unsigned long long>) == (sizeof(unsigned long long) * 4));
+	if (hit)
+	{
+		index = nearestIndex;
+		distance = nearest;
+	}
 
-#endif
+	return hit;
+}
 
-#pragma endregion
+template<> inline bool fray::intersectSpheres(
+	const float *centerX, const float *centerY, const float *centerZ, const float *radius,
+	const size_t count, size_t &index, float &distance, const float maxDistance) const
+{
+	const _linalg_float4 origin[3] = { _linalg_float4(this->origin.x), _linalg_float4(this->origin.y), _linalg_float4(this->origin.z) };
+	const _linalg_float4 direction[3] = { _linalg_float4(this->direction.x), _linalg_float4(this->direction.y), _linalg_float4(this->direction.z) };
+	const _linalg_float4 a(this->direction.lengthSquared());
 
-#pragma endregion
+	float nearest = maxDistance;
+	size_t nearestIndex = 0;
+	bool hit = false;
 
+	size_t i = 0;
 
-#pragma region mat2
+	for (; (i + 8) <= count; i += 8)
+	{
+		_linalg_float4 hitLow, hitHigh;
 
-#pragma region Static Members
+		const _linalg_float4 tLow = _linalg_ray_spheres_4(origin, direction, a, centerX, centerY, centerZ, radius, i, nearest, hitLow);
+		const _linalg_float4 tHigh = _linalg_ray_spheres_4(origin, direction, a, centerX, centerY, centerZ, radius, i + 4, nearest, hitHigh);
 
-template<typename T> const mat2_t<T> mat2_t<T>::zero = mat2_t<T>(T(0));
-template<typename T> const mat2_t<T> mat2_t<T>::identity = mat2_t<T>(T(1));
+		const int maskLow = _linalg_movemask(hitLow);
+		const int maskHigh = _linalg_movemask(hitHigh);
 
-#pragma endregion
+		if (maskLow | maskHigh)
+		{
+			hit |= _linalg_ray_nearest_4(maskLow, tLow, i, nearest, nearestIndex);
+			hit |= _linalg_ray_nearest_4(maskHigh, tHigh, i + 4, nearest, nearestIndex);
+		}
+	}
 
-#pragma region Constructors
+	for (; i < count; i++)
+	{
+		float d;
 
-template<typename T>
-template<typename T2>
-mat2_t<T>::mat2_t(const mat3_t<T2> &m)
-{
-	this->columns[0] = vec2(m.columns[0]);
-	this->columns[1] = vec2(m.columns[1]);
+		if (intersects(fsphere(fvec3(centerX[i], centerY[i], centerZ[i]), radius[i]), d) && (d < nearest))
+		{
+			nearest = d;
+			nearestIndex = i;
+			hit = true;
+		}
+	}
+
+	if (hit)
+	{
+		index = nearestIndex;
+		distance = nearest;
+	}
+
+	return hit;
 }
 
-template<typename T>
-template<typename T2>
-mat2_t<T>::mat2_t(const mat4_t<T2> &m)
+template<> inline bool fray::intersectTriangles(
+	const float *v0X, const float *v0Y, const float *v0Z,
+	const float *v1X, const float *v1Y, const float *v1Z,
+	const float *v2X, const float *v2Y, const float *v2Z,
+	const size_t count, size_t &index, float &distance, float &u, float &v, const float maxDistance) const
 {
-	this->columns[0] = vec2(m.columns[0]);
-	this->columns[1] = vec2(m.columns[1]);
-}
+	const float *v0[3] = { v0X, v0Y, v0Z };
+	const float *v1[3] = { v1X, v1Y, v1Z };
+	const float *v2[3] = { v2X, v2Y, v2Z };
 
-#pragma endregion
+	const _linalg_float4 origin[3] = { _linalg_float4(this->origin.x), _linalg_float4(this->origin.y), _linalg_float4(this->origin.z) };
+	const _linalg_float4 direction[3] = { _linalg_float4(this->direction.x), _linalg_float4(this->direction.y), _linalg_float4(this->direction.z) };
 
-#pragma region Comparison Operators
+	float nearest = maxDistance;
+	size_t nearestIndex = 0;
+	bool hit = false;
 
-template<typename T> inline bool mat2_t<T>::operator==(const mat2_t &rhs) const
-{
-	for (int i = 0; i < 2; i++)
-		if ((*this)[i] != rhs[i])
-			return false;
+	size_t i = 0;
 
-	return true;
-}
+	for (; (i + 8) <= count; i += 8)
+	{
+		_linalg_float4 hitLow, hitHigh, uLow, uHigh, vLow, vHigh;
 
-template<> inline bool mat2_t<float>::operator==(const mat2_t<float> &rhs) const
-{
-	for (int i = 0; i < 2; i++)
-		if (!LINALG_FEQUAL((*this)[i], rhs[i]))
-			return false;
+		const _linalg_float4 tLow = _linalg_ray_triangles_4(origin, direction, v0, v1, v2, i, nearest, hitLow, uLow, vLow);
+		const _linalg_float4 tHigh = _linalg_ray_triangles_4(origin, direction, v0, v1, v2, i + 4, nearest, hitHigh, uHigh, vHigh);
 
-	return true;
-}
+		const int maskLow = _linalg_movemask(hitLow);
+		const int maskHigh = _linalg_movemask(hitHigh);
 
-template<> inline bool mat2_t<double>::operator==(const mat2_t<double> &rhs) const
-{
-	for (int i = 0; i < 2; i++)
-		if (!LINALG_DEQUAL((*this)[i], rhs[i]))
-			return false;
+		if (maskLow | maskHigh)
+		{
+			if (_linalg_ray_nearest_4(maskLow, tLow, i, nearest, nearestIndex))
+			{
+				u = uLow[static_cast<int>(nearestIndex - i)];
+				v = vLow[static_cast<int>(nearestIndex - i)];
+				hit = true;
+			}
 
-	return true;
+			if (_linalg_ray_nearest_4(maskHigh, tHigh, i + 4, nearest, nearestIndex))
+			{
+				u = uHigh[static_cast<int>(nearestIndex - i - 4)];
+				v = vHigh[static_cast<int>(nearestIndex - i - 4)];
+				hit = true;
+			}
+		}
+	}
+
+	for (; i < count; i++)
+	{
+		float d, hitU, hitV;
+
+		if (intersects(fvec3(v0X[i], v0Y[i], v0Z[i]), fvec3(v1X[i], v1Y[i], v1Z[i]), fvec3(v2X[i], v2Y[i], v2Z[i]), d, hitU, hitV) && (d < nearest))
+		{
+			nearest = d;
+			nearestIndex = i;
+			u = hitU;
+			v = hitV;
+			hit = true;
+		}
+	}
+
+	if (hit)
+	{
+		index = nearestIndex;
+		distance = nearest;
+	}
+
+	return hit;
 }
 
 #pragma endregion
@@ -4746,125 +10221,173 @@ template<> inline bool mat2_t<double>::operator==(const mat2_t<double> &rhs) con
 #pragma endregion
 
 
-#pragma region mat3
+#pragma region half
 
-#pragma region Static Members
+#ifndef LINALG_F16C
 
-template<typename T> const mat3_t<T> mat3_t<T>::zero = mat3_t<T>(T(0));
-template<typename T> const mat3_t<T> mat3_t<T>::identity = mat3_t<T>(T(1));
+// The lookup tables used without F16C, based on "Fast Half Float Conversions" by Jeroen van der Zijp,
+// indexed by the sign and exponent of a float (base and shift) or a half (exponent and offset)
+struct _linalg_half_tables
+{
+	unsigned short base[512];
+	unsigned char shift[512];
 
-#pragma endregion
+	unsigned int mantissa[2048];
+	unsigned int exponent[64];
+	unsigned short offset[64];
 
-#pragma region Constructors
+	_linalg_half_tables()
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			const int e = i - 127;
 
-template<typename T>
-template<typename T2>
-mat3_t<T>::mat3_t(const mat4_t<T2> &m)
-{
-	this->columns[0] = vec3(m.columns[0]);
-	this->columns[1] = vec3(m.columns[1]);
-	this->columns[2] = vec3(m.columns[2]);
-}
+			unsigned short b;
+			unsigned char s;
 
-#pragma endregion
+			// The mantissa is shifted including its implicit bit, hence normal exponents being 1 less
+			if (e < -25) { b = 0; s = 25; } // Rounds to zero
+			else if (e < -14) { b = 0; s = static_cast<unsigned char>(-e - 1); } // Subnormal
+			else if (e < 16) { b = static_cast<unsigned short>((e + 14) << 10); s = 13; } // Normal
+			else { b = 0x7C00; s = 25; } // Infinity
 
-#pragma region Comparison Operators
+			this->base[i] = b;
+			this->base[i | 0x100] = static_cast<unsigned short>(b | 0x8000);
+			this->shift[i] = this->shift[i | 0x100] = s;
+		}
 
-template<typename T> inline bool mat3_t<T>::operator==(const mat3_t &rhs) const
-{
-	for (int i = 0; i < 3; i++)
-		if ((*this)[i] != rhs[i])
-			return false;
+		this->mantissa[0] = 0;
 
-	return true;
-}
+		for (unsigned int i = 1; i < 1024; i++)
+		{
+			// Normalize the subnormal halves
+			unsigned int m = i << 13, e = 0;
 
-template<> inline bool mat3_t<float>::operator==(const mat3_t<float> &rhs) const
-{
-	for (int i = 0; i < 3; i++)
-		if (!LINALG_FEQUAL((*this)[i], rhs[i]))
-			return false;
+			while (!(m & 0x00800000u))
+			{
+				e -= 0x00800000u;
+				m <<= 1;
+			}
 
-	return true;
-}
+			this->mantissa[i] = (m & ~0x00800000u) | (e + 0x38800000u);
+		}
 
-template<> inline bool mat3_t<double>::operator==(const mat3_t<double> &rhs) const
-{
-	for (int i = 0; i < 3; i++)
-		if (!LINALG_DEQUAL((*this)[i], rhs[i]))
-			return false;
+		for (unsigned int i = 1024; i < 2048; i++)
+			this->mantissa[i] = 0x38000000u + ((i - 1024) << 13);
 
-	return true;
-}
+		for (unsigned int i = 0; i < 64; i++)
+		{
+			this->exponent[i] = ((i & 0x1F) << 23) | ((i & 0x20) << 26);
+			this->offset[i] = 1024;
+		}
 
-#pragma endregion
+		this->exponent[0] = 0;
+		this->exponent[31] = 0x47800000u;
+		this->exponent[32] = 0x80000000u;
+		this->exponent[63] = 0xC7800000u;
 
-#pragma endregion
+		this->offset[0] = this->offset[32] = 0;
+	}
 
+	static inline const _linalg_half_tables& get()
+	{
+		static const _linalg_half_tables tables;
+		return tables;
+	}
+};
 
-#pragma region mat4
+#endif
 
-#pragma region Static Members
+inline unsigned short half::fromFloat(const float f)
+{
+#ifdef LINALG_F16C
 
-template<typename T> const mat4_t<T> mat4_t<T>::zero = mat4_t<T>(T(0));
-template<typename T> const mat4_t<T> mat4_t<T>::identity = mat4_t<T>(T(1));
+	return static_cast<unsigned short>(_cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT));
 
-#pragma endregion
+#else
 
-#pragma region Constructors
+	unsigned int bits;
+	memcpy(&bits, &f, sizeof(bits));
 
+	// Infinity stays infinity and NaN stays a (quiet) NaN
+	if ((bits & 0x7F800000u) == 0x7F800000u)
+		return static_cast<unsigned short>(((bits >> 16) & 0x8000u) | 0x7C00u | ((bits & 0x007FFFFFu) ? (0x0200u | ((bits >> 13) & 0x03FFu)) : 0u));
 
+	const _linalg_half_tables &tables = _linalg_half_tables::get();
 
-#pragma endregion
+	const unsigned int index = bits >> 23;
+	const unsigned int mantissa = (bits & 0x007FFFFFu) | 0x00800000u;
+	const unsigned int shift = tables.shift[index];
 
-#pragma region Comparison Operators
+	unsigned int h = tables.base[index] + (mantissa >> shift);
 
-template<typename T> inline bool mat4_t<T>::operator==(const mat4_t &rhs) const
-{
-	for (int i = 0; i < 4; i++)
-		if ((*this)[i] != rhs[i])
-			return false;
+	// Round to nearest even, where a carry into the exponent is still correct
+	const unsigned int roundBit = 1u << (shift - 1);
 
-	return true;
+	if ((mantissa & roundBit) && (mantissa & (roundBit * 3 - 1)))
+		h++;
+
+	return static_cast<unsigned short>(h);
+
+#endif
 }
 
-template<> inline bool mat4_t<float>::operator==(const mat4_t<float> &rhs) const
+inline float half::toFloat(const unsigned short bits)
 {
-	for (int i = 0; i < 4; i++)
-		if (!LINALG_FEQUAL((*this)[i], rhs[i]))
-			return false;
+#ifdef LINALG_F16C
 
-	return true;
+	return _cvtsh_ss(bits);
+
+#else
+
+	const _linalg_half_tables &tables = _linalg_half_tables::get();
+
+	unsigned int f = tables.mantissa[tables.offset[bits >> 10] + (bits & 0x03FFu)] + tables.exponent[bits >> 10];
+
+	// Quiet signaling NaNs, like F16C does
+	if (((bits & 0x7C00u) == 0x7C00u) && (bits & 0x03FFu))
+		f |= 0x00400000u;
+
+	float result;
+	memcpy(&result, &f, sizeof(result));
+
+	return result;
+
+#endif
 }
 
-template<> inline bool mat4_t<double>::operator==(const mat4_t<double> &rhs) const
+inline void half::convert(const float *source, const size_t count, half *result)
 {
-	for (int i = 0; i < 4; i++)
-		if (!LINALG_DEQUAL((*this)[i], rhs[i]))
-			return false;
+	size_t i = 0;
 
-	return true;
-}
+#ifdef LINALG_F16C
 
-#pragma endregion
+	for (; (i + 8) <= count; i += 8)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT));
 
-#pragma endregion
+#endif
 
+	for (; i < count; i++)
+		result[i].bits = fromFloat(source[i]);
+}
 
-#pragma region quat
+inline void half::convert(const half *source, const size_t count, float *result)
+{
+	size_t i = 0;
 
-#pragma region Static Members
+#ifdef LINALG_F16C
 
-template<typename T> const quat_t<T> quat_t<T>::zero = vec4_t<T>(T(0), T(0), T(0), T(0));
-template<typename T> const quat_t<T> quat_t<T>::one = vec4_t<T>(T(1), T(1), T(1), T(1));
+	for (; (i + 8) <= count; i += 8)
+		_mm256_storeu_ps(result + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))));
 
-template<typename T> const quat_t<T> quat_t<T>::identity = vec4_t<T>(T(0), T(0), T(0), T(1));
+#endif
 
-#pragma endregion
+	for (; i < count; i++)
+		result[i] = toFloat(source[i].bits);
+}
 
 #pragma endregion
 
-
 // Enable structure padding
 #pragma pack(pop)
 
@@ -18,18 +18,210 @@
 
 
 #include <stack>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include <cstddef>
+#include <cstdlib>
 
 #include "linalg.hpp"
 
 
+// BMI2 (pdep/pext) is used for Morton codes when the compiler targets it, e.g. with -mbmi2
+// or /arch:AVX2. Note that pdep/pext are microcoded and slow on AMD prior to Zen 3.
+#if !defined(LINALG_NO_SIMD) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#	define LINALG_BMI2 1
+#endif
+
+#ifdef LINALG_BMI2
+#	include <immintrin.h>
+#endif
+
+
 template<typename T> class MatrixStackT;
 
 typedef MatrixStackT<float> MatrixStack;
 typedef MatrixStackT<double> MatrixStackD;
 
 
+template<typename T> struct SkinningStreamsT;
+
+typedef SkinningStreamsT<float> SkinningStreams;
+typedef SkinningStreamsT<double> SkinningStreamsD;
+
+
+template<typename T> class LinearBlendSkinningT;
+
+typedef LinearBlendSkinningT<float> LinearBlendSkinning;
+typedef LinearBlendSkinningT<double> LinearBlendSkinningD;
+
+
+template<typename T> class BoundingVolumeHierarchyT;
+
+typedef BoundingVolumeHierarchyT<float> BoundingVolumeHierarchy;
+typedef BoundingVolumeHierarchyT<double> BoundingVolumeHierarchyD;
+
+
+class Morton;
+
+
+template<typename T> class LinearBoundingVolumeHierarchyT;
+
+typedef LinearBoundingVolumeHierarchyT<float> LinearBoundingVolumeHierarchy;
+typedef LinearBoundingVolumeHierarchyT<double> LinearBoundingVolumeHierarchyD;
+
+
+template<typename T> class SpatialHashGridT;
+
+typedef SpatialHashGridT<float> SpatialHashGrid;
+typedef SpatialHashGridT<double> SpatialHashGridD;
+
+
+template<typename T> class KdTreeT;
+
+typedef KdTreeT<float> KdTree;
+typedef KdTreeT<double> KdTreeD;
+
+
+class OcclusionCuller;
+
+
+template<typename T> class ClusterGridT;
+
+typedef ClusterGridT<float> ClusterGrid;
+typedef ClusterGridT<double> ClusterGridD;
+
+
+template<typename T> class ShadowCascadesT;
+
+typedef ShadowCascadesT<float> ShadowCascades;
+typedef ShadowCascadesT<double> ShadowCascadesD;
+
+
+// The GLSL block layouts, std140 for uniform blocks and std430 for shader storage blocks
+enum BufferLayout
+{
+	Std140,
+	Std430
+};
+
+template<BufferLayout Layout, typename Type> struct BufferElement;
+
+class BufferPacker;
+
+
+// Splits [0, count) into contiguous ranges and calls function(begin, end) for each
+// range on its own thread, with the calling thread handling the first range. Ranges
+// are never smaller than minRange, unless count is and there's a single range. A
+// threadCount of 0 means one per hardware thread.
+template<typename Function>
+void _linalg_parallel_for(const size_t count, const size_t minRange, unsigned int threadCount, Function function)
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+
+	// Rounded down, such that each thread gets at least minRange
+	const size_t maxThreadCount = count / ((minRange > 0) ? minRange : 1);
+
+	if (threadCount > maxThreadCount)
+		threadCount = static_cast<unsigned int>(maxThreadCount);
+
+	if (threadCount <= 1)
+	{
+		function(size_t(0), count);
+		return;
+	}
+
+	// Keep ranges a multiple of 16, such that only the last range has a tail left over by the batch functions
+	const size_t range = (((count + threadCount - 1) / threadCount) + 15) & ~size_t(15);
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+
+	// Rounding up the ranges can leave a last range smaller than minRange, which is merged into the one before it
+	const size_t firstEnd = (count < (range + minRange)) ? count : range;
+
+	for (size_t begin = firstEnd; begin < count;)
+	{
+		const size_t end = ((count - begin) < (range + minRange)) ? count : (begin + range);
+
+		threads.push_back(std::thread(function, begin, end));
+
+		begin = end;
+	}
+
+	function(size_t(0), firstEnd);
+
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+
+// The amount of chunks _linalg_parallel_chunks() should split count elements into,
+// such that no chunk is smaller than minRange, unless count is and there's a single
+// chunk, and there's at most one per thread.
+inline size_t _linalg_chunk_count(const size_t count, const size_t minRange, unsigned int threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+
+	// Rounded down, such that each chunk gets at least minRange
+	const size_t maxChunkCount = count / ((minRange > 0) ? minRange : 1);
+
+	return std::max(size_t(1), std::min(size_t(threadCount), maxChunkCount));
+}
+
+// Splits [0, count) into chunkCount contiguous chunks and calls function(chunk, begin, end)
+// for each on its own thread. Unlike _linalg_parallel_for() the chunk index is passed along,
+// for functions that need per chunk results, e.g. histograms that are merged afterwards.
+template<typename Function>
+void _linalg_parallel_chunks(const size_t count, const size_t chunkCount, Function function)
+{
+	if (chunkCount <= 1)
+	{
+		function(size_t(0), size_t(0), count);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	threads.reserve(chunkCount - 1);
+
+	// The chunks differ by at most one element, such that none is smaller than count / chunkCount
+	const size_t chunkSize = count / chunkCount, remainder = count % chunkCount;
+
+	for (size_t chunk = 1; chunk < chunkCount; chunk++)
+	{
+		const size_t begin = chunk * chunkSize + std::min(chunk, remainder);
+		const size_t end = begin + chunkSize + ((chunk < remainder) ? 1 : 0);
+
+		threads.push_back(std::thread(function, chunk, begin, end));
+	}
+
+	function(size_t(0), size_t(0), chunkSize + ((remainder > 0) ? 1 : 0));
+
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+
+// Count leading zeros, where 0 results in the amount of bits
+inline int _linalg_clz32(const unsigned int x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (x == 0) ? 32 : __builtin_clz(x);
+#else
+	int n = 0;
+
+	for (unsigned int bit = 0x80000000u; bit && !(x & bit); bit >>= 1)
+		n++;
+
+	return n;
+#endif
+}
+
+
 template<typename T>
 class MatrixStackT
 {
@@ -112,4 +304,3437 @@ public:
 };
 
 
+
+// Vertex streams consumed by the skinning functions. The bone indices and weights
+// are stored as a structure of arrays, i.e. boneIndices[k][vertex] is the bone
+// index of the k-th influence of that vertex. The streams aren't owned.
+template<typename T>
+struct SkinningStreamsT
+{
+	size_t count;
+
+	// The amount of influences per vertex, from 1 to 4
+	int influences;
+
+	const vec3_t<T> *positions;
+
+	// Optional, can be nullptr
+	const vec3_t<T> *normals;
+
+	const unsigned int *boneIndices[4];
+	const T *boneWeights[4];
+
+
+	SkinningStreamsT() : count(0), influences(0), positions(nullptr), normals(nullptr)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			this->boneIndices[i] = nullptr;
+			this->boneWeights[i] = nullptr;
+		}
+	}
+};
+
+
+// Linear blend skinning over a palette of bone matrices. For each vertex the bone
+// matrices are blended by their weights, and the result transforms the position
+// and normal. Normals are transformed by the blended 3x3 part and renormalized,
+// which assumes the bones don't contain non-uniform scaling.
+template<typename T>
+class LinearBlendSkinningT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+
+	typedef mat4_t<T> mat4;
+	typedef affine_t<T> affine;
+
+	typedef SkinningStreamsT<T> SkinningStreams;
+
+
+public:
+
+	// Meshes with fewer vertices than this per thread aren't split any further
+	static const size_t minVerticesPerThread = 4096;
+
+
+	// Skins the vertices in [begin, end) on the calling thread, this is
+	// useful when the work is already being distributed by a job system.
+	static void skinRange(
+		const affine *palette, const SkinningStreams &streams,
+		vec3 *skinnedPositions, vec3 *skinnedNormals,
+		const size_t begin, const size_t end);
+
+
+	// Normals are only written if both streams.normals and skinnedNormals
+	// are given. A threadCount of 0 uses one thread per hardware thread.
+	static void skin(
+		const affine *palette, const SkinningStreams &streams,
+		vec3 *skinnedPositions, vec3 *skinnedNormals = nullptr,
+		const unsigned int threadCount = 0)
+	{
+		_linalg_parallel_for(streams.count, minVerticesPerThread, threadCount, [&](const size_t begin, const size_t end)
+		{
+			skinRange(palette, streams, skinnedPositions, skinnedNormals, begin, end);
+		});
+	}
+
+	// The mat4 palette is converted into compact affine matrices first
+	static void skin(
+		const mat4 *palette, const size_t paletteSize, const SkinningStreams &streams,
+		vec3 *skinnedPositions, vec3 *skinnedNormals = nullptr,
+		const unsigned int threadCount = 0)
+	{
+		std::vector<affine> affinePalette(palette, palette + paletteSize);
+
+		skin(affinePalette.data(), streams, skinnedPositions, skinnedNormals, threadCount);
+	}
+
+
+	// Blends the bone matrices influencing a single vertex
+	static affine blend(const affine *palette, const SkinningStreams &streams, const size_t vertex)
+	{
+		affine m = palette[streams.boneIndices[0][vertex]] * streams.boneWeights[0][vertex];
+
+		for (int k = 1; k < streams.influences; k++)
+			m += palette[streams.boneIndices[k][vertex]] * streams.boneWeights[k][vertex];
+
+		return m;
+	}
+};
+
+
+template<typename T>
+void LinearBlendSkinningT<T>::skinRange(
+	const affine *palette, const SkinningStreams &streams,
+	vec3 *skinnedPositions, vec3 *skinnedNormals,
+	const size_t begin, const size_t end)
+{
+	const bool hasNormals = (streams.normals && skinnedNormals);
+
+	for (size_t i = begin; i < end; i++)
+	{
+		const affine m = blend(palette, streams, i);
+
+		skinnedPositions[i] = m.transformPoint(streams.positions[i]);
+
+		if (hasNormals)
+			skinnedNormals[i] = normalize(m.transformVector(streams.normals[i]));
+	}
+}
+
+template<>
+inline void LinearBlendSkinningT<float>::skinRange(
+	const faffine *palette, const SkinningStreamsT<float> &streams,
+	fvec3 *skinnedPositions, fvec3 *skinnedNormals,
+	const size_t begin, const size_t end)
+{
+	const bool hasNormals = (streams.normals && skinnedNormals);
+
+	const _linalg_float4 zero(0.0f), one(1.0f), tiny(1E-20f);
+
+	size_t i = begin;
+
+	for (; (i + 4) <= end; i += 4)
+	{
+		// m[row][column] of the blended matrices of the 4 vertices
+		_linalg_float4 m[3][4];
+
+		for (int r = 0; r < 3; r++)
+			for (int c = 0; c < 4; c++)
+				m[r][c] = zero;
+
+		for (int k = 0; k < streams.influences; k++)
+		{
+			const unsigned int *indices = streams.boneIndices[k] + i;
+			const _linalg_float4 weight = _linalg_float4::load(streams.boneWeights[k] + i);
+
+			for (int r = 0; r < 3; r++)
+			{
+				_linalg_float4 c0 = _linalg_float4::load(&palette[indices[0]].rows[r].x);
+				_linalg_float4 c1 = _linalg_float4::load(&palette[indices[1]].rows[r].x);
+				_linalg_float4 c2 = _linalg_float4::load(&palette[indices[2]].rows[r].x);
+				_linalg_float4 c3 = _linalg_float4::load(&palette[indices[3]].rows[r].x);
+
+				_linalg_transpose4(c0, c1, c2, c3);
+
+				m[r][0] = m[r][0] + weight * c0;
+				m[r][1] = m[r][1] + weight * c1;
+				m[r][2] = m[r][2] + weight * c2;
+				m[r][3] = m[r][3] + weight * c3;
+			}
+		}
+
+		_linalg_float4 x, y, z;
+		_linalg_load3x4(&streams.positions[i].x, x, y, z);
+
+		_linalg_store3x4(&skinnedPositions[i].x,
+			m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3],
+			m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3],
+			m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3]);
+
+		if (hasNormals)
+		{
+			_linalg_load3x4(&streams.normals[i].x, x, y, z);
+
+			const _linalg_float4 nx = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+			const _linalg_float4 ny = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+			const _linalg_float4 nz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+
+			const _linalg_float4 invLength = one / _linalg_sqrt(_linalg_max(nx * nx + ny * ny + nz * nz, tiny));
+
+			_linalg_store3x4(&skinnedNormals[i].x, nx * invLength, ny * invLength, nz * invLength);
+		}
+	}
+
+	for (; i < end; i++)
+	{
+		const faffine m = blend(palette, streams, i);
+
+		skinnedPositions[i] = m.transformPoint(streams.positions[i]);
+
+		if (hasNormals)
+			skinnedNormals[i] = normalize(m.transformVector(streams.normals[i]));
+	}
+}
+
+
+// A bounding volume hierarchy over either a triangle mesh or a set of AABBs. The
+// hierarchy is built top-down, splitting each node where the surface area heuristic
+// (SAH) estimates the cheapest traversal, evaluated at a fixed number of bins along
+// each axis. Subtrees near the root are built on separate threads.
+//
+// The nodes are stored depth-first in a single array, such that the left child
+// directly follows its parent and only the index of the right child is stored.
+// The geometry isn't copied, so it must outlive the hierarchy.
+//
+// Reference: Wald, "On fast Construction of SAH-based Bounding Volume Hierarchies" (2007)
+template<typename T>
+class BoundingVolumeHierarchyT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+
+	typedef aabb_t<T> aabb;
+	typedef ray_t<T> ray;
+
+
+public:
+
+	struct Node
+	{
+		aabb bounds;
+
+		// For leaves the first of count primitives in primitiveIndices,
+		// otherwise the index of the right child.
+		unsigned int offset;
+
+		// 0 for interior nodes
+		unsigned int count;
+
+		inline bool isLeaf() const { return (this->count > 0); }
+	};
+
+
+	static const int binCount = 16;
+	static const unsigned int maxLeafSize = 4;
+
+	// Deeper nodes are made leaves regardless of size, which bounds the traversal stacks
+	static const int maxDepth = 48;
+
+	// Subtrees with fewer primitives than this aren't split across threads
+	static const size_t minPrimitivesPerThread = 16384;
+
+
+	std::vector<Node> nodes;
+
+	// The primitives referenced by the leaves, as indices into the geometry
+	std::vector<unsigned int> primitiveIndices;
+
+
+private:
+
+	const vec3 *vertices;
+	const unsigned int *indices;
+
+	const aabb *primitiveBounds;
+
+	size_t primitiveCount;
+
+
+public:
+
+	BoundingVolumeHierarchyT() : vertices(nullptr), indices(nullptr), primitiveBounds(nullptr), primitiveCount(0) {}
+
+	~BoundingVolumeHierarchyT() {}
+
+
+	// Builds the hierarchy over triangleCount triangles, where triangle i is made of the
+	// vertices indices[i * 3 + 0..2]. If indices is nullptr, triangle i is made of
+	// vertices[i * 3 + 0..2]. A threadCount of 0 uses one thread per hardware thread.
+	void build(const vec3 *vertices, const unsigned int *indices, const size_t triangleCount, const unsigned int threadCount = 0)
+	{
+		this->vertices = vertices;
+		this->indices = indices;
+		this->primitiveBounds = nullptr;
+		this->primitiveCount = triangleCount;
+
+		buildNodes(threadCount);
+	}
+
+	// Builds the hierarchy over arbitrary primitives given by their bounds. Only
+	// overlap queries are supported, as the primitives themselves are unknown.
+	void build(const aabb *primitiveBounds, const size_t count, const unsigned int threadCount = 0)
+	{
+		this->vertices = nullptr;
+		this->indices = nullptr;
+		this->primitiveBounds = primitiveBounds;
+		this->primitiveCount = count;
+
+		buildNodes(threadCount);
+	}
+
+	void clear()
+	{
+		this->nodes.clear();
+		this->primitiveIndices.clear();
+
+		this->primitiveCount = 0;
+	}
+
+	inline bool empty() const { return this->nodes.empty(); }
+	inline bool hasTriangles() const { return (this->vertices != nullptr); }
+
+
+	// Recomputes the bounds of all nodes bottom-up after the geometry moved, while
+	// keeping the topology. This is a lot faster than rebuilding, but the quality of
+	// the hierarchy degrades if the geometry deforms a lot relative to the build.
+	void refit()
+	{
+		// Children are always stored after their parent
+		for (size_t i = this->nodes.size(); i-- > 0;)
+		{
+			Node &node = this->nodes[i];
+
+			if (node.isLeaf())
+			{
+				node.bounds = getPrimitiveBounds(this->primitiveIndices[node.offset]);
+
+				for (unsigned int j = 1; j < node.count; j++)
+					node.bounds.merge(getPrimitiveBounds(this->primitiveIndices[node.offset + j]));
+			}
+			else
+				node.bounds = merge(this->nodes[i + 1].bounds, this->nodes[node.offset].bounds);
+		}
+	}
+
+
+	// Finds the nearest triangle hit closer than maxDistance, see ray_t::intersects()
+	bool intersect(const ray &r, size_t &triangle, T &distance, T &u, T &v, const T maxDistance = T(HUGE_VAL)) const;
+
+	// Finds the point on the triangles closest to point, only searching within maxDistance
+	bool closestPoint(const vec3 &point, size_t &triangle, vec3 &closest, const T maxDistance = T(HUGE_VAL)) const;
+
+	// Appends the primitives whose bounds overlap box, and returns the amount appended
+	size_t overlaps(const aabb &box, std::vector<unsigned int> &primitives) const;
+
+
+	// Reference: Ericson, "Real-Time Collision Detection" (2004), section 5.1.5
+	static vec3 closestPointOnTriangle(const vec3 &p, const vec3 &a, const vec3 &b, const vec3 &c);
+
+
+	inline void getTriangle(const size_t triangle, vec3 &v0, vec3 &v1, vec3 &v2) const
+	{
+		if (this->indices)
+		{
+			v0 = this->vertices[this->indices[triangle * 3 + 0]];
+			v1 = this->vertices[this->indices[triangle * 3 + 1]];
+			v2 = this->vertices[this->indices[triangle * 3 + 2]];
+		}
+		else
+		{
+			v0 = this->vertices[triangle * 3 + 0];
+			v1 = this->vertices[triangle * 3 + 1];
+			v2 = this->vertices[triangle * 3 + 2];
+		}
+	}
+
+	inline aabb getPrimitiveBounds(const size_t primitive) const
+	{
+		if (this->primitiveBounds)
+			return this->primitiveBounds[primitive];
+
+		vec3 v0, v1, v2;
+		getTriangle(primitive, v0, v1, v2);
+
+		return aabb(v0.min(v1).min(v2), v0.max(v1).max(v2));
+	}
+
+
+private:
+
+	// The primitives are partitioned along with their bounds, such that
+	// building reads them sequentially instead of through their indices.
+	struct BuildPrimitive
+	{
+		aabb bounds;
+		vec3 centroid;
+		unsigned int index;
+	};
+
+	void buildNodes(unsigned int threadCount);
+
+	void buildNode(
+		BuildPrimitive *primitives,
+		const size_t begin, const size_t end, const int depth, const int parallelDepth,
+		std::vector<Node> &result);
+
+	// The entry distance of the ray into the box, or a negative value if it misses or is further than maxDistance
+	static inline T intersectNode(const aabb &box, const vec3 &origin, const vec3 &invDirection, const T maxDistance)
+	{
+		T tNear = T(0), tFar = maxDistance;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const T t1 = (box.min[i] - origin[i]) * invDirection[i];
+			const T t2 = (box.max[i] - origin[i]) * invDirection[i];
+
+			tNear = std::max(tNear, std::min(t1, t2));
+			tFar = std::min(tFar, std::max(t1, t2));
+		}
+
+		return (tNear <= tFar) ? tNear : T(-1);
+	}
+
+	static inline T distanceSquared(const aabb &box, const vec3 &point)
+	{
+		return (point.clamp(box.min, box.max) - point).lengthSquared();
+	}
+};
+
+
+template<typename T>
+void BoundingVolumeHierarchyT<T>::buildNodes(unsigned int threadCount)
+{
+	this->nodes.clear();
+	this->primitiveIndices.resize(this->primitiveCount);
+
+	if (this->primitiveCount == 0)
+		return;
+
+	std::vector<BuildPrimitive> primitives(this->primitiveCount);
+
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+
+	_linalg_parallel_for(this->primitiveCount, minPrimitivesPerThread, threadCount, [&](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			primitives[i].bounds = getPrimitiveBounds(i);
+			primitives[i].centroid = primitives[i].bounds.center();
+			primitives[i].index = static_cast<unsigned int>(i);
+		}
+	});
+
+	// Each level of the hierarchy doubles the amount of subtrees being built in parallel
+	int parallelDepth = 0;
+
+	while ((1u << parallelDepth) < threadCount)
+		parallelDepth++;
+
+	this->nodes.reserve(this->primitiveCount * 2 / maxLeafSize);
+
+	buildNode(primitives.data(), 0, this->primitiveCount, 0, parallelDepth, this->nodes);
+
+	for (size_t i = 0; i < this->primitiveCount; i++)
+		this->primitiveIndices[i] = primitives[i].index;
+}
+
+template<typename T>
+void BoundingVolumeHierarchyT<T>::buildNode(
+	BuildPrimitive *primitives,
+	const size_t begin, const size_t end, const int depth, const int parallelDepth,
+	std::vector<Node> &result)
+{
+	const size_t nodeIndex = result.size();
+	result.push_back(Node());
+
+	aabb nodeBounds = aabb::empty;
+	aabb centroidBounds = aabb::empty;
+
+	for (size_t i = begin; i < end; i++)
+	{
+		nodeBounds.merge(primitives[i].bounds);
+		centroidBounds.merge(primitives[i].centroid);
+	}
+
+	const size_t count = end - begin;
+
+	result[nodeIndex].bounds = nodeBounds;
+	result[nodeIndex].offset = static_cast<unsigned int>(begin);
+	result[nodeIndex].count = static_cast<unsigned int>(count);
+
+	if ((count <= maxLeafSize) || (depth >= maxDepth))
+		return;
+
+	// Bin the primitives along all 3 axes in a single pass
+	aabb binBounds[3][binCount];
+	size_t binCounts[3][binCount] = {};
+
+	for (int axis = 0; axis < 3; axis++)
+		for (int b = 0; b < binCount; b++)
+			binBounds[axis][b] = aabb::empty;
+
+	const vec3 centroidExtent = centroidBounds.size();
+
+	vec3 scale;
+
+	for (int axis = 0; axis < 3; axis++)
+		scale[axis] = (centroidExtent[axis] > T(0)) ? (T(binCount) / centroidExtent[axis]) : T(0);
+
+	for (size_t i = begin; i < end; i++)
+	{
+		const BuildPrimitive &primitive = primitives[i];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const int b = std::min(static_cast<int>((primitive.centroid[axis] - centroidBounds.min[axis]) * scale[axis]), binCount - 1);
+
+			binBounds[axis][b].merge(primitive.bounds);
+			binCounts[axis][b]++;
+		}
+	}
+
+	// Find the cheapest split among the bin boundaries of all 3 axes
+	int bestAxis = -1, bestSplit = 0;
+	T bestCost = T(HUGE_VAL);
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (centroidExtent[axis] <= T(0))
+			continue;
+
+		// Sweep from the right to get the area and count of everything right of each boundary
+		T rightAreas[binCount];
+		size_t rightCounts[binCount];
+
+		aabb right = aabb::empty;
+		size_t rightCount = 0;
+
+		for (int b = binCount - 1; b > 0; b--)
+		{
+			right.merge(binBounds[axis][b]);
+			rightCount += binCounts[axis][b];
+
+			rightAreas[b] = right.surfaceArea();
+			rightCounts[b] = rightCount;
+		}
+
+		aabb left = aabb::empty;
+		size_t leftCount = 0;
+
+		for (int b = 1; b < binCount; b++)
+		{
+			left.merge(binBounds[axis][b - 1]);
+			leftCount += binCounts[axis][b - 1];
+
+			if ((leftCount == 0) || (rightCounts[b] == 0))
+				continue;
+
+			const T cost = left.surfaceArea() * T(leftCount) + rightAreas[b] * T(rightCounts[b]);
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = b;
+			}
+		}
+	}
+
+	size_t middle;
+
+	if (bestAxis >= 0)
+	{
+		// Traversing a node is about as expensive as intersecting a primitive, so compare
+		// against the cost of a leaf, both relative to the area of this node
+		const T leafCost = nodeBounds.surfaceArea() * T(count);
+		const T splitCost = nodeBounds.surfaceArea() + bestCost;
+
+		if ((splitCost >= leafCost) && (count <= (maxLeafSize * 4)))
+			return;
+
+		const T min = centroidBounds.min[bestAxis];
+		const T axisScale = scale[bestAxis];
+
+		middle = static_cast<size_t>(std::partition(primitives + begin, primitives + end, [&](const BuildPrimitive &primitive)
+		{
+			return (std::min(static_cast<int>((primitive.centroid[bestAxis] - min) * axisScale), binCount - 1) < bestSplit);
+		}) - primitives);
+	}
+	else
+	{
+		// All centroids coincide, so split arbitrarily in the middle
+		middle = begin + count / 2;
+	}
+
+	result[nodeIndex].count = 0;
+
+	if ((parallelDepth > 0) && (count >= minPrimitivesPerThread))
+	{
+		// The subtrees are built into separate arrays, as their sizes aren't known up front
+		std::vector<Node> leftNodes, rightNodes;
+
+		std::thread leftThread([&]()
+		{
+			buildNode(primitives, begin, middle, depth + 1, parallelDepth - 1, leftNodes);
+		});
+
+		buildNode(primitives, middle, end, depth + 1, parallelDepth - 1, rightNodes);
+
+		leftThread.join();
+
+		const unsigned int leftBase = static_cast<unsigned int>(nodeIndex + 1);
+		const unsigned int rightBase = static_cast<unsigned int>(leftBase + leftNodes.size());
+
+		for (size_t i = 0; i < leftNodes.size(); i++)
+		{
+			if (!leftNodes[i].isLeaf())
+				leftNodes[i].offset += leftBase;
+
+			result.push_back(leftNodes[i]);
+		}
+
+		for (size_t i = 0; i < rightNodes.size(); i++)
+		{
+			if (!rightNodes[i].isLeaf())
+				rightNodes[i].offset += rightBase;
+
+			result.push_back(rightNodes[i]);
+		}
+
+		result[nodeIndex].offset = rightBase;
+	}
+	else
+	{
+		// Child offsets are relative to the start of result, which is the
+		// start of the subtree when it is being built on another thread
+		buildNode(primitives, begin, middle, depth + 1, 0, result);
+
+		result[nodeIndex].offset = static_cast<unsigned int>(result.size());
+
+		buildNode(primitives, middle, end, depth + 1, 0, result);
+	}
+}
+
+template<typename T>
+bool BoundingVolumeHierarchyT<T>::intersect(const ray &r, size_t &triangle, T &distance, T &u, T &v, const T maxDistance) const
+{
+	if (this->nodes.empty() || !hasTriangles())
+		return false;
+
+	const vec3 invDirection(T(1) / r.direction.x, T(1) / r.direction.y, T(1) / r.direction.z);
+
+	T nearest = maxDistance;
+	bool hit = false;
+
+	if (intersectNode(this->nodes[0].bounds, r.origin, invDirection, nearest) < T(0))
+		return false;
+
+	unsigned int stack[maxDepth + 1];
+	int stackSize = 0;
+
+	unsigned int nodeIndex = 0;
+
+	for (;;)
+	{
+		const Node &node = this->nodes[nodeIndex];
+
+		if (node.isLeaf())
+		{
+			for (unsigned int i = 0; i < node.count; i++)
+			{
+				const unsigned int primitive = this->primitiveIndices[node.offset + i];
+
+				vec3 v0, v1, v2;
+				getTriangle(primitive, v0, v1, v2);
+
+				T d, hitU, hitV;
+
+				if (r.intersects(v0, v1, v2, d, hitU, hitV) && (d < nearest))
+				{
+					nearest = d;
+					triangle = primitive;
+					u = hitU;
+					v = hitV;
+					hit = true;
+				}
+			}
+		}
+		else
+		{
+			unsigned int first = nodeIndex + 1;
+			unsigned int second = node.offset;
+
+			T firstDistance = intersectNode(this->nodes[first].bounds, r.origin, invDirection, nearest);
+			T secondDistance = intersectNode(this->nodes[second].bounds, r.origin, invDirection, nearest);
+
+			// Visit the nearest child first, so that the other is more likely to be culled
+			if ((secondDistance >= T(0)) && ((firstDistance < T(0)) || (secondDistance < firstDistance)))
+			{
+				std::swap(first, second);
+				std::swap(firstDistance, secondDistance);
+			}
+
+			if (firstDistance >= T(0))
+			{
+				if (secondDistance >= T(0))
+					stack[stackSize++] = second;
+
+				nodeIndex = first;
+				continue;
+			}
+		}
+
+		// Nodes further away than the nearest hit found since they were pushed are skipped
+		bool popped = false;
+
+		while ((stackSize > 0) && !popped)
+		{
+			nodeIndex = stack[--stackSize];
+			popped = (intersectNode(this->nodes[nodeIndex].bounds, r.origin, invDirection, nearest) >= T(0));
+		}
+
+		if (!popped)
+			break;
+	}
+
+	if (hit)
+		distance = nearest;
+
+	return hit;
+}
+
+template<typename T>
+bool BoundingVolumeHierarchyT<T>::closestPoint(const vec3 &point, size_t &triangle, vec3 &closest, const T maxDistance) const
+{
+	if (this->nodes.empty() || !hasTriangles())
+		return false;
+
+	T nearestSquared = (maxDistance < T(HUGE_VAL)) ? (maxDistance * maxDistance) : maxDistance;
+	bool found = false;
+
+	unsigned int stack[maxDepth + 1];
+	int stackSize = 0;
+
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node &node = this->nodes[stack[--stackSize]];
+
+		if (distanceSquared(node.bounds, point) > nearestSquared)
+			continue;
+
+		if (node.isLeaf())
+		{
+			for (unsigned int i = 0; i < node.count; i++)
+			{
+				const unsigned int primitive = this->primitiveIndices[node.offset + i];
+
+				vec3 v0, v1, v2;
+				getTriangle(primitive, v0, v1, v2);
+
+				const vec3 p = closestPointOnTriangle(point, v0, v1, v2);
+				const T d = (p - point).lengthSquared();
+
+				if (d <= nearestSquared)
+				{
+					nearestSquared = d;
+					triangle = primitive;
+					closest = p;
+					found = true;
+				}
+			}
+		}
+		else
+		{
+			const unsigned int left = static_cast<unsigned int>(&node - this->nodes.data()) + 1;
+			const unsigned int right = node.offset;
+
+			// Push the nearest child last, such that it is visited first
+			if (distanceSquared(this->nodes[left].bounds, point) < distanceSquared(this->nodes[right].bounds, point))
+			{
+				stack[stackSize++] = right;
+				stack[stackSize++] = left;
+			}
+			else
+			{
+				stack[stackSize++] = left;
+				stack[stackSize++] = right;
+			}
+		}
+	}
+
+	return found;
+}
+
+template<typename T>
+size_t BoundingVolumeHierarchyT<T>::overlaps(const aabb &box, std::vector<unsigned int> &primitives) const
+{
+	const size_t previousSize = primitives.size();
+
+	if (this->nodes.empty())
+		return 0;
+
+	unsigned int stack[maxDepth + 1];
+	int stackSize = 0;
+
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const unsigned int nodeIndex = stack[--stackSize];
+		const Node &node = this->nodes[nodeIndex];
+
+		if (!node.bounds.intersects(box))
+			continue;
+
+		if (node.isLeaf())
+		{
+			for (unsigned int i = 0; i < node.count; i++)
+			{
+				const unsigned int primitive = this->primitiveIndices[node.offset + i];
+
+				if (getPrimitiveBounds(primitive).intersects(box))
+					primitives.push_back(primitive);
+			}
+		}
+		else
+		{
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+
+	return (primitives.size() - previousSize);
+}
+
+template<typename T>
+vec3_t<T> BoundingVolumeHierarchyT<T>::closestPointOnTriangle(const vec3 &p, const vec3 &a, const vec3 &b, const vec3 &c)
+{
+	const vec3 ab = b - a;
+	const vec3 ac = c - a;
+	const vec3 ap = p - a;
+
+	const T d1 = ab.dot(ap);
+	const T d2 = ac.dot(ap);
+
+	if ((d1 <= T(0)) && (d2 <= T(0)))
+		return a;
+
+	const vec3 bp = p - b;
+
+	const T d3 = ab.dot(bp);
+	const T d4 = ac.dot(bp);
+
+	if ((d3 >= T(0)) && (d4 <= d3))
+		return b;
+
+	const T vc = d1 * d4 - d3 * d2;
+
+	if ((vc <= T(0)) && (d1 >= T(0)) && (d3 <= T(0)))
+		return a + ab * (d1 / (d1 - d3));
+
+	const vec3 cp = p - c;
+
+	const T d5 = ab.dot(cp);
+	const T d6 = ac.dot(cp);
+
+	if ((d6 >= T(0)) && (d5 <= d6))
+		return c;
+
+	const T vb = d5 * d2 - d1 * d6;
+
+	if ((vb <= T(0)) && (d2 >= T(0)) && (d6 <= T(0)))
+		return a + ac * (d2 / (d2 - d6));
+
+	const T va = d3 * d6 - d5 * d4;
+
+	if ((va <= T(0)) && ((d4 - d3) >= T(0)) && ((d5 - d6) >= T(0)))
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	const T denominator = T(1) / (va + vb + vc);
+
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+
+
+// 3D Morton codes (Z-order curve), interleaving the bits of the 3 coordinates such that
+// points close in space tend to be close in code. The 30 bit codes take 10 bits per axis,
+// the 63 bit codes 21 bits per axis. The x bits are the most significant of each triplet.
+class Morton
+{
+public:
+
+	static const unsigned int maxValue30 = (1u << 10) - 1;
+	static const unsigned int maxValue63 = (1u << 21) - 1;
+
+
+	static inline unsigned int encode30(const uvec3 &v)
+	{
+#ifdef LINALG_BMI2
+		return (_pdep_u32(v.x, 0x24924924u) | _pdep_u32(v.y, 0x12492492u) | _pdep_u32(v.z, 0x09249249u));
+#else
+		return ((expand10(v.x) << 2) | (expand10(v.y) << 1) | expand10(v.z));
+#endif
+	}
+
+	static inline uvec3 decode30(const unsigned int code)
+	{
+#ifdef LINALG_BMI2
+		return uvec3(_pext_u32(code, 0x24924924u), _pext_u32(code, 0x12492492u), _pext_u32(code, 0x09249249u));
+#else
+		return uvec3(compact10(code >> 2), compact10(code >> 1), compact10(code));
+#endif
+	}
+
+	static inline unsigned long long encode63(const uvec3 &v)
+	{
+#if defined(LINALG_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+		return (_pdep_u64(v.x, 0x4924924924924924ull) | _pdep_u64(v.y, 0x2492492492492492ull) | _pdep_u64(v.z, 0x1249249249249249ull));
+#else
+		return ((expand21(v.x) << 2) | (expand21(v.y) << 1) | expand21(v.z));
+#endif
+	}
+
+	static inline uvec3 decode63(const unsigned long long code)
+	{
+#if defined(LINALG_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+		return uvec3(
+			static_cast<unsigned int>(_pext_u64(code, 0x4924924924924924ull)),
+			static_cast<unsigned int>(_pext_u64(code, 0x2492492492492492ull)),
+			static_cast<unsigned int>(_pext_u64(code, 0x1249249249249249ull)));
+#else
+		return uvec3(compact21(code >> 2), compact21(code >> 1), compact21(code));
+#endif
+	}
+
+
+	// Points are quantized relative to bounds, and clamped to it
+
+	template<typename T>
+	static inline unsigned int encode30(const vec3_t<T> &point, const aabb_t<T> &bounds)
+	{
+		return encode30(quantize(point, bounds, maxValue30));
+	}
+
+	template<typename T>
+	static inline unsigned long long encode63(const vec3_t<T> &point, const aabb_t<T> &bounds)
+	{
+		return encode63(quantize(point, bounds, maxValue63));
+	}
+
+	// The center of the quantization cell the code refers to
+	template<typename T>
+	static inline vec3_t<T> decode30(const unsigned int code, const aabb_t<T> &bounds)
+	{
+		return dequantize(decode30(code), bounds, maxValue30);
+	}
+
+	template<typename T>
+	static inline vec3_t<T> decode63(const unsigned long long code, const aabb_t<T> &bounds)
+	{
+		return dequantize(decode63(code), bounds, maxValue63);
+	}
+
+
+	// A threadCount of 0 uses one thread per hardware thread
+
+	template<typename T>
+	static void encode30(const vec3_t<T> *points, const size_t count, const aabb_t<T> &bounds, unsigned int *codes, const unsigned int threadCount = 0)
+	{
+		_linalg_parallel_for(count, minElementsPerThread, threadCount, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				codes[i] = encode30(points[i], bounds);
+		});
+	}
+
+	template<typename T>
+	static void encode63(const vec3_t<T> *points, const size_t count, const aabb_t<T> &bounds, unsigned long long *codes, const unsigned int threadCount = 0)
+	{
+		_linalg_parallel_for(count, minElementsPerThread, threadCount, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				codes[i] = encode63(points[i], bounds);
+		});
+	}
+
+
+	// Sorts the codes in ascending order along with the values (e.g. point indices), using
+	// a least significant digit radix sort. Each pass builds per thread histograms of
+	// its chunk, which are then merged into per thread scatter offsets. Passes where all
+	// codes share the same digit are skipped, so unused high bits cost nothing. Equal
+	// codes keep their relative order.
+
+	static void sort(unsigned int *codes, unsigned int *values, const size_t count, const unsigned int threadCount = 0)
+	{
+		radixSort(codes, values, count, 30, threadCount);
+	}
+
+	static void sort(unsigned long long *codes, unsigned int *values, const size_t count, const unsigned int threadCount = 0)
+	{
+		radixSort(codes, values, count, 63, threadCount);
+	}
+
+
+private:
+
+	static const size_t minElementsPerThread = 65536;
+
+	static const int radixBits = 11;
+	static const unsigned int radixSize = 1u << radixBits;
+
+
+	static inline unsigned int expand10(unsigned int x)
+	{
+		x &= 0x000003FFu;
+		x = (x | (x << 16)) & 0x030000FFu;
+		x = (x | (x << 8)) & 0x0300F00Fu;
+		x = (x | (x << 4)) & 0x030C30C3u;
+		x = (x | (x << 2)) & 0x09249249u;
+
+		return x;
+	}
+
+	static inline unsigned int compact10(unsigned int x)
+	{
+		x &= 0x09249249u;
+		x = (x ^ (x >> 2)) & 0x030C30C3u;
+		x = (x ^ (x >> 4)) & 0x0300F00Fu;
+		x = (x ^ (x >> 8)) & 0x030000FFu;
+		x = (x ^ (x >> 16)) & 0x000003FFu;
+
+		return x;
+	}
+
+	static inline unsigned long long expand21(const unsigned int value)
+	{
+		unsigned long long x = value & 0x1FFFFFull;
+
+		x = (x | (x << 32)) & 0x001F00000000FFFFull;
+		x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+		x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+		x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+		x = (x | (x << 2)) & 0x1249249249249249ull;
+
+		return x;
+	}
+
+	static inline unsigned int compact21(unsigned long long x)
+	{
+		x &= 0x1249249249249249ull;
+		x = (x ^ (x >> 2)) & 0x10C30C30C30C30C3ull;
+		x = (x ^ (x >> 4)) & 0x100F00F00F00F00Full;
+		x = (x ^ (x >> 8)) & 0x001F0000FF0000FFull;
+		x = (x ^ (x >> 16)) & 0x001F00000000FFFFull;
+		x = (x ^ (x >> 32)) & 0x1FFFFFull;
+
+		return static_cast<unsigned int>(x);
+	}
+
+
+	template<typename T>
+	static inline uvec3 quantize(const vec3_t<T> &point, const aabb_t<T> &bounds, const unsigned int maxValue)
+	{
+		const vec3_t<T> size = bounds.size();
+
+		uvec3 v;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const T t = (size[i] > T(0)) ? ((point[i] - bounds.min[i]) / size[i]) : T(0);
+			const T q = t * T(maxValue) + T(0.5);
+
+			v[i] = (q <= T(0)) ? 0u : ((q >= T(maxValue)) ? maxValue : static_cast<unsigned int>(q));
+		}
+
+		return v;
+	}
+
+	template<typename T>
+	static inline vec3_t<T> dequantize(const uvec3 &v, const aabb_t<T> &bounds, const unsigned int maxValue)
+	{
+		const vec3_t<T> size = bounds.size();
+
+		return vec3_t<T>(
+			bounds.min.x + size.x * (T(v.x) / T(maxValue)),
+			bounds.min.y + size.y * (T(v.y) / T(maxValue)),
+			bounds.min.z + size.z * (T(v.z) / T(maxValue)));
+	}
+
+
+	template<typename Code>
+	static void radixSort(Code *codes, unsigned int *values, const size_t count, const int codeBits, const unsigned int threadCount)
+	{
+		if (count <= 1)
+			return;
+
+		const size_t chunkCount = _linalg_chunk_count(count, minElementsPerThread, threadCount);
+
+		std::vector<Code> tempCodes(count);
+		std::vector<unsigned int> tempValues(count);
+
+		Code *sourceCodes = codes, *targetCodes = tempCodes.data();
+		unsigned int *sourceValues = values, *targetValues = tempValues.data();
+
+		// histograms[chunk * radixSize + digit]
+		std::vector<size_t> histograms(chunkCount * radixSize);
+
+		for (int shift = 0; shift < codeBits; shift += radixBits)
+		{
+			_linalg_parallel_chunks(count, chunkCount, [&](const size_t chunk, const size_t begin, const size_t end)
+			{
+				size_t *histogram = histograms.data() + chunk * radixSize;
+				std::fill(histogram, histogram + radixSize, size_t(0));
+
+				for (size_t i = begin; i < end; i++)
+					histogram[(sourceCodes[i] >> shift) & (radixSize - 1)]++;
+			});
+
+			// Turn the histograms into the offset each chunk starts writing each digit at,
+			// where all chunks' elements of a digit come before those of the next digit.
+			size_t offset = 0;
+			bool skip = false;
+
+			for (unsigned int digit = 0; (digit < radixSize) && !skip; digit++)
+			{
+				size_t digitCount = 0;
+
+				for (size_t chunk = 0; chunk < chunkCount; chunk++)
+				{
+					size_t &n = histograms[chunk * radixSize + digit];
+					const size_t chunkDigitCount = n;
+
+					n = offset + digitCount;
+					digitCount += chunkDigitCount;
+				}
+
+				skip = (digitCount == count);
+				offset += digitCount;
+			}
+
+			if (skip)
+				continue;
+
+			_linalg_parallel_chunks(count, chunkCount, [&](const size_t chunk, const size_t begin, const size_t end)
+			{
+				size_t *offsets = histograms.data() + chunk * radixSize;
+
+				for (size_t i = begin; i < end; i++)
+				{
+					const size_t j = offsets[(sourceCodes[i] >> shift) & (radixSize - 1)]++;
+
+					targetCodes[j] = sourceCodes[i];
+					targetValues[j] = sourceValues[i];
+				}
+			});
+
+			std::swap(sourceCodes, targetCodes);
+			std::swap(sourceValues, targetValues);
+		}
+
+		if (sourceCodes != codes)
+		{
+			std::copy(sourceCodes, sourceCodes + count, codes);
+			std::copy(sourceValues, sourceValues + count, values);
+		}
+	}
+};
+
+
+// A linear bounding volume hierarchy over a point set. The points are sorted by their
+// 30 bit Morton codes, after which every internal node can be built independently of
+// the others, by finding the range of codes it covers and where the highest differing
+// bit splits that range. Duplicate codes are disambiguated by their index. The bounds
+// are then computed bottom-up, where the second thread to reach a node merges its
+// children's bounds and carries on to the parent.
+//
+// Reference: Karras, "Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d Trees" (2012)
+template<typename T>
+class LinearBoundingVolumeHierarchyT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+
+	typedef aabb_t<T> aabb;
+
+
+public:
+
+	// Children with this bit set are leaves, indexing sortedIndices
+	static const unsigned int leafFlag = 0x80000000u;
+
+	// With n points there are n - 1 internal nodes, where the root is the first
+	struct Node
+	{
+		aabb bounds;
+		unsigned int children[2];
+	};
+
+
+	std::vector<Node> nodes;
+
+	// The Morton codes in ascending order, and the index of the point each belongs to
+	std::vector<unsigned int> sortedCodes;
+	std::vector<unsigned int> sortedIndices;
+
+	aabb bounds;
+
+
+private:
+
+	const vec3 *points;
+
+	// The bottom-up pass climbs from the leaves, so parents are needed for internal nodes and leaves
+	std::vector<unsigned int> parents;
+
+
+public:
+
+	LinearBoundingVolumeHierarchyT() : bounds(aabb::empty), points(nullptr) {}
+
+	~LinearBoundingVolumeHierarchyT() {}
+
+
+	// The points aren't copied, so they must outlive the hierarchy. A threadCount
+	// of 0 uses one thread per hardware thread.
+	void build(const vec3 *points, const size_t count, const unsigned int threadCount = 0);
+
+	// Appends the indices of the points within box, and returns the amount appended
+	size_t overlaps(const aabb &box, std::vector<unsigned int> &result) const;
+
+
+private:
+
+	static const size_t minPointsPerThread = 16384;
+
+
+	// The length of the common prefix of the codes at i and j, or -1 if j is out of range
+	inline int commonPrefix(const int i, const int j) const
+	{
+		if ((j < 0) || (j >= static_cast<int>(this->sortedCodes.size())))
+			return -1;
+
+		const unsigned int a = this->sortedCodes[i];
+		const unsigned int b = this->sortedCodes[j];
+
+		if (a == b)
+			return 32 + _linalg_clz32(static_cast<unsigned int>(i ^ j));
+
+		return _linalg_clz32(a ^ b);
+	}
+
+	void buildInternalNode(const int i);
+};
+
+
+template<typename T>
+void LinearBoundingVolumeHierarchyT<T>::build(const vec3 *points, const size_t count, const unsigned int threadCount)
+{
+	this->points = points;
+
+	this->nodes.clear();
+	this->sortedCodes.resize(count);
+	this->sortedIndices.resize(count);
+
+	this->bounds = aabb::empty;
+
+	if (count == 0)
+		return;
+
+	const size_t chunkCount = _linalg_chunk_count(count, minPointsPerThread, threadCount);
+
+	std::vector<aabb> chunkBounds(chunkCount, aabb::empty);
+
+	_linalg_parallel_chunks(count, chunkCount, [&](const size_t chunk, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			chunkBounds[chunk].merge(points[i]);
+	});
+
+	for (size_t i = 0; i < chunkCount; i++)
+		this->bounds.merge(chunkBounds[i]);
+
+	_linalg_parallel_chunks(count, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			this->sortedCodes[i] = Morton::encode30(points[i], this->bounds);
+			this->sortedIndices[i] = static_cast<unsigned int>(i);
+		}
+	});
+
+	Morton::sort(this->sortedCodes.data(), this->sortedIndices.data(), count, static_cast<unsigned int>(chunkCount));
+
+	if (count == 1)
+		return;
+
+	const size_t internalCount = count - 1;
+
+	this->nodes.resize(internalCount);
+
+	// parents[i] is the parent of internal node i, and parents[internalCount + i] that of leaf i
+	this->parents.resize(internalCount + count);
+	this->parents[0] = 0;
+
+	_linalg_parallel_chunks(internalCount, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			buildInternalNode(static_cast<int>(i));
+	});
+
+	// Climb from each leaf, where the first thread to arrive at a node stops and
+	// the second (which then knows both children are done) computes its bounds.
+	std::vector<std::atomic<unsigned int>> visits(internalCount);
+
+	for (size_t i = 0; i < internalCount; i++)
+		visits[i].store(0, std::memory_order_relaxed);
+
+	_linalg_parallel_chunks(count, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t leaf = begin; leaf < end; leaf++)
+		{
+			unsigned int node = this->parents[internalCount + leaf];
+
+			while (visits[node].fetch_add(1, std::memory_order_acq_rel) == 1)
+			{
+				Node &n = this->nodes[node];
+
+				for (int c = 0; c < 2; c++)
+				{
+					const unsigned int child = n.children[c];
+
+					const aabb childBounds = (child & leafFlag)
+						? aabb(points[this->sortedIndices[child & ~leafFlag]], points[this->sortedIndices[child & ~leafFlag]])
+						: this->nodes[child].bounds;
+
+					if (c == 0)
+						n.bounds = childBounds;
+					else
+						n.bounds.merge(childBounds);
+				}
+
+				if (node == 0)
+					break;
+
+				node = this->parents[node];
+			}
+		}
+	});
+}
+
+template<typename T>
+void LinearBoundingVolumeHierarchyT<T>::buildInternalNode(const int i)
+{
+	// The direction of the range covered by the node
+	const int d = ((commonPrefix(i, i + 1) - commonPrefix(i, i - 1)) >= 0) ? 1 : -1;
+
+	// Find the other end of the range, first by an upper bound then by binary search
+	const int minPrefix = commonPrefix(i, i - d);
+
+	int maxLength = 2;
+
+	while (commonPrefix(i, i + maxLength * d) > minPrefix)
+		maxLength *= 2;
+
+	int length = 0;
+
+	for (int t = maxLength / 2; t >= 1; t /= 2)
+		if (commonPrefix(i, i + (length + t) * d) > minPrefix)
+			length += t;
+
+	const int j = i + length * d;
+
+	// Find where the highest differing bit splits the range
+	const int nodePrefix = commonPrefix(i, j);
+
+	int split = 0;
+
+	for (int t = length; t > 1;)
+	{
+		t = (t + 1) / 2;
+
+		if (commonPrefix(i, i + (split + t) * d) > nodePrefix)
+			split += t;
+	}
+
+	const int gamma = i + split * d + std::min(d, 0);
+
+	const unsigned int internalCount = static_cast<unsigned int>(this->nodes.size());
+
+	Node &node = this->nodes[i];
+
+	if (std::min(i, j) == gamma)
+	{
+		node.children[0] = static_cast<unsigned int>(gamma) | leafFlag;
+		this->parents[internalCount + gamma] = static_cast<unsigned int>(i);
+	}
+	else
+	{
+		node.children[0] = static_cast<unsigned int>(gamma);
+		this->parents[gamma] = static_cast<unsigned int>(i);
+	}
+
+	if (std::max(i, j) == (gamma + 1))
+	{
+		node.children[1] = static_cast<unsigned int>(gamma + 1) | leafFlag;
+		this->parents[internalCount + gamma + 1] = static_cast<unsigned int>(i);
+	}
+	else
+	{
+		node.children[1] = static_cast<unsigned int>(gamma + 1);
+		this->parents[gamma + 1] = static_cast<unsigned int>(i);
+	}
+}
+
+template<typename T>
+size_t LinearBoundingVolumeHierarchyT<T>::overlaps(const aabb &box, std::vector<unsigned int> &result) const
+{
+	const size_t previousSize = result.size();
+
+	if (this->sortedIndices.empty())
+		return 0;
+
+	if (this->nodes.empty())
+	{
+		if (box.contains(this->points[this->sortedIndices[0]]))
+			result.push_back(this->sortedIndices[0]);
+
+		return (result.size() - previousSize);
+	}
+
+	// The depth is bounded by the 30 code bits plus the 32 index bits used for duplicates
+	unsigned int stack[64];
+	int stackSize = 0;
+
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node &node = this->nodes[stack[--stackSize]];
+
+		if (!node.bounds.intersects(box))
+			continue;
+
+		for (int c = 0; c < 2; c++)
+		{
+			const unsigned int child = node.children[c];
+
+			if (child & leafFlag)
+			{
+				const unsigned int index = this->sortedIndices[child & ~leafFlag];
+
+				if (box.contains(this->points[index]))
+					result.push_back(index);
+			}
+			else
+				stack[stackSize++] = child;
+		}
+	}
+
+	return (result.size() - previousSize);
+}
+
+
+
+// A uniform grid of cubic cells over points, where the cells are hashed into a table
+// such that the grid is unbounded and only occupied cells take up memory. The points
+// are counting sorted by the hash of their cell, so each table entry refers to a
+// contiguous range of points, which are copied in that order for cache coherent
+// queries. Different cells can hash to the same entry, so queries check the cell
+// of each point they visit.
+//
+// Only y and z are hashed, while x is added on top. Consecutive cells along x then
+// map to consecutive entries, so queries visit whole rows of cells as a single range.
+//
+// Reference: Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects" (2003)
+template<typename T>
+class SpatialHashGridT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec3_t<signed int> ivec3;
+
+	typedef aabb_t<T> aabb;
+
+
+public:
+
+	// The points in the order of their cell hash, and the index of each in the input
+	std::vector<vec3> sortedPoints;
+	std::vector<unsigned int> sortedIndices;
+
+	// The points of table entry h are sortedPoints[cellStarts[h]] to sortedPoints[cellStarts[h + 1]]
+	std::vector<unsigned int> cellStarts;
+
+	aabb bounds;
+
+
+private:
+
+	T cellSize, invCellSize;
+
+	unsigned int tableMask;
+
+	std::vector<unsigned int> hashes;
+
+
+public:
+
+	SpatialHashGridT(const T cellSize = T(1)) : bounds(aabb::empty), tableMask(0)
+	{
+		setCellSize(cellSize);
+	}
+
+	~SpatialHashGridT() {}
+
+
+	// Takes effect at the next build
+	inline void setCellSize(const T cellSize)
+	{
+		this->cellSize = cellSize;
+		this->invCellSize = T(1) / cellSize;
+	}
+
+	inline T getCellSize() const { return this->cellSize; }
+
+
+	inline ivec3 cellOf(const vec3 &point) const
+	{
+		return ivec3(
+			floorToInt(point.x * this->invCellSize),
+			floorToInt(point.y * this->invCellSize),
+			floorToInt(point.z * this->invCellSize));
+	}
+
+	inline unsigned int hash(const ivec3 &cell) const
+	{
+		return ((hashRow(cell.y, cell.z) + static_cast<unsigned int>(cell.x)) & this->tableMask);
+	}
+
+
+	// (Re)builds the grid, reusing the memory of the previous build. The table holds
+	// twice as many entries as points, rounded up to a power of 2. A threadCount of
+	// 0 uses one thread per hardware thread.
+	void build(const vec3 *points, const size_t count, const unsigned int threadCount = 0);
+
+
+	// Calls function(index, distanceSquared) for each point within radius of center,
+	// where index is the index of the point as given to build()
+	template<typename Function>
+	void forEachInRadius(const vec3 &center, const T radius, Function function) const
+	{
+		if (this->sortedPoints.empty())
+			return;
+
+		const T radiusSquared = radius * radius;
+
+		const ivec3 minCell = cellOf(center - radius);
+		const ivec3 maxCell = cellOf(center + radius);
+
+		for (int z = minCell.z; z <= maxCell.z; z++)
+			for (int y = minCell.y; y <= maxCell.y; y++)
+				forEachInRow(y, z, minCell.x, maxCell.x, center, [&](const unsigned int i, const T distanceSquared)
+				{
+					if (distanceSquared <= radiusSquared)
+						function(this->sortedIndices[i], distanceSquared);
+				});
+	}
+
+	// Appends the indices of the points within radius of center, and returns the amount appended
+	size_t queryRadius(const vec3 &center, const T radius, std::vector<unsigned int> &result) const
+	{
+		const size_t previousSize = result.size();
+
+		forEachInRadius(center, radius, [&](const unsigned int index, const T)
+		{
+			result.push_back(index);
+		});
+
+		return (result.size() - previousSize);
+	}
+
+	// Finds the k nearest points within maxDistance of point, writing their indices and squared
+	// distances ordered nearest first. Returns the amount found, which is less than k if there
+	// aren't enough points. The search visits growing cubes of cells around the point, until
+	// the k-th nearest point found so far is closer than the faces of the cube.
+	size_t queryNearest(
+		const vec3 &point, const size_t k,
+		unsigned int *indices, T *distancesSquared,
+		const T maxDistance = T(HUGE_VAL)) const;
+
+
+private:
+
+	static const size_t minPointsPerThread = 65536;
+
+
+	// Cells are clamped to +-2^29, such that queries can add and subtract rings of cells without
+	// overflowing, and points far beyond share the outermost cells
+	static const int cellLimit = 1 << 29;
+
+	// Queries compute the cell of every point they visit, and floor() is a library call
+	static inline int floorToInt(const T value)
+	{
+		// Also catches NaN, as converting values outside the range of int is undefined
+		if (!(value > T(-cellLimit)))
+			return -cellLimit;
+
+		if (value >= T(cellLimit))
+			return cellLimit;
+
+		const int i = static_cast<int>(value);
+		return ((T(i) > value) ? (i - 1) : i);
+	}
+
+	static inline unsigned int hashRow(const int y, const int z)
+	{
+		return ((static_cast<unsigned int>(y) * 19349663u) ^ (static_cast<unsigned int>(z) * 83492791u));
+	}
+
+	// Calls function(sortedIndex, distanceSquared) for the points in the cells [xMin, xMax] of row (y, z)
+	template<typename Function>
+	inline void forEachInRow(const int y, const int z, const int xMin, const int xMax, const vec3 &center, Function function) const
+	{
+		const unsigned int rowHash = hashRow(y, z);
+
+		for (int x = xMin; x <= xMax;)
+		{
+			const unsigned int h = (rowHash + static_cast<unsigned int>(x)) & this->tableMask;
+
+			// The cells are consecutive entries, until the end of the table is reached
+			const unsigned int untilWrap = this->tableMask - h + 1;
+			const int n = static_cast<int>(std::min(static_cast<unsigned int>(xMax - x + 1), untilWrap));
+
+			const unsigned int begin = this->cellStarts[h];
+			const unsigned int end = this->cellStarts[h + n];
+
+			for (unsigned int i = begin; i < end; i++)
+			{
+				const vec3 &p = this->sortedPoints[i];
+
+				// Skip the points of other cells that hash to the same entries
+				const ivec3 cell = cellOf(p);
+
+				if ((cell.y != y) || (cell.z != z) || (cell.x < x) || (cell.x >= (x + n)))
+					continue;
+
+				function(i, (p - center).lengthSquared());
+			}
+
+			x += n;
+		}
+	}
+};
+
+
+template<typename T>
+void SpatialHashGridT<T>::build(const vec3 *points, const size_t count, const unsigned int threadCount)
+{
+	unsigned int tableSize = 1024;
+
+	while ((tableSize < (count * 2)) && (tableSize < 0x80000000u))
+		tableSize *= 2;
+
+	this->tableMask = tableSize - 1;
+
+	this->sortedPoints.resize(count);
+	this->sortedIndices.resize(count);
+	this->hashes.resize(count);
+
+	this->bounds = aabb::empty;
+
+	const size_t chunkCount = _linalg_chunk_count(count, minPointsPerThread, threadCount);
+
+	std::vector<aabb> chunkBounds(chunkCount, aabb::empty);
+
+	_linalg_parallel_chunks(count, chunkCount, [&](const size_t chunk, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			this->hashes[i] = hash(cellOf(points[i]));
+			chunkBounds[chunk].merge(points[i]);
+		}
+	});
+
+	for (size_t i = 0; i < chunkCount; i++)
+		this->bounds.merge(chunkBounds[i]);
+
+	this->cellStarts.assign(static_cast<size_t>(tableSize) + 1, 0);
+
+	if (chunkCount <= 1)
+	{
+		// Count into the entry after, such that after the prefix sum each entry holds the start of the previous
+		for (size_t i = 0; i < count; i++)
+			this->cellStarts[this->hashes[i] + 1]++;
+
+		unsigned int offset = 0;
+
+		for (unsigned int h = 0; h <= tableSize; h++)
+		{
+			const unsigned int n = this->cellStarts[h];
+			this->cellStarts[h] = offset;
+			offset += n;
+		}
+
+		// Scatter using cellStarts[h + 1] as the insertion point, which then ends up at the end of entry h
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned int j = this->cellStarts[this->hashes[i] + 1]++;
+
+			this->sortedPoints[j] = points[i];
+			this->sortedIndices[j] = static_cast<unsigned int>(i);
+		}
+
+		return;
+	}
+
+	// In parallel, counting and scattering is done with atomics. The table is large
+	// relative to the points, so there is little contention.
+	std::vector<std::atomic<unsigned int>> offsets(static_cast<size_t>(tableSize) + 1);
+
+	_linalg_parallel_chunks(offsets.size(), chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t h = begin; h < end; h++)
+			offsets[h].store(0, std::memory_order_relaxed);
+	});
+
+	_linalg_parallel_chunks(count, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			offsets[this->hashes[i]].fetch_add(1, std::memory_order_relaxed);
+	});
+
+	unsigned int offset = 0;
+
+	for (unsigned int h = 0; h <= tableSize; h++)
+	{
+		const unsigned int n = offsets[h].load(std::memory_order_relaxed);
+
+		this->cellStarts[h] = offset;
+		offsets[h].store(offset, std::memory_order_relaxed);
+
+		offset += n;
+	}
+
+	_linalg_parallel_chunks(count, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const unsigned int j = offsets[this->hashes[i]].fetch_add(1, std::memory_order_relaxed);
+
+			this->sortedPoints[j] = points[i];
+			this->sortedIndices[j] = static_cast<unsigned int>(i);
+		}
+	});
+
+	// The order within each entry depends on the thread timing, so sort the (few) points
+	// of each entry by index to get the same result as when building on a single thread
+	_linalg_parallel_chunks(tableSize, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t h = begin; h < end; h++)
+		{
+			const unsigned int first = this->cellStarts[h];
+			const unsigned int last = this->cellStarts[h + 1];
+
+			for (unsigned int i = first + 1; i < last; i++)
+			{
+				const vec3 p = this->sortedPoints[i];
+				const unsigned int index = this->sortedIndices[i];
+
+				unsigned int j = i;
+
+				for (; (j > first) && (this->sortedIndices[j - 1] > index); j--)
+				{
+					this->sortedPoints[j] = this->sortedPoints[j - 1];
+					this->sortedIndices[j] = this->sortedIndices[j - 1];
+				}
+
+				this->sortedPoints[j] = p;
+				this->sortedIndices[j] = index;
+			}
+		}
+	});
+}
+
+template<typename T>
+size_t SpatialHashGridT<T>::queryNearest(
+	const vec3 &point, const size_t k,
+	unsigned int *indices, T *distancesSquared,
+	const T maxDistance) const
+{
+	if ((k == 0) || this->sortedPoints.empty())
+		return 0;
+
+	const T maxDistanceSquared = (maxDistance < T(HUGE_VAL)) ? (maxDistance * maxDistance) : maxDistance;
+
+	// The found points are kept sorted by distance, as k is expected to be small
+	size_t found = 0;
+
+	const auto insert = [&](const unsigned int i, const T distanceSquared)
+	{
+		if ((distanceSquared > maxDistanceSquared) || ((found == k) && (distanceSquared >= distancesSquared[k - 1])))
+			return;
+
+		size_t j = (found < k) ? found++ : (k - 1);
+
+		for (; (j > 0) && (distancesSquared[j - 1] > distanceSquared); j--)
+		{
+			distancesSquared[j] = distancesSquared[j - 1];
+			indices[j] = indices[j - 1];
+		}
+
+		distancesSquared[j] = distanceSquared;
+		indices[j] = this->sortedIndices[i];
+	};
+
+	const ivec3 center = cellOf(point);
+
+	// Only the cells covering the bounds can contain points, so the rings are clipped to
+	// them, starting at the first ring that reaches them
+	const ivec3 minCell = cellOf(this->bounds.min);
+	const ivec3 maxCell = cellOf(this->bounds.max);
+
+	const int firstRing = std::max(
+		std::max(std::max(minCell.x - center.x, center.x - maxCell.x), std::max(minCell.y - center.y, center.y - maxCell.y)),
+		std::max(std::max(minCell.z - center.z, center.z - maxCell.z), 0));
+
+	const int maxRing = std::max(
+		std::max(std::max(center.x - minCell.x, maxCell.x - center.x), std::max(center.y - minCell.y, maxCell.y - center.y)),
+		std::max(center.z - minCell.z, maxCell.z - center.z));
+
+	for (int ring = firstRing; ring <= maxRing; ring++)
+	{
+		const int xMin = std::max(center.x - ring, minCell.x), xMax = std::min(center.x + ring, maxCell.x);
+		const int yMin = std::max(center.y - ring, minCell.y), yMax = std::min(center.y + ring, maxCell.y);
+		const int zMin = std::max(center.z - ring, minCell.z), zMax = std::min(center.z + ring, maxCell.z);
+
+		// Visit the cells on the surface of the cube of cells at this ring
+		for (int z = zMin; z <= zMax; z++)
+		{
+			for (int y = yMin; y <= yMax; y++)
+			{
+				if ((std::abs(z - center.z) == ring) || (std::abs(y - center.y) == ring))
+					forEachInRow(y, z, xMin, xMax, point, insert);
+				else
+				{
+					if (xMin == (center.x - ring))
+						forEachInRow(y, z, xMin, xMin, point, insert);
+
+					if (xMax == (center.x + ring))
+						forEachInRow(y, z, xMax, xMax, point, insert);
+				}
+			}
+		}
+
+		// The distance to the nearest face of the visited cube, which all unvisited points are
+		// beyond. Faces past the bounds have no points beyond them.
+		T faceDistance = T(HUGE_VAL);
+
+		for (int i = 0; i < 3; i++)
+		{
+			if ((center[i] - ring) > minCell[i])
+				faceDistance = std::min(faceDistance, point[i] - T(center[i] - ring) * this->cellSize);
+
+			if ((center[i] + ring) < maxCell[i])
+				faceDistance = std::min(faceDistance, T(center[i] + ring + 1) * this->cellSize - point[i]);
+		}
+
+		const T faceDistanceSquared = faceDistance * faceDistance;
+
+		if ((faceDistanceSquared >= maxDistanceSquared) || ((found == k) && (faceDistanceSquared >= distancesSquared[k - 1])))
+			break;
+	}
+
+	return found;
+}
+
+
+// A k-d tree over points, stored without pointers as a left-balanced binary tree in an
+// array, where the children of node i are 2i + 1 and 2i + 2. Every node is a point,
+// splitting its subtree at the median along the axis where the subtree's points are
+// spread out the most.
+//
+// Approximate queries take an epsilon, such that subtrees are skipped unless they can
+// contain a point closer than 1 / (1 + epsilon) times the current k-th nearest. Each
+// found neighbour is then at most (1 + epsilon) times further than the true one.
+//
+// Reference: Arya et al., "An Optimal Algorithm for Approximate Nearest Neighbor Searching in Fixed Dimensions" (1998)
+template<typename T>
+class KdTreeT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+
+
+public:
+
+	// Written by the batch queries for the neighbours beyond the amount found
+	static const unsigned int invalidIndex = 0xFFFFFFFFu;
+
+	// Below this amount of queries per thread, batches aren't split any further
+	static const size_t minQueriesPerThread = 1024;
+
+
+	// The points in tree order, the index of each in the input, and the axis each splits along
+	std::vector<vec3> nodes;
+	std::vector<unsigned int> indices;
+	std::vector<unsigned char> axes;
+
+
+public:
+
+	KdTreeT() {}
+	~KdTreeT() {}
+
+
+	// The points are copied. A threadCount of 0 uses one thread per hardware thread.
+	void build(const vec3 *points, const size_t count, const unsigned int threadCount = 0);
+
+	inline size_t size() const { return this->nodes.size(); }
+
+
+	// Finds the k nearest points within maxDistance of point, writing their indices and squared
+	// distances ordered nearest first, and returns the amount found.
+	size_t queryNearest(
+		const vec3 &point, const size_t k,
+		unsigned int *indices, T *distancesSquared,
+		const T epsilon = T(0), const T maxDistance = T(HUGE_VAL)) const;
+
+	// Finds the k nearest neighbours of each of count points, where query i writes
+	// to indices[i * k] and distancesSquared[i * k]. Neighbours beyond the amount found
+	// are set to invalidIndex and HUGE_VAL.
+	void queryNearest(
+		const vec3 *points, const size_t count, const size_t k,
+		unsigned int *indices, T *distancesSquared,
+		const T epsilon = T(0), const T maxDistance = T(HUGE_VAL),
+		const unsigned int threadCount = 0) const
+	{
+		_linalg_parallel_for(count, minQueriesPerThread, threadCount, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const size_t found = queryNearest(points[i], k, indices + i * k, distancesSquared + i * k, epsilon, maxDistance);
+
+				for (size_t j = found; j < k; j++)
+				{
+					indices[i * k + j] = invalidIndex;
+					distancesSquared[i * k + j] = T(HUGE_VAL);
+				}
+			}
+		});
+	}
+
+
+	// Calls function(index, distanceSquared) for each point within radius of center
+	template<typename Function>
+	void forEachInRadius(const vec3 &center, const T radius, Function function) const;
+
+	// Appends the indices of the points within radius of center, and returns the amount appended
+	size_t queryRadius(const vec3 &center, const T radius, std::vector<unsigned int> &result) const
+	{
+		const size_t previousSize = result.size();
+
+		forEachInRadius(center, radius, [&](const unsigned int index, const T)
+		{
+			result.push_back(index);
+		});
+
+		return (result.size() - previousSize);
+	}
+
+
+private:
+
+	static const size_t minPointsPerThread = 65536;
+
+	// A left-balanced tree of 2^32 points is 32 levels deep
+	static const int maxDepth = 32;
+
+
+	struct BuildPoint
+	{
+		vec3 point;
+		unsigned int index;
+	};
+
+	void buildNode(BuildPoint *points, const size_t count, const size_t node, const int parallelDepth);
+
+	// The amount of points in the left subtree of a left-balanced tree of count points
+	static inline size_t leftSubtreeSize(const size_t count)
+	{
+		if (count <= 1)
+			return 0;
+
+		// The amount of full levels below the root, and the points on the last level
+		size_t full = 1;
+
+		while (((full * 2) + 1) <= count)
+			full = full * 2 + 1;
+
+		const size_t lastLevel = count - full;
+		const size_t halfLastLevel = (full + 1) / 2;
+
+		return ((full - 1) / 2 + std::min(lastLevel, halfLastLevel));
+	}
+};
+
+
+template<typename T>
+void KdTreeT<T>::build(const vec3 *points, const size_t count, unsigned int threadCount)
+{
+	this->nodes.resize(count);
+	this->indices.resize(count);
+	this->axes.resize(count);
+
+	if (count == 0)
+		return;
+
+	std::vector<BuildPoint> buildPoints(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		buildPoints[i].point = points[i];
+		buildPoints[i].index = static_cast<unsigned int>(i);
+	}
+
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+
+	// Each level of the tree doubles the amount of subtrees being built in parallel
+	int parallelDepth = 0;
+
+	while ((1u << parallelDepth) < threadCount)
+		parallelDepth++;
+
+	buildNode(buildPoints.data(), count, 0, parallelDepth);
+}
+
+template<typename T>
+void KdTreeT<T>::buildNode(BuildPoint *points, const size_t count, const size_t node, const int parallelDepth)
+{
+	if (count == 0)
+		return;
+
+	// Split along the axis where the points are spread out the most
+	vec3 min = points[0].point, max = points[0].point;
+
+	for (size_t i = 1; i < count; i++)
+	{
+		min = min.min(points[i].point);
+		max = max.max(points[i].point);
+	}
+
+	const vec3 extent = max - min;
+	const int axis = ((extent.x >= extent.y) && (extent.x >= extent.z)) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+
+	const size_t median = leftSubtreeSize(count);
+
+	std::nth_element(points, points + median, points + count, [axis](const BuildPoint &a, const BuildPoint &b)
+	{
+		return (a.point[axis] < b.point[axis]);
+	});
+
+	this->nodes[node] = points[median].point;
+	this->indices[node] = points[median].index;
+	this->axes[node] = static_cast<unsigned char>(axis);
+
+	if ((parallelDepth > 0) && (count >= minPointsPerThread))
+	{
+		std::thread leftThread([this, points, median, node, parallelDepth]()
+		{
+			buildNode(points, median, node * 2 + 1, parallelDepth - 1);
+		});
+
+		buildNode(points + median + 1, count - median - 1, node * 2 + 2, parallelDepth - 1);
+
+		leftThread.join();
+	}
+	else
+	{
+		buildNode(points, median, node * 2 + 1, 0);
+		buildNode(points + median + 1, count - median - 1, node * 2 + 2, 0);
+	}
+}
+
+template<typename T>
+size_t KdTreeT<T>::queryNearest(
+	const vec3 &point, const size_t k,
+	unsigned int *indices, T *distancesSquared,
+	const T epsilon, const T maxDistance) const
+{
+	const size_t count = this->nodes.size();
+
+	if ((k == 0) || (count == 0))
+		return 0;
+
+	const T maxDistanceSquared = (maxDistance < T(HUGE_VAL)) ? (maxDistance * maxDistance) : maxDistance;
+	const T scaleSquared = (T(1) + epsilon) * (T(1) + epsilon);
+
+	size_t found = 0;
+
+	// The far subtrees yet to be visited, along with the squared distance to their splitting plane
+	size_t stackNodes[maxDepth + 1];
+	T stackDistances[maxDepth + 1];
+	int stackSize = 0;
+
+	size_t node = 0;
+
+	for (;;)
+	{
+		while (node < count)
+		{
+			const vec3 &p = this->nodes[node];
+			const T distanceSquared = (p - point).lengthSquared();
+
+			// Insert into the found points, which are kept sorted by distance as k is expected to be small
+			if ((distanceSquared <= maxDistanceSquared) && ((found < k) || (distanceSquared < distancesSquared[k - 1])))
+			{
+				size_t j = (found < k) ? found++ : (k - 1);
+
+				for (; (j > 0) && (distancesSquared[j - 1] > distanceSquared); j--)
+				{
+					distancesSquared[j] = distancesSquared[j - 1];
+					indices[j] = indices[j - 1];
+				}
+
+				distancesSquared[j] = distanceSquared;
+				indices[j] = this->indices[node];
+			}
+
+			const int axis = this->axes[node];
+			const T difference = point[axis] - p[axis];
+
+			const size_t nearChild = node * 2 + ((difference < T(0)) ? 1 : 2);
+			const size_t farChild = node * 2 + ((difference < T(0)) ? 2 : 1);
+
+			if (farChild < count)
+			{
+				stackNodes[stackSize] = farChild;
+				stackDistances[stackSize] = difference * difference;
+				stackSize++;
+			}
+
+			node = nearChild;
+		}
+
+		// Skip the far subtrees that can't contain anything closer than what has been found since
+		bool popped = false;
+
+		while ((stackSize > 0) && !popped)
+		{
+			stackSize--;
+
+			const T planeDistanceSquared = stackDistances[stackSize] * scaleSquared;
+
+			popped = (planeDistanceSquared <= maxDistanceSquared) && ((found < k) || (planeDistanceSquared < distancesSquared[k - 1]));
+			node = stackNodes[stackSize];
+		}
+
+		if (!popped)
+			break;
+	}
+
+	return found;
+}
+
+template<typename T>
+template<typename Function>
+void KdTreeT<T>::forEachInRadius(const vec3 &center, const T radius, Function function) const
+{
+	const size_t count = this->nodes.size();
+	const T radiusSquared = radius * radius;
+
+	size_t stack[maxDepth + 1];
+	int stackSize = 0;
+
+	if (count > 0)
+		stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		size_t node = stack[--stackSize];
+
+		while (node < count)
+		{
+			const vec3 &p = this->nodes[node];
+			const T distanceSquared = (p - center).lengthSquared();
+
+			if (distanceSquared <= radiusSquared)
+				function(this->indices[node], distanceSquared);
+
+			const int axis = this->axes[node];
+			const T difference = center[axis] - p[axis];
+
+			const size_t nearChild = node * 2 + ((difference < T(0)) ? 1 : 2);
+			const size_t farChild = node * 2 + ((difference < T(0)) ? 2 : 1);
+
+			if ((farChild < count) && ((difference * difference) <= radiusSquared))
+				stack[stackSize++] = farChild;
+
+			node = nearChild;
+		}
+	}
+}
+
+
+
+// A software occlusion culler. Occluder triangles are rasterized into a low resolution
+// depth buffer, keeping the nearest depth per pixel, 4 pixels at a time. A hierarchy
+// of the furthest depth over 2x2 pixels is then built, such that a box can be tested
+// by comparing its nearest depth against a few texels of the level its screen
+// rectangle fits within.
+//
+// Depth is the normalized device z in [-1, 1], as produced by mat4_t::perspective().
+// The culler is conservative: pixels are only covered if they're entirely inside an
+// occluder triangle, or the triangles sharing its edges, keeping their furthest depth
+// over the pixel. Occluders crossing the near plane are skipped, and boxes crossing
+// the near plane are always visible. Edges are shared by triangles of the same call
+// to rasterize() with the exact same endpoints, so occluders should be connected meshes
+// of triangles that aren't much smaller than a pixel.
+//
+// Usage: begin() with the view-projection matrix, rasterize() the occluders, end()
+// to build the hierarchy, then test the occludees with isVisible() or testAABBs().
+class OcclusionCuller
+{
+public:
+
+	OcclusionCuller(const int width = 256, const int height = 128)
+	{
+		resize(width, height);
+	}
+
+	~OcclusionCuller() {}
+
+
+	// The width is rounded up to a multiple of 4, as the rasterizer works on 4 pixels at a time
+	void resize(const int width, const int height)
+	{
+		this->width = (std::max(width, 4) + 3) & ~3;
+		this->height = std::max(height, 1);
+
+		this->levels.clear();
+
+		int levelWidth = this->width, levelHeight = this->height;
+
+		for (;;)
+		{
+			this->levels.push_back(Level());
+
+			Level &level = this->levels.back();
+
+			level.width = levelWidth;
+			level.height = levelHeight;
+			level.depth.assign(static_cast<size_t>(levelWidth) * levelHeight, 1.0f);
+
+			if ((levelWidth == 1) && (levelHeight == 1))
+				break;
+
+			levelWidth = (levelWidth + 1) / 2;
+			levelHeight = (levelHeight + 1) / 2;
+		}
+	}
+
+	inline int getWidth() const { return this->width; }
+	inline int getHeight() const { return this->height; }
+
+	inline int getLevelCount() const { return static_cast<int>(this->levels.size()); }
+
+	// The depth of level 0 is the nearest occluder entirely covering each pixel, the others the furthest of 2x2 texels below
+	inline const float* getDepth(const int level = 0) const { return this->levels[level].depth.data(); }
+
+
+	void begin(const fmat4 &viewProjection)
+	{
+		this->viewProjection = viewProjection;
+
+		std::vector<float> &depth = this->levels[0].depth;
+		std::fill(depth.begin(), depth.end(), 1.0f);
+	}
+
+	// Rasterizes the triangles of an occluder given in world space, where triangle i is made
+	// of the vertices indices[i * 3 + 0..2]. If indices is nullptr, triangle i is made of
+	// vertices[i * 3 + 0..2]. Both sides of the triangles occlude.
+	void rasterize(const fvec3 *vertices, const unsigned int *indices, const size_t triangleCount)
+	{
+		rasterizeTransformed(vertices, indices, triangleCount, this->viewProjection);
+	}
+
+	// Same as above, but with the occluder given in object space
+	void rasterize(const fvec3 *vertices, const unsigned int *indices, const size_t triangleCount, const fmat4 &model)
+	{
+		rasterizeTransformed(vertices, indices, triangleCount, this->viewProjection * model);
+	}
+
+	// Builds the depth hierarchy, after which boxes can be tested
+	void end()
+	{
+		for (size_t i = 1; i < this->levels.size(); i++)
+		{
+			const Level &source = this->levels[i - 1];
+			Level &target = this->levels[i];
+
+			for (int y = 0; y < target.height; y++)
+			{
+				const int y0 = y * 2;
+				const int y1 = std::min(y0 + 1, source.height - 1);
+
+				for (int x = 0; x < target.width; x++)
+				{
+					const int x0 = x * 2;
+					const int x1 = std::min(x0 + 1, source.width - 1);
+
+					const float *row0 = &source.depth[static_cast<size_t>(y0) * source.width];
+					const float *row1 = &source.depth[static_cast<size_t>(y1) * source.width];
+
+					target.depth[static_cast<size_t>(y) * target.width + x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+				}
+			}
+		}
+	}
+
+
+	// Tests a box in world space, boxes outside the screen aren't visible
+	bool isVisible(const faabb &box) const
+	{
+		float rect[4], nearestDepth;
+
+		if (!project(box.min, box.max, rect, nearestDepth))
+			return true;
+
+		return testRect(rect, nearestDepth);
+	}
+
+	// Tests count boxes given as a structure of arrays. The visibility is written as a bitmask
+	// like frustum_t::cullAABBs(), where bit (i % 8) of visibility[i / 8] is set if box i is visible.
+	void testAABBs(
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		const size_t count, unsigned char *visibility) const;
+
+
+private:
+
+	struct Level
+	{
+		int width, height;
+		std::vector<float> depth;
+	};
+
+	// Vertices closer than this in clip space w are considered crossing the near plane
+	static inline float minW() { return 1E-5f; }
+
+
+	// An edge function a * x + b * y + c in screen space, positive on the inside
+	struct Edge
+	{
+		float a, b, c;
+
+		inline float operator()(const float x, const float y) const { return this->a * x + this->b * y + this->c; }
+	};
+
+	// An edge of an occluder triangle, keyed by the bits of its endpoints in the order of their bits. The
+	// first edge found with a key counts the edges sharing it, and keeps the second one.
+	struct SharedEdge
+	{
+		unsigned int key[6];
+		unsigned int count, second;
+	};
+
+
+	int width, height;
+
+	std::vector<Level> levels;
+
+	fmat4 viewProjection;
+
+	// Reused by rasterize(), the screen space vertices and edges of the occluder triangles, a hash table
+	// of the first edge with each key, and for each edge the vertex across it in the triangle sharing it
+	std::vector<fvec3> screenVertices;
+	std::vector<unsigned char> skippedTriangles;
+	std::vector<SharedEdge> sharedEdges;
+	std::vector<unsigned int> edgeTable;
+	std::vector<const fvec3*> oppositeVertices;
+
+
+	void rasterizeTransformed(const fvec3 *vertices, const unsigned int *indices, const size_t triangleCount, const fmat4 &m);
+
+	// Rasterizes the triangle of 3 screen space vertices, where opposite[i] is the vertex across the edge
+	// opposite vertex i in the triangle sharing that edge, or nullptr if the edge isn't shared
+	void rasterizeTriangle(const fvec3 v[3], const fvec3 *const opposite[3]);
+
+	// The screen position in pixels and depth of a clip space vertex, which is affine in screen space
+	inline fvec3 toScreen(const fvec4 &clip) const
+	{
+		const float invW = 1.0f / clip.w;
+
+		return fvec3((clip.x * invW * 0.5f + 0.5f) * this->width, (clip.y * invW * 0.5f + 0.5f) * this->height, clip.z * invW);
+	}
+
+	// The edge through p and q, oriented such that r is inside
+	static inline Edge edgeOf(const fvec3 &p, const fvec3 &q, const fvec3 &r)
+	{
+		Edge e = { p.y - q.y, q.x - p.x, p.x * q.y - q.x * p.y };
+
+		if (e(r.x, r.y) < 0.0f)
+		{
+			e.a = -e.a;
+			e.b = -e.b;
+			e.c = -e.c;
+		}
+
+		return e;
+	}
+
+	// The plane z = x * dzdx + y * dzdy + dz of a triangle's depth, given its edges opposite each vertex
+	static inline fvec3 depthPlane(const Edge e[3], const fvec3 v[3])
+	{
+		const float invArea = 1.0f / e[0](v[0].x, v[0].y);
+
+		return fvec3(
+			(e[0].a * v[0].z + e[1].a * v[1].z + e[2].a * v[2].z) * invArea,
+			(e[0].b * v[0].z + e[1].b * v[1].z + e[2].b * v[2].z) * invArea,
+			(e[0].c * v[0].z + e[1].c * v[1].z + e[2].c * v[2].z) * invArea);
+	}
+
+	// Computes the screen rectangle (minX, minY, maxX, maxY in pixels) and nearest depth of a
+	// box. Returns false if the box crosses the near plane, in which case it's always visible.
+	bool project(const fvec3 &min, const fvec3 &max, float rect[4], float &nearestDepth) const
+	{
+		rect[0] = rect[1] = float(HUGE_VAL);
+		rect[2] = rect[3] = -float(HUGE_VAL);
+
+		nearestDepth = float(HUGE_VAL);
+
+		for (int i = 0; i < 8; i++)
+		{
+			const fvec4 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z, 1.0f);
+			const fvec4 clip = this->viewProjection * corner;
+
+			if (clip.w <= minW())
+				return false;
+
+			const float invW = 1.0f / clip.w;
+
+			const float x = (clip.x * invW * 0.5f + 0.5f) * this->width;
+			const float y = (clip.y * invW * 0.5f + 0.5f) * this->height;
+
+			rect[0] = std::min(rect[0], x);
+			rect[1] = std::min(rect[1], y);
+			rect[2] = std::max(rect[2], x);
+			rect[3] = std::max(rect[3], y);
+
+			nearestDepth = std::min(nearestDepth, clip.z * invW);
+		}
+
+		return true;
+	}
+
+	// Tests a screen rectangle against the texels of the first level it covers at most 2x2 texels of
+	bool testRect(const float rect[4], const float nearestDepth) const
+	{
+		// Pixels are covered from their edges rather than centers, as an occludee must cover any pixel it touches
+		const int x0 = std::max(static_cast<int>(floorf(rect[0])), 0);
+		const int y0 = std::max(static_cast<int>(floorf(rect[1])), 0);
+		const int x1 = std::min(static_cast<int>(floorf(rect[2])), this->width - 1);
+		const int y1 = std::min(static_cast<int>(floorf(rect[3])), this->height - 1);
+
+		if ((x0 > x1) || (y0 > y1))
+			return false;
+
+		int level = 0;
+
+		while (((x1 >> level) - (x0 >> level) > 1) || ((y1 >> level) - (y0 >> level) > 1))
+			level++;
+
+		const Level &l = this->levels[level];
+
+		for (int y = (y0 >> level); y <= (y1 >> level); y++)
+			for (int x = (x0 >> level); x <= (x1 >> level); x++)
+				if (nearestDepth <= l.depth[static_cast<size_t>(y) * l.width + x])
+					return true;
+
+		return false;
+	}
+};
+
+
+inline void OcclusionCuller::rasterizeTransformed(const fvec3 *vertices, const unsigned int *indices, const size_t triangleCount, const fmat4 &m)
+{
+	size_t tableSize = 64;
+
+	while (tableSize < (triangleCount * 3 * 2))
+		tableSize *= 2;
+
+	const size_t tableMask = tableSize - 1;
+
+	// The table holds the index of the first edge with a key plus 1, leaving 0 for empty slots
+	this->screenVertices.resize(triangleCount * 3);
+	this->skippedTriangles.resize(triangleCount);
+	this->sharedEdges.resize(triangleCount * 3);
+	this->edgeTable.assign(tableSize, 0);
+	this->oppositeVertices.assign(triangleCount * 3, nullptr);
+
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		const fvec3 *corners[3];
+		bool skipped = false;
+
+		for (int j = 0; j < 3; j++)
+		{
+			corners[j] = &vertices[indices ? indices[i * 3 + j] : (i * 3 + j)];
+
+			const fvec4 c = m * fvec4(corners[j]->x, corners[j]->y, corners[j]->z, 1.0f);
+
+			// Clipping would only add occlusion, so triangles crossing the near plane are skipped
+			skipped = skipped || (c.w <= minW()) || (c.z < -c.w);
+
+			if (!skipped)
+				this->screenVertices[i * 3 + j] = toScreen(c);
+		}
+
+		this->skippedTriangles[i] = skipped ? 1 : 0;
+
+		if (skipped)
+			continue;
+
+		// Edge j is the one across from vertex j, edges are matched by the exact positions of their endpoints
+		for (int j = 0; j < 3; j++)
+		{
+			const fvec3 *p = corners[(j + 1) % 3], *q = corners[(j + 2) % 3];
+
+			const unsigned int index = static_cast<unsigned int>(i * 3 + j);
+			SharedEdge &edge = this->sharedEdges[index];
+
+			unsigned int pBits[3], qBits[3];
+			memcpy(pBits, &p->x, sizeof(pBits));
+			memcpy(qBits, &q->x, sizeof(qBits));
+
+			const bool swap = std::lexicographical_compare(qBits, qBits + 3, pBits, pBits + 3);
+
+			std::copy(swap ? qBits : pBits, (swap ? qBits : pBits) + 3, edge.key);
+			std::copy(swap ? pBits : qBits, (swap ? pBits : qBits) + 3, edge.key + 3);
+
+			edge.count = 1;
+
+			// FNV-1a over the key, with linear probing
+			unsigned long long hash = 14695981039346656037ull;
+
+			for (int k = 0; k < 6; k++)
+				hash = (hash ^ edge.key[k]) * 1099511628211ull;
+
+			size_t slot = static_cast<size_t>(hash ^ (hash >> 32)) & tableMask;
+
+			for (;; slot = (slot + 1) & tableMask)
+			{
+				if (this->edgeTable[slot] == 0)
+				{
+					this->edgeTable[slot] = index + 1;
+					break;
+				}
+
+				SharedEdge &first = this->sharedEdges[this->edgeTable[slot] - 1];
+
+				if (memcmp(first.key, edge.key, sizeof(edge.key)) == 0)
+				{
+					first.second = index;
+					first.count++;
+					break;
+				}
+			}
+		}
+	}
+
+	// Pair up the edges shared by exactly two rasterized triangles
+	for (size_t i = 0; i < tableSize; i++)
+	{
+		if (this->edgeTable[i] == 0)
+			continue;
+
+		const unsigned int first = this->edgeTable[i] - 1, second = this->sharedEdges[first].second;
+
+		if ((this->sharedEdges[first].count != 2) || ((first / 3) == (second / 3)))
+			continue;
+
+		this->oppositeVertices[first] = &this->screenVertices[second];
+		this->oppositeVertices[second] = &this->screenVertices[first];
+	}
+
+	for (size_t i = 0; i < triangleCount; i++)
+		if (!this->skippedTriangles[i])
+			rasterizeTriangle(&this->screenVertices[i * 3], &this->oppositeVertices[i * 3]);
+}
+
+inline void OcclusionCuller::rasterizeTriangle(const fvec3 v[3], const fvec3 *const opposite[3])
+{
+	// Triangles without area in screen space don't cover anything
+	const float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+
+	if (fabsf(area) < 1E-12f)
+		return;
+
+	// Occluders beyond the far plane don't occlude anything
+	if ((v[0].z > 1.0f) && (v[1].z > 1.0f) && (v[2].z > 1.0f))
+		return;
+
+	const int minX = std::max(static_cast<int>(floorf(std::min(std::min(v[0].x, v[1].x), v[2].x))), 0);
+	const int minY = std::max(static_cast<int>(floorf(std::min(std::min(v[0].y, v[1].y), v[2].y))), 0);
+	const int maxX = std::min(static_cast<int>(ceilf(std::max(std::max(v[0].x, v[1].x), v[2].x))), this->width - 1);
+	const int maxY = std::min(static_cast<int>(ceilf(std::max(std::max(v[0].y, v[1].y), v[2].y))), this->height - 1);
+
+	if ((minX > maxX) || (minY > maxY))
+		return;
+
+	// The edges across from each vertex, and the depth plane from the barycentric weights
+	const Edge edges[3] = { edgeOf(v[1], v[2], v[0]), edgeOf(v[2], v[0], v[1]), edgeOf(v[0], v[1], v[2]) };
+	const fvec3 plane = depthPlane(edges, v);
+
+	// A pixel is only covered if it's entirely inside, such that an occludee beside the triangle
+	// sharing the pixel is never hidden. As the pixel would then also be left uncovered along
+	// the edges shared with other triangles, an edge may be crossed if the pixel is entirely
+	// inside the triangle across it. The furthest depth of the triangles over the pixel is kept.
+	//
+	// The edge functions and depth are evaluated at pixel centers, so offsetting them by half a
+	// pixel along each axis gives their least and furthest values over the pixel.
+	Edge inner[9] = {};
+	fvec3 planes[4] = { plane };
+
+	bool shared[3];
+
+	for (int i = 0; i < 3; i++)
+	{
+		inner[i] = edges[i];
+		inner[i].c -= 0.5f * (fabsf(edges[i].a) + fabsf(edges[i].b));
+
+		shared[i] = false;
+
+		if (!opposite[i])
+			continue;
+
+		// The triangle across must lie on the other side of the edge, rather than fold back over this one
+		const fvec3 p = v[(i + 1) % 3], q = v[(i + 2) % 3], r = *opposite[i];
+
+		if (!(edges[i](r.x, r.y) < -1E-12f))
+			continue;
+
+		shared[i] = true;
+
+		const Edge across[3] = { edgeOf(p, q, r), edgeOf(q, r, p), edgeOf(r, p, q) };
+
+		const fvec3 acrossVertices[3] = { r, p, q };
+		planes[i + 1] = depthPlane(across, acrossVertices);
+
+		for (int j = 0; j < 2; j++)
+		{
+			inner[3 + i * 2 + j] = across[j + 1];
+			inner[3 + i * 2 + j].c -= 0.5f * (fabsf(across[j + 1].a) + fabsf(across[j + 1].b));
+		}
+	}
+
+	for (int i = 0; i < 4; i++)
+		planes[i].z += 0.5f * (fabsf(planes[i].x) + fabsf(planes[i].y));
+
+	const bool anyShared = shared[0] || shared[1] || shared[2];
+
+	_linalg_float4 edgeA[9], planeX[4];
+
+	for (int i = 0; i < 9; i++)
+		edgeA[i] = _linalg_float4(inner[i].a);
+
+	for (int i = 0; i < 4; i++)
+		planeX[i] = _linalg_float4(planes[i].x);
+
+	const _linalg_float4 zero(0.0f);
+
+	const _linalg_float4 laneX(0.5f, 1.5f, 2.5f, 3.5f), stepX(4.0f);
+
+	float *depth = this->levels[0].depth.data();
+
+	// The width is a multiple of 4, so aligning the start keeps the 4 pixels within the row
+	const int startX = minX & ~3;
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		const float py = float(y) + 0.5f;
+
+		_linalg_float4 rowEdges[9], rowPlanes[4];
+
+		for (int i = 0; i < (anyShared ? 9 : 3); i++)
+			rowEdges[i] = _linalg_float4(inner[i].b * py + inner[i].c);
+
+		for (int i = 0; i < (anyShared ? 4 : 1); i++)
+			rowPlanes[i] = _linalg_float4(planes[i].y * py + planes[i].z);
+
+		float *row = depth + static_cast<size_t>(y) * this->width;
+
+		_linalg_float4 px = _linalg_float4(float(startX)) + laneX;
+
+		for (int x = startX; x <= maxX; x += 4, px = px + stepX)
+		{
+			const _linalg_float4 inside[3] =
+			{
+				_linalg_cmpge(edgeA[0] * px + rowEdges[0], zero),
+				_linalg_cmpge(edgeA[1] * px + rowEdges[1], zero),
+				_linalg_cmpge(edgeA[2] * px + rowEdges[2], zero)
+			};
+
+			_linalg_float4 covered = _linalg_and(_linalg_and(inside[0], inside[1]), inside[2]);
+			_linalg_float4 z = planeX[0] * px + rowPlanes[0];
+
+			// Only the pixels along the edges need to look across them
+			if (anyShared && (_linalg_movemask(covered) != 0xF))
+			{
+				covered = _linalg_cmpge(zero, zero);
+
+				for (int i = 0; i < 3; i++)
+				{
+					if (!shared[i])
+					{
+						covered = _linalg_and(covered, inside[i]);
+						continue;
+					}
+
+					const _linalg_float4 insideAcross = _linalg_and(
+						_linalg_cmpge(edgeA[3 + i * 2] * px + rowEdges[3 + i * 2], zero),
+						_linalg_cmpge(edgeA[4 + i * 2] * px + rowEdges[4 + i * 2], zero));
+
+					covered = _linalg_and(covered, _linalg_or(inside[i], insideAcross));
+
+					// Where the pixel crosses the edge, it also takes the depth of the triangle across
+					z = _linalg_select(inside[i], z, _linalg_max(z, planeX[i + 1] * px + rowPlanes[i + 1]));
+				}
+			}
+
+			if (_linalg_movemask(covered))
+			{
+				const _linalg_float4 d = _linalg_float4::load(row + x);
+
+				_linalg_select(covered, _linalg_min(d, z), d).store(row + x);
+			}
+		}
+	}
+}
+
+inline void OcclusionCuller::testAABBs(
+	const float *minX, const float *minY, const float *minZ,
+	const float *maxX, const float *maxY, const float *maxZ,
+	const size_t count, unsigned char *visibility) const
+{
+	const fmat4 &m = this->viewProjection;
+
+	const _linalg_float4 half(0.5f), width(float(this->width)), height(float(this->height));
+	const _linalg_float4 minWLanes(minW()), huge(static_cast<float>(HUGE_VAL)), negHuge(-static_cast<float>(HUGE_VAL));
+
+	for (size_t i = 0; i < count; i += 8)
+		visibility[i / 8] = 0;
+
+	size_t i = 0;
+
+	// Project the 8 corners of 4 boxes at a time, then test their rectangles one by one
+	for (; (i + 4) <= count; i += 4)
+	{
+		const _linalg_float4 bounds[2][3] =
+		{
+			{ _linalg_float4::load(minX + i), _linalg_float4::load(minY + i), _linalg_float4::load(minZ + i) },
+			{ _linalg_float4::load(maxX + i), _linalg_float4::load(maxY + i), _linalg_float4::load(maxZ + i) }
+		};
+
+		_linalg_float4 rectMinX = huge, rectMinY = huge, rectMaxX = negHuge, rectMaxY = negHuge;
+		_linalg_float4 nearestDepth = huge;
+		_linalg_float4 crossesNear = _linalg_cmplt(huge, huge);
+
+		for (int c = 0; c < 8; c++)
+		{
+			const _linalg_float4 &x = bounds[c & 1][0];
+			const _linalg_float4 &y = bounds[(c >> 1) & 1][1];
+			const _linalg_float4 &z = bounds[(c >> 2) & 1][2];
+
+			const _linalg_float4 clipX = _linalg_float4(m[0].x) * x + _linalg_float4(m[1].x) * y + _linalg_float4(m[2].x) * z + _linalg_float4(m[3].x);
+			const _linalg_float4 clipY = _linalg_float4(m[0].y) * x + _linalg_float4(m[1].y) * y + _linalg_float4(m[2].y) * z + _linalg_float4(m[3].y);
+			const _linalg_float4 clipZ = _linalg_float4(m[0].z) * x + _linalg_float4(m[1].z) * y + _linalg_float4(m[2].z) * z + _linalg_float4(m[3].z);
+			const _linalg_float4 clipW = _linalg_float4(m[0].w) * x + _linalg_float4(m[1].w) * y + _linalg_float4(m[2].w) * z + _linalg_float4(m[3].w);
+
+			crossesNear = _linalg_or(crossesNear, _linalg_cmple(clipW, minWLanes));
+
+			const _linalg_float4 invW = _linalg_float4(1.0f) / clipW;
+
+			const _linalg_float4 sx = (clipX * invW * half + half) * width;
+			const _linalg_float4 sy = (clipY * invW * half + half) * height;
+
+			rectMinX = _linalg_min(rectMinX, sx);
+			rectMinY = _linalg_min(rectMinY, sy);
+			rectMaxX = _linalg_max(rectMaxX, sx);
+			rectMaxY = _linalg_max(rectMaxY, sy);
+
+			nearestDepth = _linalg_min(nearestDepth, clipZ * invW);
+		}
+
+		const int nearMask = _linalg_movemask(crossesNear);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			const float rect[4] = { rectMinX[lane], rectMinY[lane], rectMaxX[lane], rectMaxY[lane] };
+
+			if ((nearMask & (1 << lane)) || testRect(rect, nearestDepth[lane]))
+				visibility[(i + lane) / 8] |= static_cast<unsigned char>(1u << ((i + lane) % 8));
+		}
+	}
+
+	for (; i < count; i++)
+		if (isVisible(faabb(fvec3(minX[i], minY[i], minZ[i]), fvec3(maxX[i], maxY[i], maxZ[i]))))
+			visibility[i / 8] |= static_cast<unsigned char>(1u << (i % 8));
+}
+
+
+
+// A clustered lighting grid, splitting the view frustum of mat4_t::perspective() into
+// tilesX * tilesY screen tiles and slices exponentially spaced depth slices. The view
+// space bounds of every cluster are derived directly from the perspective parameters,
+// as the tile edges are planes through the eye, instead of unprojecting their corners.
+//
+// Cluster (x, y, z) is at index (z * tilesY + y) * tilesX + x, where x and y go from the
+// left bottom of the screen and z from the near plane. After assignLights(), the lights
+// of cluster i are lightIndices[lightOffsets[i] .. lightOffsets[i + 1]).
+template<typename T>
+class ClusterGridT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+	typedef mat4_t<T> mat4;
+	typedef aabb_t<T> aabb;
+	typedef sphere_t<T> sphere;
+
+
+public:
+
+	// Returned by clusterOf() for positions outside of the grid
+	static const size_t invalidIndex = ~size_t(0);
+
+	// Below this amount of depth slices per thread, the light assignment isn't split any further
+	static const size_t minSlicesPerThread = 1;
+
+
+	// The view space bounds of each cluster
+	std::vector<aabb> clusters;
+
+	// The offset of the lights of each cluster into lightIndices, with one more at the end for the total
+	std::vector<unsigned int> lightOffsets;
+	std::vector<unsigned int> lightIndices;
+
+
+public:
+
+	ClusterGridT() : tilesX(0), tilesY(0), slices(0), zNear(T(0)), zFar(T(0)), tanX(T(0)), tanY(T(0)), sliceScale(T(0)) {}
+	~ClusterGridT() {}
+
+
+	// The parameters are those of mat4_t::perspective(), so fov is vertical and in degrees
+	void build(const T fov, const T aspect, const T zNear, const T zFar, const int tilesX, const int tilesY, const int slices);
+
+	// Assigns the lights given as view space spheres to the clusters they intersect. A light must
+	// intersect both the bounds of a cluster and its tile, as projected from the light's bounds within
+	// the slice, which rejects lights that only touch the corners of the bounds outside of the tile.
+	// The depth slices are split across threads, a threadCount of 0 means one per hardware thread.
+	void assignLights(const sphere *lights, const size_t count, const unsigned int threadCount = 0);
+
+	// Same as above, but with the lights in world space, where view must be a rigid transformation
+	void assignLights(const sphere *lights, const size_t count, const mat4 &view, const unsigned int threadCount = 0)
+	{
+		this->viewLights.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+			this->viewLights[i] = sphere(vec3(view * vec4(lights[i].center, T(1))), lights[i].radius);
+
+		assignLights(this->viewLights.data(), count, threadCount);
+	}
+
+
+	inline int getTilesX() const { return this->tilesX; }
+	inline int getTilesY() const { return this->tilesY; }
+	inline int getSlices() const { return this->slices; }
+
+	inline size_t getClusterCount() const { return this->clusters.size(); }
+
+	inline size_t getIndex(const int x, const int y, const int z) const { return (static_cast<size_t>(z) * this->tilesY + y) * this->tilesX + x; }
+
+	// The view space distance from the eye where depth slice z begins, where slice slices is the far plane
+	inline T getSliceDepth(const int z) const { return this->zNear * pow(this->zFar / this->zNear, T(z) / T(this->slices)); }
+
+	// The depth slice containing a view space distance from the eye, clamped to the grid
+	inline int sliceOf(const T depth) const
+	{
+		if (depth <= this->zNear)
+			return 0;
+
+		return std::min(static_cast<int>(log(depth / this->zNear) * this->sliceScale), this->slices - 1);
+	}
+
+	// The index of the cluster containing a view space position, or invalidIndex if outside of the grid
+	size_t clusterOf(const vec3 &position) const
+	{
+		const T depth = -position.z;
+
+		if ((depth < this->zNear) || (depth > this->zFar))
+			return invalidIndex;
+
+		const T ndcX = position.x / (depth * this->tanX);
+		const T ndcY = position.y / (depth * this->tanY);
+
+		if ((ndcX < T(-1)) || (ndcX > T(1)) || (ndcY < T(-1)) || (ndcY > T(1)))
+			return invalidIndex;
+
+		const int x = std::min(static_cast<int>((ndcX + T(1)) * T(0.5) * this->tilesX), this->tilesX - 1);
+		const int y = std::min(static_cast<int>((ndcY + T(1)) * T(0.5) * this->tilesY), this->tilesY - 1);
+
+		return getIndex(x, y, sliceOf(depth));
+	}
+
+	// The lights of a cluster, after assignLights()
+	inline const unsigned int* getLights(const size_t cluster, size_t &count) const
+	{
+		count = this->lightOffsets[cluster + 1] - this->lightOffsets[cluster];
+		return this->lightIndices.data() + this->lightOffsets[cluster];
+	}
+
+
+private:
+
+	int tilesX, tilesY, slices;
+
+	T zNear, zFar;
+
+	// The tangents of the half field of view, and the slices per logarithm of depth
+	T tanX, tanY, sliceScale;
+
+	// Reused between assignments, the lights overlapping each depth slice and the
+	// (cluster, light) pairs found per depth slice
+	std::vector<unsigned int> sliceLightOffsets, sliceLights;
+	std::vector<std::vector<std::pair<unsigned int, unsigned int> > > slicePairs;
+
+	std::vector<sphere> viewLights;
+
+
+	// The range of tiles along an axis overlapped by [low, high] between the view space distances near and far
+	static inline bool tileRange(const T low, const T high, const T nearDepth, const T farDepth, const T tan, const int tiles, int &first, int &last)
+	{
+		const T ndcLow = std::min(low / nearDepth, low / farDepth) / tan;
+		const T ndcHigh = std::max(high / nearDepth, high / farDepth) / tan;
+
+		if ((ndcHigh < T(-1)) || (ndcLow > T(1)))
+			return false;
+
+		first = std::max(static_cast<int>(floor((ndcLow + T(1)) * T(0.5) * tiles)), 0);
+		last = std::min(static_cast<int>(floor((ndcHigh + T(1)) * T(0.5) * tiles)), tiles - 1);
+
+		return true;
+	}
+
+	void assignSlice(const sphere *lights, const int z);
+};
+
+
+template<typename T>
+void ClusterGridT<T>::build(const T fov, const T aspect, const T zNear, const T zFar, const int tilesX, const int tilesY, const int slices)
+{
+	this->tilesX = tilesX;
+	this->tilesY = tilesY;
+	this->slices = slices;
+
+	this->zNear = zNear;
+	this->zFar = zFar;
+
+	this->tanY = tan(fov * T(LINALG_DEG2RAD) * T(0.5));
+	this->tanX = this->tanY * aspect;
+
+	this->sliceScale = T(slices) / log(zFar / zNear);
+
+	this->clusters.resize(static_cast<size_t>(tilesX) * tilesY * slices);
+	this->lightOffsets.assign(this->clusters.size() + 1, 0);
+	this->lightIndices.clear();
+
+	// A tile spans [ndc0, ndc1] * tan * depth at each depth, so its bounds are found at the near and far depth of the slice
+	std::vector<T> ndcX(tilesX + 1), ndcY(tilesY + 1);
+
+	for (int x = 0; x <= tilesX; x++)
+		ndcX[x] = (T(x) / T(tilesX) * T(2) - T(1)) * this->tanX;
+
+	for (int y = 0; y <= tilesY; y++)
+		ndcY[y] = (T(y) / T(tilesY) * T(2) - T(1)) * this->tanY;
+
+	T nearDepth = zNear;
+
+	for (int z = 0; z < slices; z++)
+	{
+		const T farDepth = (z == (slices - 1)) ? zFar : getSliceDepth(z + 1);
+
+		for (int y = 0; y < tilesY; y++)
+		{
+			const T minY = std::min(ndcY[y] * nearDepth, ndcY[y] * farDepth);
+			const T maxY = std::max(ndcY[y + 1] * nearDepth, ndcY[y + 1] * farDepth);
+
+			for (int x = 0; x < tilesX; x++)
+			{
+				const T minX = std::min(ndcX[x] * nearDepth, ndcX[x] * farDepth);
+				const T maxX = std::max(ndcX[x + 1] * nearDepth, ndcX[x + 1] * farDepth);
+
+				this->clusters[getIndex(x, y, z)] = aabb(vec3(minX, minY, -farDepth), vec3(maxX, maxY, -nearDepth));
+			}
+		}
+
+		nearDepth = farDepth;
+	}
+}
+
+
+template<typename T>
+void ClusterGridT<T>::assignLights(const sphere *lights, const size_t count, const unsigned int threadCount)
+{
+	const size_t clusterCount = this->clusters.size();
+
+	this->lightOffsets.assign(clusterCount + 1, 0);
+	this->lightIndices.clear();
+
+	if (clusterCount == 0)
+		return;
+
+	// Bucket the lights by the depth slices they overlap, such that each slice only visits its own lights
+	this->sliceLightOffsets.assign(this->slices + 1, 0);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const T depth = -lights[i].center.z;
+
+		if (((depth + lights[i].radius) < this->zNear) || ((depth - lights[i].radius) > this->zFar))
+			continue;
+
+		const int first = sliceOf(depth - lights[i].radius), last = sliceOf(depth + lights[i].radius);
+
+		for (int z = first; z <= last; z++)
+			this->sliceLightOffsets[z + 1]++;
+	}
+
+	for (int z = 0; z < this->slices; z++)
+		this->sliceLightOffsets[z + 1] += this->sliceLightOffsets[z];
+
+	this->sliceLights.resize(this->sliceLightOffsets[this->slices]);
+
+	std::vector<unsigned int> cursors(this->sliceLightOffsets.begin(), this->sliceLightOffsets.end() - 1);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const T depth = -lights[i].center.z;
+
+		if (((depth + lights[i].radius) < this->zNear) || ((depth - lights[i].radius) > this->zFar))
+			continue;
+
+		const int first = sliceOf(depth - lights[i].radius), last = sliceOf(depth + lights[i].radius);
+
+		for (int z = first; z <= last; z++)
+			this->sliceLights[cursors[z]++] = static_cast<unsigned int>(i);
+	}
+
+	this->slicePairs.resize(this->slices);
+
+	// Each slice counts the lights of its own clusters, so the threads never write to the same counts
+	const size_t chunkCount = _linalg_chunk_count(this->slices, minSlicesPerThread, threadCount);
+
+	_linalg_parallel_chunks(this->slices, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t z = begin; z < end; z++)
+			this->assignSlice(lights, static_cast<int>(z));
+	});
+
+	for (size_t i = 0; i < clusterCount; i++)
+		this->lightOffsets[i + 1] += this->lightOffsets[i];
+
+	this->lightIndices.resize(this->lightOffsets[clusterCount]);
+
+	// Scatter the pairs, which are in light order per slice, keeping the lights of each cluster sorted
+	_linalg_parallel_chunks(this->slices, chunkCount, [&](const size_t, const size_t begin, const size_t end)
+	{
+		for (size_t z = begin; z < end; z++)
+		{
+			const std::vector<std::pair<unsigned int, unsigned int> > &pairs = this->slicePairs[z];
+
+			const size_t firstCluster = z * this->tilesX * this->tilesY;
+			const size_t lastCluster = firstCluster + this->tilesX * this->tilesY;
+
+			std::vector<unsigned int> cursors(this->lightOffsets.begin() + firstCluster, this->lightOffsets.begin() + lastCluster);
+
+			for (size_t i = 0; i < pairs.size(); i++)
+				this->lightIndices[cursors[pairs[i].first - firstCluster]++] = pairs[i].second;
+		}
+	});
+}
+
+
+template<typename T>
+void ClusterGridT<T>::assignSlice(const sphere *lights, const int z)
+{
+	std::vector<std::pair<unsigned int, unsigned int> > &pairs = this->slicePairs[z];
+	pairs.clear();
+
+	const T sliceNear = -this->clusters[getIndex(0, 0, z)].max.z;
+	const T sliceFar = -this->clusters[getIndex(0, 0, z)].min.z;
+
+	for (unsigned int i = this->sliceLightOffsets[z]; i < this->sliceLightOffsets[z + 1]; i++)
+	{
+		const unsigned int lightIndex = this->sliceLights[i];
+		const sphere &light = lights[lightIndex];
+
+		// The part of the light's bounds within the slice, which bounds the tiles it can overlap
+		const T depth = -light.center.z;
+
+		const T nearDepth = std::max(depth - light.radius, sliceNear);
+		const T farDepth = std::min(depth + light.radius, sliceFar);
+
+		if (nearDepth > farDepth)
+			continue;
+
+		int firstX, lastX, firstY, lastY;
+
+		if (!tileRange(light.center.x - light.radius, light.center.x + light.radius, nearDepth, farDepth, this->tanX, this->tilesX, firstX, lastX))
+			continue;
+
+		if (!tileRange(light.center.y - light.radius, light.center.y + light.radius, nearDepth, farDepth, this->tanY, this->tilesY, firstY, lastY))
+			continue;
+
+		for (int y = firstY; y <= lastY; y++)
+		{
+			for (int x = firstX; x <= lastX; x++)
+			{
+				const size_t cluster = getIndex(x, y, z);
+
+				if (light.intersects(this->clusters[cluster]))
+				{
+					pairs.push_back(std::make_pair(static_cast<unsigned int>(cluster), lightIndex));
+					this->lightOffsets[cluster + 1]++;
+				}
+			}
+		}
+	}
+}
+
+
+
+// Cascaded shadow maps for a directional light. The view frustum is split at distances
+// blending logarithmic and uniform splits, each split is bounded by the smallest sphere
+// enclosing it, and each sphere is fitted by an orthographic projection along the light.
+//
+// The spheres are computed from the perspective parameters directly, so no frustum corners
+// are unprojected, and their radius doesn't change as the camera rotates. Together with
+// snapping their centers to shadow map texels, this keeps the cascades from shimmering.
+template<typename T>
+class ShadowCascadesT
+{
+private:
+
+	typedef vec3_t<T> vec3;
+	typedef vec4_t<T> vec4;
+	typedef mat4_t<T> mat4;
+	typedef sphere_t<T> sphere;
+	typedef frustum_t<T> frustum;
+	typedef camera_t<T> camera;
+
+
+public:
+
+	struct Cascade
+	{
+		// The view space distances from the eye the cascade covers
+		T splitNear, splitFar;
+
+		// The world space sphere enclosing the cascade's part of the view frustum
+		sphere bounds;
+
+		mat4 view, projection, viewProjection;
+
+		// The world space planes of the light's volume, e.g. for culling shadow casters
+		frustum planes;
+	};
+
+
+	std::vector<Cascade> cascades;
+
+
+public:
+
+	ShadowCascadesT() {}
+	~ShadowCascadesT() {}
+
+
+	// Fits cascadeCount cascades of resolution texels square over the view frustum up to maxDistance,
+	// or the far plane if maxDistance is 0. A lambda of 1 gives logarithmic splits, 0 uniform splits.
+	// The light's volume is extended by casterDistance towards the light, for casters outside the view.
+	void build(
+		const camera &cam, const vec3 &lightDirection, const int cascadeCount, const int resolution,
+		const T lambda = T(0.75), const T maxDistance = T(0), const T casterDistance = T(0))
+	{
+		const T zFar = (maxDistance > T(0)) ? maxDistance : cam.getFar();
+
+		build(cam.getInverseView(), cam.getFov(), cam.getAspect(), cam.getNear(), zFar, lightDirection, cascadeCount, resolution, lambda, casterDistance);
+	}
+
+	// Same as above, with the inverse view matrix and the parameters of mat4_t::perspective()
+	void build(
+		const mat4 &inverseView, const T fov, const T aspect, const T zNear, const T zFar,
+		const vec3 &lightDirection, const int cascadeCount, const int resolution,
+		const T lambda = T(0.75), const T casterDistance = T(0));
+
+
+	inline int getCascadeCount() const { return static_cast<int>(this->cascades.size()); }
+
+	// The cascade covering a view space distance from the eye, or -1 if beyond the last one
+	int cascadeOf(const T depth) const
+	{
+		for (size_t i = 0; i < this->cascades.size(); i++)
+			if (depth <= this->cascades[i].splitFar)
+				return static_cast<int>(i);
+
+		return -1;
+	}
+
+
+	// The distance along the view direction of the center of the smallest sphere enclosing the part of
+	// a symmetric view frustum between zNear and zFar, where tanSquared is the squared tangent of the
+	// half diagonal field of view. The sphere passes through the corners of both ends, unless the far
+	// end alone is wider, in which case its center is on the far end.
+	static inline void boundingSphere(const T zNear, const T zFar, const T tanSquared, T &center, T &radius)
+	{
+		center = std::min((zNear + zFar) * T(0.5) * (T(1) + tanSquared), zFar);
+		radius = sqrt((zFar - center) * (zFar - center) + zFar * zFar * tanSquared);
+	}
+};
+
+
+template<typename T>
+void ShadowCascadesT<T>::build(
+	const mat4 &inverseView, const T fov, const T aspect, const T zNear, const T zFar,
+	const vec3 &lightDirection, const int cascadeCount, const int resolution,
+	const T lambda, const T casterDistance)
+{
+	this->cascades.resize(cascadeCount);
+
+	const T tanY = tan(fov * T(LINALG_DEG2RAD) * T(0.5));
+	const T tanX = tanY * aspect;
+	const T tanSquared = tanX * tanX + tanY * tanY;
+
+	// The eye and view direction, from the inverse view as the view looks along -z
+	const vec3 eye(inverseView[3].x, inverseView[3].y, inverseView[3].z);
+	const vec3 forward(-inverseView[2].x, -inverseView[2].y, -inverseView[2].z);
+
+	// The light's rotation is fixed, such that texels stay put as the camera moves
+	const vec3 direction = lightDirection.normalize();
+	const vec3 up = (fabs(direction.y) < T(0.99)) ? vec3::up : vec3(T(0), T(0), T(1));
+
+	const mat4 lightView = mat4::lookAt(vec3(T(0)), direction, up);
+
+	T splitNear = zNear;
+
+	for (int i = 0; i < cascadeCount; i++)
+	{
+		Cascade &cascade = this->cascades[i];
+
+		// The practical split scheme, blending the logarithmic and uniform split
+		const T t = T(i + 1) / T(cascadeCount);
+		const T splitFar = (i == (cascadeCount - 1)) ? zFar : (lambda * zNear * pow(zFar / zNear, t) + (T(1) - lambda) * (zNear + (zFar - zNear) * t));
+
+		cascade.splitNear = splitNear;
+		cascade.splitFar = splitFar;
+
+		T centerDistance, radius;
+		boundingSphere(splitNear, splitFar, tanSquared, centerDistance, radius);
+
+		cascade.bounds = sphere(eye + forward * centerDistance, radius);
+
+		// Snap the center to whole texels in light space, the light looks along -z. Snapping moves
+		// the center down by up to a texel, so the map spans the sphere's diameter plus one texel.
+		const T texelSize = (radius * T(2)) / T(resolution - 1);
+
+		vec4 center = lightView * vec4(cascade.bounds.center, T(1));
+		center.x = floor(center.x / texelSize) * texelSize;
+		center.y = floor(center.y / texelSize) * texelSize;
+
+		cascade.view = lightView;
+		cascade.projection = mat4::orthographic(
+			center.x - radius, center.x + radius + texelSize,
+			center.y - radius, center.y + radius + texelSize,
+			-center.z - radius - casterDistance, -center.z + radius);
+
+		cascade.viewProjection = cascade.projection * cascade.view;
+		cascade.planes = frustum(cascade.viewProjection);
+
+		splitNear = splitFar;
+	}
+}
+
+
+
+// The scalar type and the columns of rows the types are made of
+template<typename Type> struct _linalg_buffer_shape;
+
+template<typename T> struct _linalg_buffer_shape<vec2_t<T>> { typedef T scalar; static const size_t rows = 2, columns = 1; };
+template<typename T> struct _linalg_buffer_shape<vec3_t<T>> { typedef T scalar; static const size_t rows = 3, columns = 1; };
+template<typename T> struct _linalg_buffer_shape<vec4_t<T>> { typedef T scalar; static const size_t rows = 4, columns = 1; };
+template<typename T> struct _linalg_buffer_shape<quat_t<T>> { typedef T scalar; static const size_t rows = 4, columns = 1; };
+template<typename T> struct _linalg_buffer_shape<mat2_t<T>> { typedef T scalar; static const size_t rows = 2, columns = 2; };
+template<typename T> struct _linalg_buffer_shape<mat3_t<T>> { typedef T scalar; static const size_t rows = 3, columns = 3; };
+template<typename T> struct _linalg_buffer_shape<mat4_t<T>> { typedef T scalar; static const size_t rows = 4, columns = 4; };
+
+
+// How a vector, quaternion (as a vec4) or matrix is laid out in a GLSL block, known at compile time,
+// e.g. BufferElement<Std140, fmat3>::arrayStride is 48. All sizes are in bytes.
+template<BufferLayout Layout, typename Type>
+struct BufferElement
+{
+	typedef typename _linalg_buffer_shape<Type>::scalar scalar;
+
+	static const size_t rows = _linalg_buffer_shape<Type>::rows;
+	static const size_t columns = _linalg_buffer_shape<Type>::columns;
+
+	// A vec3 is aligned like a vec4
+	static const size_t vectorAlignment = ((rows == 3) ? 4 : rows) * sizeof(scalar);
+
+	// Matrices are laid out as arrays of their columns, which std140 rounds up to the alignment of a vec4
+	static const size_t columnStride = ((Layout == Std140) && (columns > 1)) ? (((vectorAlignment + 15) / 16) * 16) : vectorAlignment;
+
+	static const size_t alignment = (columns > 1) ? columnStride : vectorAlignment;
+
+	// The size as GLSL defines it, where e.g. a float directly following a vec3 in std430 takes up its padding
+	static const size_t size = (columns > 1) ? (columns * columnStride) : (rows * sizeof(scalar));
+
+	// The bytes BufferPacker writes per element, i.e. including the padding of each column
+	static const size_t paddedSize = columns * columnStride;
+
+	// The stride of an array of the type, which std140 rounds up to the alignment of a vec4
+	static const size_t arrayStride = (Layout == Std140) ? (((paddedSize + 15) / 16) * 16) : paddedSize;
+};
+
+
+// Writes spans of vectors, quaternions and matrices into uniform or storage buffers, adding the padding
+// the layout requires. Each element writes BufferElement::paddedSize bytes with the padding zeroed, so when
+// other members share that padding, e.g. a float following a vec3 in std430, then pack them afterwards.
+class BufferPacker
+{
+public:
+
+	// Writes count elements to destination, with stride bytes between them. The default stride is that of an
+	// array of the type, a larger one interleaves them with other members, e.g. the per instance matrices
+	// of a struct in an array. Returns the amount of bytes from destination to the end of the last element.
+	//
+	// If destination and stride are multiples of 16, then floats are written using non-temporal stores,
+	// as the destination is typically mapped GPU memory which isn't read back.
+	template<BufferLayout Layout, typename Type>
+	static size_t pack(const Type *source, const size_t count, void *destination, const size_t stride = BufferElement<Layout, Type>::arrayStride)
+	{
+		typedef BufferElement<Layout, Type> Element;
+
+		if (count == 0)
+			return 0;
+
+		packColumns(
+			reinterpret_cast<const typename Element::scalar*>(source), Element::rows, Element::columns, Element::columnStride,
+			count, static_cast<unsigned char*>(destination), stride);
+
+		return (count - 1) * stride + Element::paddedSize;
+	}
+
+	// Packs a single element at offset bytes into destination, e.g. a member of a uniform block
+	template<BufferLayout Layout, typename Type>
+	static inline size_t pack(const Type &source, void *destination, const size_t offset = 0)
+	{
+		return pack<Layout>(&source, 1, static_cast<unsigned char*>(destination) + offset);
+	}
+
+
+private:
+
+	template<typename T>
+	static void packColumns(const T *source, const size_t rows, const size_t columns, const size_t columnStride, const size_t count, unsigned char *destination, const size_t stride);
+
+	static void packColumns(const float *source, const size_t rows, const size_t columns, const size_t columnStride, const size_t count, unsigned char *destination, const size_t stride);
+};
+
+
+template<typename T>
+void BufferPacker::packColumns(const T *source, const size_t rows, const size_t columns, const size_t columnStride, const size_t count, unsigned char *destination, const size_t stride)
+{
+	const size_t columnSize = rows * sizeof(T);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned char *element = destination + i * stride;
+
+		for (size_t c = 0; c < columns; c++, source += rows)
+		{
+			memcpy(element + c * columnStride, source, columnSize);
+			memset(element + c * columnStride + columnSize, 0, columnStride - columnSize);
+		}
+	}
+}
+
+inline void BufferPacker::packColumns(const float *source, const size_t rows, const size_t columns, const size_t columnStride, const size_t count, unsigned char *destination, const size_t stride)
+{
+	// Only columns padded to a vec4 map to whole 4 float stores
+	if (columnStride != 16)
+	{
+		packColumns<float>(source, rows, columns, columnStride, count, destination, stride);
+		return;
+	}
+
+	// Lanes past the rows of a column read into the next column and are zeroed, which
+	// would read past the end of source for the last element unless it has 4 rows
+	const size_t simdCount = (rows == 4) ? count : (count - 1);
+
+	const _linalg_float4 mask = _linalg_cmplt(_linalg_float4(0.0f, 1.0f, 2.0f, 3.0f), _linalg_float4(static_cast<float>(rows)));
+
+	if (((reinterpret_cast<size_t>(destination) | stride) & 15) == 0)
+	{
+		for (size_t i = 0; i < simdCount; i++)
+		{
+			float *element = reinterpret_cast<float*>(destination + i * stride);
+
+			for (size_t c = 0; c < columns; c++, source += rows)
+				_linalg_and(_linalg_float4::load(source), mask).stream(element + c * 4);
+		}
+
+		_linalg_stream_fence();
+	}
+	else
+	{
+		for (size_t i = 0; i < simdCount; i++)
+		{
+			float *element = reinterpret_cast<float*>(destination + i * stride);
+
+			for (size_t c = 0; c < columns; c++, source += rows)
+				_linalg_and(_linalg_float4::load(source), mask).store(element + c * 4);
+		}
+	}
+
+	packColumns<float>(source, rows, columns, columnStride, count - simdCount, destination + simdCount * stride, stride);
+}
+
+
+
 #endif
\ No newline at end of file
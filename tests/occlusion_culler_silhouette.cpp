@@ -0,0 +1,70 @@
+
+// Regression test for OcclusionCuller with boxes beside the silhouette of an occluder,
+// sharing pixels with it. Pixels used to be covered when only their center was inside
+// a triangle, which culled such boxes although they are entirely visible.
+//
+// g++ -std=c++11 -O2 -I.. occlusion_culler_silhouette.cpp
+
+#include <cstdio>
+
+#include "../linalgaux.hpp"
+
+
+static int failures = 0;
+
+static void check(const OcclusionCuller &culler, const char *name, const faabb &box, const bool expected)
+{
+	const bool visible = culler.isVisible(box);
+
+	// testAABBs() goes through the SIMD path for 4 boxes at a time
+	const float minX[4] = { box.min.x, box.min.x, box.min.x, box.min.x }, maxX[4] = { box.max.x, box.max.x, box.max.x, box.max.x };
+	const float minY[4] = { box.min.y, box.min.y, box.min.y, box.min.y }, maxY[4] = { box.max.y, box.max.y, box.max.y, box.max.y };
+	const float minZ[4] = { box.min.z, box.min.z, box.min.z, box.min.z }, maxZ[4] = { box.max.z, box.max.z, box.max.z, box.max.z };
+
+	unsigned char visibility = 0;
+	culler.testAABBs(minX, minY, minZ, maxX, maxY, maxZ, 4, &visibility);
+
+	const bool batchVisible = (visibility == 0x0F);
+
+	printf("%s: %s%s\n", name, visible ? "visible" : "culled", (visible == expected) && (batchVisible == expected) ? "" : ", wrong");
+
+	if ((visible != expected) || (batchVisible != expected))
+		failures++;
+}
+
+
+int main()
+{
+	// With an identity view-projection, world space is normalized device space
+	OcclusionCuller culler(256, 128);
+	culler.begin(fmat4());
+
+	// A quad at depth 0 covering the left half of the screen, ending at x = 0.005, which is
+	// pixel 128.64, such that the center of pixel 128 is inside it
+	const fvec3 quad[4] = { fvec3(-1.0f, -1.0f, 0.0f), fvec3(0.005f, -1.0f, 0.0f), fvec3(0.005f, 1.0f, 0.0f), fvec3(-1.0f, 1.0f, 0.0f) };
+	const unsigned int indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	culler.rasterize(quad, indices, 2);
+	culler.end();
+
+	check(culler, "beside the silhouette", faabb(fvec3(0.006f, 0.001f, 0.5f), fvec3(0.007f, 0.005f, 0.6f)), true);
+	check(culler, "straddling the silhouette", faabb(fvec3(0.004f, 0.001f, 0.5f), fvec3(0.007f, 0.005f, 0.6f)), true);
+	check(culler, "in front of the occluder", faabb(fvec3(-0.5f, -0.5f, -0.6f), fvec3(-0.4f, 0.5f, -0.5f)), true);
+	// Across the diagonal edge the two triangles share
+	check(culler, "behind the occluder", faabb(fvec3(-0.5f, -0.5f, 0.5f), fvec3(-0.4f, 0.5f, 0.6f)), false);
+
+	// A sloped quad, where the depth at the pixel center is nearer than over the rest of the pixel
+	culler.begin(fmat4());
+
+	const fvec3 slope[4] = { fvec3(-1.0f, -1.0f, -0.5f), fvec3(1.0f, -1.0f, 0.5f), fvec3(1.0f, 1.0f, 0.5f), fvec3(-1.0f, 1.0f, -0.5f) };
+
+	culler.rasterize(slope, indices, 2);
+	culler.end();
+
+	// Pixel 192 spans x 0.5 to 0.5078, where the quad's depth goes from 0.25 to 0.2539. The box is
+	// behind the quad at the center of the pixel, but in front of it where the box is.
+	check(culler, "behind a pixel center of a sloped occluder", faabb(fvec3(0.507f, 0.001f, 0.2525f), fvec3(0.5071f, 0.005f, 0.26f)), true);
+	check(culler, "behind a sloped occluder", faabb(fvec3(-0.5f, -0.5f, 0.3f), fvec3(-0.4f, 0.5f, 0.4f)), false);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+
+// Regression test for SpatialHashGrid::queryNearest with points far outside the
+// bounds of the grid, which used to visit every ring of cells out to the bounds,
+// and beyond the range of int in cells. The time of each query is only printed,
+// as it depends on the machine. The far queries took seconds before the rings
+// were clipped to the bounds, and about a millisecond after.
+//
+// g++ -std=c++11 -O2 -pthread -I.. spatial_hash_grid_far_query.cpp
+
+#include <chrono>
+#include <random>
+#include <cstdio>
+
+#include "../linalgaux.hpp"
+
+
+static size_t bruteForceNearest(const std::vector<vec3> &points, const vec3 &point, const size_t k, unsigned int *indices, float *distancesSquared)
+{
+	std::vector<std::pair<float, unsigned int>> all(points.size());
+
+	for (size_t i = 0; i < points.size(); i++)
+		all[i] = std::make_pair((points[i] - point).lengthSquared(), static_cast<unsigned int>(i));
+
+	const size_t n = std::min(k, all.size());
+
+	std::partial_sort(all.begin(), all.begin() + n, all.end());
+
+	for (size_t i = 0; i < n; i++)
+	{
+		distancesSquared[i] = all[i].first;
+		indices[i] = all[i].second;
+	}
+
+	return n;
+}
+
+
+int main()
+{
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> xy(0.0f, 100.0f), z(0.0f, 10.0f);
+
+	std::vector<vec3> points(20000);
+
+	for (vec3 &p : points)
+		p = vec3(xy(random), xy(random), z(random));
+
+	SpatialHashGrid grid(1.0f);
+	grid.build(points.data(), points.size());
+
+	const vec3 queries[] = {
+		vec3(50.0f, 50.0f, 5.0f),
+		vec3(150.0f, 150.0f, 150.0f),
+		vec3(300.0f, 300.0f, 300.0f),
+		vec3(1000.0f, 1000.0f, 1000.0f),
+		vec3(-1000.0f, 50.0f, 5.0f),
+		vec3(1E12f, 50.0f, 5.0f),
+		vec3(-1E12f, -1E12f, 1E12f),
+	};
+
+	const size_t k = 8;
+
+	int failures = 0;
+
+	for (const vec3 &query : queries)
+	{
+		unsigned int indices[k], expectedIndices[k];
+		float distancesSquared[k], expectedDistancesSquared[k];
+
+		const auto start = std::chrono::steady_clock::now();
+		const size_t found = grid.queryNearest(query, k, indices, distancesSquared);
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const size_t expected = bruteForceNearest(points, query, k, expectedIndices, expectedDistancesSquared);
+
+		bool matches = (found == expected);
+
+		for (size_t i = 0; matches && (i < found); i++)
+			matches = (distancesSquared[i] == expectedDistancesSquared[i]);
+
+		printf("(%g, %g, %g): %.3f ms%s\n", query.x, query.y, query.z, milliseconds, matches ? "" : ", wrong neighbours");
+
+		if (!matches)
+			failures++;
+	}
+
+	return (failures == 0) ? 0 : 1;
+}